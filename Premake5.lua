@@ -353,9 +353,12 @@ function AddProjects(groupName, folders)
 	            "%{prj.location}\\src\\**.hpp"
 			}
 
-			-- Disable CRT secure warnings
+			-- Disable CRT secure warnings, match the threading support that bullet was built with, and
+			-- let GUIDs be written to cereal archives (used for binary scenes)
 			defines {
-				"_CRT_SECURE_NO_WARNINGS"
+				"_CRT_SECURE_NO_WARNINGS",
+				"BT_THREADSAFE=1",
+				"GUID_CEREAL_ARCHIVES"
 			}
 
 			-- We update the reserved include directory to be the project's source directory
@@ -7,9 +7,11 @@
 #include "Logging.h"
 #include "Gameplay/InputEngine.h"
 #include "Application/Timing.h"
+#include "Application/JobSystem.h"
 #include <filesystem>
 #include "Layers/GLAppLayer.h"
 #include "Utils/FileHelpers.h"
+#include "Utils/VirtualFileSystem.h"
 #include "Utils/ResourceManager/ResourceManager.h"
 #include "Utils/ImGuiHelper.h"
 
@@ -30,6 +32,7 @@
 
 // Gameplay
 #include "Gameplay/Material.h"
+#include "Gameplay/Prefab.h"
 #include "Gameplay/GameObject.h"
 #include "Gameplay/Scene.h"
 
@@ -60,6 +63,13 @@
 #include "Layers/LogicUpdateLayer.h"
 #include "Layers/ImGuiDebugLayer.h"
 #include "Layers/InstancedRenderingTestLayer.h"
+#include "Layers/UpdateStressTestLayer.h"
+#include "Layers/PhysicsStressTestLayer.h"
+#include "Layers/SceneLoadBenchmarkLayer.h"
+#include "Layers/ResourceLookupBenchmarkLayer.h"
+#include "Layers/ComponentBenchmarkLayer.h"
+#include "Layers/TransformBenchmarkLayer.h"
+#include "Layers/JobSystemBenchmarkLayer.h"
 #include "Layers/ParticleLayer.h"
 #include "Layers/PostProcessingLayer.h"
 
@@ -115,10 +125,10 @@ void Application::Quit() {
 }
 
 bool Application::LoadScene(const std::string& path) {
-	if (std::filesystem::exists(path)) { 
+	if (VirtualFileSystem::Exists(path)) { 
 
 		std::string manifestPath = std::filesystem::path(path).stem().string() + "-manifest.json";
-		if (std::filesystem::exists(manifestPath)) {
+		if (VirtualFileSystem::Exists(manifestPath)) {
 			LOG_INFO("Loading manifest from \"{}\"", manifestPath);
 			ResourceManager::LoadManifest(manifestPath);
 		}
@@ -176,6 +186,20 @@ void Application::_Run()
 	// Register all component and resource types
 	_RegisterClasses();
 
+	// Spin up our worker threads before any layers get a chance to use them, 0 will pick based on the hardware
+	JobSystem::Init(JsonGet(_appSettings, "worker_threads", 0u));
+	// Scenes will pick this up when they create their physics worlds
+	Gameplay::Scene::UseMultithreadedPhysics = JsonGet(_appSettings, "multithreaded_physics", false);
+	// How long we can spend each frame creating resources that have been loaded in the background
+	double resourceBudgetMs = JsonGet(_appSettings, "resource_finalize_budget_ms", 2.0);
+	ResourceManager::SetMemoryBudget(static_cast<size_t>(JsonGet(_appSettings, "resource_memory_budget_mb", 1024u)) * 1024 * 1024);
+	ResourceManager::SetBlobCompression(JsonGet(_appSettings, "compress_resource_blobs", false));
+
+	// If the assets have been packed, serve them from the archive instead of the loose files
+	std::string archivePath = JsonGet<std::string>(_appSettings, "asset_archive", "assets.pak");
+	if (!archivePath.empty() && std::filesystem::exists(archivePath)) {
+		VirtualFileSystem::Mount(archivePath);
+	}
 
 	// Load all layers
 	_Load();
@@ -196,6 +220,12 @@ void Application::_Run()
 		// Receive events like input and window position/size changes from GLFW
 		glfwPollEvents();
 
+		// Run any jobs that other threads have handed back to the main thread
+		JobSystem::Get().ProcessMainThreadJobs();
+		// Create the OpenGL objects for any resources that finished decoding in the background
+		ResourceManager::ProcessPendingLoads(resourceBudgetMs);
+		ResourceManager::UpdateResidency();
+
 		// Handle closing the app via the close button
 		if (glfwWindowShouldClose(_window)) {
 			_isRunning = false;
@@ -240,6 +270,11 @@ void Application::_Run()
 
 	// Unload all our layers
 	_Unload();
+
+	// Stop our worker threads
+	JobSystem::Shutdown();
+
+	VirtualFileSystem::Unmount();
 }
 
 void Application::_RegisterClasses()
@@ -261,6 +296,7 @@ void Application::_RegisterClasses()
 	ResourceManager::RegisterType<MeshResource>();
 	ResourceManager::RegisterType<Font>();
 	ResourceManager::RegisterType<Framebuffer>();
+	ResourceManager::RegisterType<Prefab>();
 
 	// Register all of our component types so we can load them from files
 	ComponentManager::RegisterType<Camera>();
@@ -444,6 +480,12 @@ nlohmann::json Application::_GetDefaultAppSettings()
 
 	result["window_width"]  = DEFAULT_WINDOW_WIDTH;
 	result["window_height"] = DEFAULT_WINDOW_HEIGHT;
+	result["worker_threads"] = 0;
+	result["multithreaded_physics"] = false;
+	result["resource_finalize_budget_ms"] = 2.0;
+	result["resource_memory_budget_mb"] = 1024;
+	result["asset_archive"] = "assets.pak";
+	result["compress_resource_blobs"] = false;
 	return result;
 }
 
@@ -0,0 +1,270 @@
+#include "Application/JobSystem.h"
+
+#include <algorithm>
+#include "Logging.h"
+
+JobSystem* JobSystem::_singleton = nullptr;
+
+// The index of the job system thread that we are running on, or NoThreadIndex for
+// threads that were not created by the job system
+static constexpr uint32_t NoThreadIndex = ~0u;
+static thread_local uint32_t CurrentThreadIndex = NoThreadIndex;
+
+JobSystem::JobSystem(uint32_t workerCount) :
+	_workers(std::vector<std::thread>()),
+	_queues(std::vector<std::unique_ptr<WorkQueue>>()),
+	_mainThreadId(std::this_thread::get_id()),
+	_isRunning(true),
+	_pendingJobs(0),
+	_nextQueue(0),
+	_mainThreadJobs(std::vector<Job>())
+{
+	// The main thread gets the first queue
+	CurrentThreadIndex = 0;
+	for (uint32_t ix = 0; ix <= workerCount; ix++) {
+		_queues.push_back(std::make_unique<WorkQueue>());
+	}
+
+	// Queues must all exist before any of the workers start stealing
+	_workers.reserve(workerCount);
+	for (uint32_t ix = 1; ix <= workerCount; ix++) {
+		_workers.emplace_back(&JobSystem::_WorkerMain, this, ix);
+	}
+}
+
+JobSystem::~JobSystem() {
+	_isRunning = false;
+	{
+		std::lock_guard<std::mutex> lock(_sleepLock);
+	}
+	_sleepCondition.notify_all();
+
+	for (auto& worker : _workers) {
+		worker.join();
+	}
+	CurrentThreadIndex = NoThreadIndex;
+}
+
+void JobSystem::Init(uint32_t workerCount) {
+	LOG_ASSERT(_singleton == nullptr, "Job system has already been initialized!");
+
+	// By default we leave one hardware thread for the main thread
+	if (workerCount == 0) {
+		uint32_t hardwareThreads = std::thread::hardware_concurrency();
+		workerCount = hardwareThreads > 1 ? hardwareThreads - 1 : 0;
+	}
+
+	_singleton = new JobSystem(workerCount);
+	LOG_INFO("Started job system with {} worker threads", workerCount);
+}
+
+void JobSystem::Shutdown() {
+	if (_singleton != nullptr) {
+		delete _singleton;
+		_singleton = nullptr;
+	}
+}
+
+JobSystem& JobSystem::Get() {
+	LOG_ASSERT(_singleton != nullptr, "Job system has not been initialized!");
+	return *_singleton;
+}
+
+void JobSystem::Run(JobFunc job, Counter* counter) {
+	if (counter != nullptr) {
+		counter->_remaining.fetch_add(1, std::memory_order_relaxed);
+	}
+	_Push({ std::move(job), counter });
+}
+
+void JobSystem::RunAfter(Counter& dependency, JobFunc job, Counter* counter) {
+	if (counter != nullptr) {
+		counter->_remaining.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	{
+		// Counters are decremented while holding the lock, so if the dependency is not done
+		// here it will see our continuation when it finishes
+		std::lock_guard<std::mutex> lock(dependency._continuationLock);
+		if (!dependency.IsDone()) {
+			dependency._continuations.emplace_back(std::move(job), counter);
+			return;
+		}
+	}
+
+	_Push({ std::move(job), counter });
+}
+
+void JobSystem::RunOnMainThread(JobFunc job, Counter* counter) {
+	if (counter != nullptr) {
+		counter->_remaining.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	std::lock_guard<std::mutex> lock(_mainThreadLock);
+	_mainThreadJobs.push_back({ std::move(job), counter });
+}
+
+void JobSystem::Wait(Counter& counter) {
+	uint32_t threadIndex = CurrentThreadIndex;
+	bool isMainThread = threadIndex == 0;
+
+	while (!counter.IsDone()) {
+		Job job;
+		// Help out with the jobs we're waiting on. We don't take other jobs, since they may be long running
+		// background work that would hold us up long after our counter is done
+		if (threadIndex != NoThreadIndex && _TryPop(threadIndex, job, &counter)) {
+			_Execute(job);
+		}
+		// The main thread needs to run it's own jobs, or we could wait forever on a main thread job
+		else if (isMainThread) {
+			ProcessMainThreadJobs();
+			std::this_thread::yield();
+		}
+		else {
+			std::this_thread::yield();
+		}
+	}
+
+	// Make sure the thread that finished the last job has let go of the counter
+	std::lock_guard<std::mutex> lock(counter._continuationLock);
+}
+
+void JobSystem::ParallelFor(size_t count, size_t batchSize, const RangeFunc& func) {
+	if (count == 0) return;
+
+	// By default, aim for a few batches per thread so that threads that finish early can steal the rest
+	if (batchSize == 0) {
+		batchSize = std::max<size_t>(1, count / (ThreadCount() * 4));
+	}
+
+	// If there's only one batch, there's no point in going through the queues
+	if (batchSize >= count) {
+		func(0, count);
+		return;
+	}
+
+	Counter counter;
+	for (size_t begin = 0; begin < count; begin += batchSize) {
+		size_t end = std::min(begin + batchSize, count);
+		Run([&func, begin, end]() { func(begin, end); }, &counter);
+	}
+	Wait(counter);
+}
+
+void JobSystem::ProcessMainThreadJobs() {
+	LOG_ASSERT(IsMainThread(), "Main thread jobs must be processed from the main thread!");
+
+	// Swap the jobs out so that jobs can queue more main thread jobs without deadlocking, those will run next time
+	std::vector<Job> jobs;
+	{
+		std::lock_guard<std::mutex> lock(_mainThreadLock);
+		jobs.swap(_mainThreadJobs);
+	}
+
+	for (Job& job : jobs) {
+		_Execute(job);
+	}
+
+	// Without any workers, nothing else will run background jobs, so we run them here
+	if (_workers.empty()) {
+		Job job;
+		while (_TryPop(0, job)) {
+			_Execute(job);
+		}
+	}
+}
+
+void JobSystem::_WorkerMain(uint32_t threadIndex) {
+	CurrentThreadIndex = threadIndex;
+
+	while (_isRunning) {
+		Job job;
+		if (_TryPop(threadIndex, job)) {
+			_Execute(job);
+		} else {
+			// Sleep until there's more work to do, or we're shutting down
+			std::unique_lock<std::mutex> lock(_sleepLock);
+			_sleepCondition.wait(lock, [this]() { return !_isRunning || _pendingJobs.load() > 0; });
+		}
+	}
+}
+
+void JobSystem::_Push(Job&& job) {
+	// Workers push to their own queue. The main thread and threads outside the job system spread their
+	// jobs across the worker queues, so the main thread's queue never fills up with background work
+	uint32_t threadIndex = CurrentThreadIndex;
+	if ((threadIndex == 0 || threadIndex == NoThreadIndex) && !_workers.empty()) {
+		threadIndex = 1 + _nextQueue.fetch_add(1, std::memory_order_relaxed) % _workers.size();
+	} else if (threadIndex == NoThreadIndex) {
+		threadIndex = 0;
+	}
+
+	{
+		WorkQueue& queue = *_queues[threadIndex];
+		std::lock_guard<std::mutex> lock(queue.Lock);
+		queue.Jobs.push_back(std::move(job));
+	}
+	_pendingJobs.fetch_add(1);
+
+	// Taking the sleep lock ensures that a worker can't miss the wakeup between checking for jobs and sleeping
+	{
+		std::lock_guard<std::mutex> lock(_sleepLock);
+	}
+	_sleepCondition.notify_one();
+}
+
+bool JobSystem::_TryPop(uint32_t threadIndex, Job& result, Counter* group) {
+	auto isMatch = [group](const Job& job) { return group == nullptr || job.Group == group; };
+
+	// Take the most recently pushed job from our own queue, since it's data is most likely to be in cache
+	{
+		WorkQueue& queue = *_queues[threadIndex];
+		std::lock_guard<std::mutex> lock(queue.Lock);
+		auto it = std::find_if(queue.Jobs.rbegin(), queue.Jobs.rend(), isMatch);
+		if (it != queue.Jobs.rend()) {
+			result = std::move(*it);
+			queue.Jobs.erase(std::next(it).base());
+			_pendingJobs.fetch_sub(1);
+			return true;
+		}
+	}
+
+	// Otherwise, steal the oldest job from another thread
+	size_t queueCount = _queues.size();
+	for (size_t offset = 1; offset < queueCount; offset++) {
+		WorkQueue& queue = *_queues[(threadIndex + offset) % queueCount];
+		std::lock_guard<std::mutex> lock(queue.Lock);
+		auto it = std::find_if(queue.Jobs.begin(), queue.Jobs.end(), isMatch);
+		if (it != queue.Jobs.end()) {
+			result = std::move(*it);
+			queue.Jobs.erase(it);
+			_pendingJobs.fetch_sub(1);
+			return true;
+		}
+	}
+
+	return false;
+}
+
+void JobSystem::_Execute(Job& job) {
+	job.Func();
+	_Finish(job.Group);
+}
+
+void JobSystem::_Finish(Counter* counter) {
+	if (counter == nullptr) return;
+
+	// We decrement while holding the lock so that Wait can't return (and the counter can't be destroyed)
+	// until we're done with the counter. If we were the last job in the group, we take anything that was
+	// waiting on it and schedule it
+	std::vector<std::pair<JobFunc, Counter*>> continuations;
+	{
+		std::lock_guard<std::mutex> lock(counter->_continuationLock);
+		if (counter->_remaining.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+			continuations.swap(counter->_continuations);
+		}
+	}
+	for (auto& [func, group] : continuations) {
+		_Push({ std::move(func), group });
+	}
+}
@@ -0,0 +1,185 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "Utils/Macros.h"
+
+/**
+ * A fixed size pool of worker threads that engine systems can use to spread work across cores. Each
+ * thread has it's own queue of jobs, and threads that run out of work will steal jobs from the other
+ * queues. The main thread takes part in the pool as thread 0, but only runs the jobs that it is waiting
+ * on, so that background work (like saving a scene) never stalls a frame. Jobs queued from the main
+ * thread go to the worker's queues.
+ *
+ * Jobs can be grouped with a Counter, which can then be waited on, or used as a dependency so that
+ * other jobs only start once the counter has finished. Jobs that must run on the main thread (for instance
+ * anything touching OpenGL) can be queued with RunOnMainThread, and will be run once per frame by the
+ * application
+ */
+class JobSystem final {
+public:
+	NO_MOVE(JobSystem);
+	NO_COPY(JobSystem);
+
+	typedef std::function<void()> JobFunc;
+	typedef std::function<void(size_t begin, size_t end)> RangeFunc;
+
+	/**
+	 * Tracks the number of outstanding jobs in a group. Jobs that depend on the group can be
+	 * attached to the counter, and will be scheduled once all jobs in the group have completed.
+	 * A counter must not be destroyed until JobSystem::Wait has returned for it
+	 */
+	class Counter {
+	public:
+		NO_MOVE(Counter);
+		NO_COPY(Counter);
+
+		Counter() : _remaining(0), _continuations() { }
+
+		/**
+		 * Returns true if all the jobs associated with this counter have completed
+		 */
+		bool IsDone() const { return _remaining.load(std::memory_order_acquire) == 0; }
+
+	private:
+		friend class JobSystem;
+
+		std::atomic<uint32_t> _remaining;
+		std::mutex            _continuationLock;
+		// Jobs to schedule once the counter reaches zero, stored as the job and the counter for that job
+		std::vector<std::pair<JobFunc, Counter*>> _continuations;
+	};
+
+	~JobSystem();
+
+	/**
+	 * Creates the job system singleton, should be called once by the application on startup
+	 *
+	 * @param workerCount The number of worker threads to create, or 0 to use one less than the number of hardware threads
+	 */
+	static void Init(uint32_t workerCount = 0);
+	/**
+	 * Stops all worker threads and destroys the job system singleton
+	 */
+	static void Shutdown();
+	/**
+	 * Gets the job system singleton, Init must have been called first
+	 */
+	static JobSystem& Get();
+	/**
+	 * Returns true if the job system has been initialized
+	 */
+	static bool IsInitialized() { return _singleton != nullptr; }
+
+	/**
+	 * Gets the number of worker threads, not including the main thread
+	 */
+	uint32_t WorkerCount() const { return static_cast<uint32_t>(_workers.size()); }
+	/**
+	 * Gets the total number of threads that will run jobs, including the main thread
+	 */
+	uint32_t ThreadCount() const { return WorkerCount() + 1; }
+	/**
+	 * Returns true if the calling thread is the main thread
+	 */
+	bool IsMainThread() const { return std::this_thread::get_id() == _mainThreadId; }
+
+	/**
+	 * Queues a job to be run on any thread
+	 *
+	 * @param job The job to run
+	 * @param counter An optional counter to track completion of the job with
+	 */
+	void Run(JobFunc job, Counter* counter = nullptr);
+	/**
+	 * Queues a job that will only be run once all the jobs tracked by dependency have finished. If the
+	 * dependency is already done, the job is queued immediately
+	 *
+	 * @param dependency The counter to wait for before running the job
+	 * @param job The job to run
+	 * @param counter An optional counter to track completion of the job with
+	 */
+	void RunAfter(Counter& dependency, JobFunc job, Counter* counter = nullptr);
+	/**
+	 * Queues a job that must be run on the main thread, it will be run the next time the main thread
+	 * processes it's jobs (once per frame, or while the main thread is waiting on a counter)
+	 *
+	 * @param job The job to run
+	 * @param counter An optional counter to track completion of the job with
+	 */
+	void RunOnMainThread(JobFunc job, Counter* counter = nullptr);
+
+	/**
+	 * Blocks until all the jobs tracked by the counter have finished. The calling thread will run
+	 * the counter's jobs that have not been started yet while it waits, but never unrelated jobs
+	 *
+	 * @param counter The counter to wait on
+	 */
+	void Wait(Counter& counter);
+
+	/**
+	 * Splits the range [0, count) into batches and runs them across all threads, blocking until they have all
+	 * finished. The calling thread will process batches as well
+	 *
+	 * @param count The number of elements to process
+	 * @param batchSize The number of elements per job, or 0 to pick a batch size based on the thread count
+	 * @param func The function to invoke for each batch, with the begin and end (exclusive) indices of the batch
+	 */
+	void ParallelFor(size_t count, size_t batchSize, const RangeFunc& func);
+
+	/**
+	 * Runs all jobs that have been queued for the main thread, should only be called from the main thread.
+	 * If there are no worker threads, this also runs any background jobs that are waiting
+	 */
+	void ProcessMainThreadJobs();
+
+protected:
+	JobSystem(uint32_t workerCount);
+
+	struct Job {
+		JobFunc  Func;
+		Counter* Group;
+	};
+
+	// Each thread owns a queue, the owner takes jobs from the back and thieves take jobs from the front. The
+	// main thread's queue is only used when there are no workers
+	struct WorkQueue {
+		std::mutex      Lock;
+		std::deque<Job> Jobs;
+	};
+
+	std::vector<std::thread>                _workers;
+	// One queue per thread, with the main thread at index 0
+	std::vector<std::unique_ptr<WorkQueue>> _queues;
+	std::thread::id                         _mainThreadId;
+
+	std::atomic<bool>                       _isRunning;
+	// The number of jobs sitting in queues, used to let idle workers sleep
+	std::atomic<uint32_t>                   _pendingJobs;
+	// Used to pick a queue when jobs are pushed from threads outside the job system
+	std::atomic<uint32_t>                   _nextQueue;
+	std::mutex                              _sleepLock;
+	std::condition_variable                 _sleepCondition;
+
+	std::mutex                              _mainThreadLock;
+	std::vector<Job>                        _mainThreadJobs;
+
+	static JobSystem* _singleton;
+
+	void _WorkerMain(uint32_t threadIndex);
+	void _Push(Job&& job);
+	/**
+	 * Takes a job from our own queue, or steals one from another thread. If group is not null, only jobs
+	 * in that group will be taken
+	 */
+	bool _TryPop(uint32_t threadIndex, Job& result, Counter* group = nullptr);
+	void _Execute(Job& job);
+	void _Finish(Counter* counter);
+};
@@ -0,0 +1,161 @@
+#include "ComponentBenchmarkLayer.h"
+#include <chrono>
+#include <typeindex>
+#include "Gameplay/Scene.h"
+#include "Gameplay/Components/RenderComponent.h"
+#include "Gameplay/Physics/RigidBody.h"
+#include "Gameplay/Physics/TriggerVolume.h"
+
+// The number of objects (and components of each type) to run the benchmark with
+static const size_t ObjectCounts[] = { 10000, 100000 };
+// The number of passes to average each iteration time over
+static const int IterationPasses = 20;
+
+/**
+ * Invokes a function IterationPasses times, and returns the average time per pass in milliseconds
+ */
+template <typename Func>
+static double TimePasses(Func&& func) {
+	auto start = std::chrono::high_resolution_clock::now();
+	for (int ix = 0; ix < IterationPasses; ix++) {
+		func();
+	}
+	return std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count() / IterationPasses;
+}
+
+/**
+ * The way GameObject::Get used to find components, by comparing the type of every attached component
+ */
+template <typename T>
+static std::shared_ptr<T> TypeidScanGet(const std::vector<Gameplay::IComponent::Sptr>& components) {
+	for (const auto& ptr : components) {
+		if (std::type_index(typeid(*ptr.get())) == std::type_index(typeid(T))) {
+			return std::dynamic_pointer_cast<T>(ptr);
+		}
+	}
+	return nullptr;
+}
+
+/**
+ * The way GameObject::Has used to check for components
+ */
+template <typename T>
+static bool TypeidScanHas(const std::vector<Gameplay::IComponent::Sptr>& components) {
+	for (const auto& ptr : components) {
+		if (std::type_index(typeid(*ptr.get())) == std::type_index(typeid(T))) {
+			return true;
+		}
+	}
+	return false;
+}
+
+ComponentBenchmarkLayer::ComponentBenchmarkLayer()
+	: ApplicationLayer(),
+	_hasRun(false)
+{
+	Name = "Component Benchmark";
+	Overrides = AppLayerFunctions::OnSceneLoad;
+}
+
+ComponentBenchmarkLayer::~ComponentBenchmarkLayer()
+{ }
+
+void ComponentBenchmarkLayer::OnSceneLoad() {
+	if (_hasRun) {
+		return;
+	}
+	_hasRun = true;
+
+	for (size_t count : ObjectCounts) {
+		_RunBenchmark(count);
+	}
+}
+
+void ComponentBenchmarkLayer::_RunBenchmark(size_t objectCount) {
+	using namespace Gameplay;
+	using namespace Gameplay::Physics;
+
+	// We use our own scene so that the benchmark doesn't disturb the one that's loaded. The scene is never
+	// awoken, so the rigidbodies are never added to the physics world
+	Scene::Sptr scene = std::make_shared<Scene>();
+
+	// We keep our own copy of each object's component list (in the same order) for the typeid scan
+	std::vector<GameObject::Sptr> objects;
+	std::vector<std::vector<IComponent::Sptr>> componentLists;
+	objects.reserve(objectCount);
+	componentLists.reserve(objectCount);
+
+	auto start = std::chrono::high_resolution_clock::now();
+	for (size_t ix = 0; ix < objectCount; ix++) {
+		GameObject::Sptr object = scene->CreateGameObject("Component Benchmark");
+		RenderComponent::Sptr renderer = object->Add<RenderComponent>();
+		RigidBody::Sptr body = object->Add<RigidBody>(ix % 2 == 0 ? RigidBodyType::Dynamic : RigidBodyType::Kinematic);
+		objects.push_back(object);
+		componentLists.push_back({ renderer, body });
+	}
+	double createMs = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+
+	// Each callback does a little bit of work with the component, so the loops can't be optimized out
+	size_t checksum = 0;
+	double renderEachMs = TimePasses([&]() {
+		scene->Components().Each<RenderComponent>([&](const RenderComponent::Sptr& renderer) {
+			checksum += renderer->GetMaterial() == nullptr;
+		});
+	});
+	double bodyEachMs = TimePasses([&]() {
+		scene->Components().Each<RigidBody>([&](const RigidBody::Sptr& body) {
+			checksum += body->GetType() == RigidBodyType::Dynamic;
+		});
+	});
+
+	// The same work through ForEach, which is what the engine's hot paths use
+	size_t forEachChecksum = 0;
+	double renderForEachMs = TimePasses([&]() {
+		scene->Components().ForEach<RenderComponent>([&](RenderComponent& renderer) {
+			forEachChecksum += renderer.GetMaterial() == nullptr;
+		});
+	});
+	double bodyForEachMs = TimePasses([&]() {
+		scene->Components().ForEach<RigidBody>([&](RigidBody& body) {
+			forEachChecksum += body.GetType() == RigidBodyType::Dynamic;
+		});
+	});
+	LOG_ASSERT(checksum == forEachChecksum, "Each and ForEach visited different components!");
+
+	// Lookups on every object, for a type that is attached (RigidBody, the last component, is the worst
+	// case for the scan) and a type that is not
+	size_t lookupChecksum = 0;
+	double slotLookupMs = TimePasses([&]() {
+		for (const GameObject::Sptr& object : objects) {
+			lookupChecksum += object->Get<RigidBody>() != nullptr;
+			lookupChecksum += object->Has<TriggerVolume>();
+		}
+	});
+	size_t scanChecksum = 0;
+	double scanLookupMs = TimePasses([&]() {
+		for (const std::vector<IComponent::Sptr>& components : componentLists) {
+			scanChecksum += TypeidScanGet<RigidBody>(components) != nullptr;
+			scanChecksum += TypeidScanHas<TriggerVolume>(components);
+		}
+	});
+	LOG_ASSERT(lookupChecksum == scanChecksum, "Slot lookups and typeid scans found different components!");
+
+	// Our references would keep the components alive past the scene, so we drop them first
+	objects.clear();
+	componentLists.clear();
+
+	// Destroying the scene removes every component from the pools
+	start = std::chrono::high_resolution_clock::now();
+	scene = nullptr;
+	double destroyMs = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+
+	LOG_INFO("Component benchmark ({} objects, {} passes, checksum {}):", objectCount, IterationPasses, checksum);
+	LOG_INFO("\tCreate:                   {:.2f}ms", createMs);
+	LOG_INFO("\tEach<RenderComponent>:    {:.3f}ms average", renderEachMs);
+	LOG_INFO("\tForEach<RenderComponent>: {:.3f}ms average ({:.1f}x)", renderForEachMs, renderEachMs / renderForEachMs);
+	LOG_INFO("\tEach<RigidBody>:          {:.3f}ms average", bodyEachMs);
+	LOG_INFO("\tForEach<RigidBody>:       {:.3f}ms average ({:.1f}x)", bodyForEachMs, bodyEachMs / bodyForEachMs);
+	LOG_INFO("\tGet + Has (slot table):   {:.3f}ms average", slotLookupMs);
+	LOG_INFO("\tGet + Has (typeid scan):  {:.3f}ms average ({:.1f}x slower)", scanLookupMs, scanLookupMs / slotLookupMs);
+	LOG_INFO("\tDestroy:                  {:.2f}ms", destroyMs);
+}
@@ -0,0 +1,33 @@
+#pragma once
+#include "Application/ApplicationLayer.h"
+
+/**
+ * Measures the component pools by filling a separate scene with objects that each have a RenderComponent
+ * and a RigidBody, then timing iteration over both pools and the removal of every component. This is run
+ * at a few different component counts, and the average times are logged
+ *
+ * Iteration is timed with both Each (the std::function path the hot loops used to take) and ForEach (which
+ * the render loop, lighting, particles and physics use now), doing the same work per component. It also
+ * compares GameObject::Get and Has (which use the type bitmask and slot table) against the typeid scan
+ * that they used to do
+ */
+class ComponentBenchmarkLayer final : public ApplicationLayer {
+public:
+	MAKE_PTRS(ComponentBenchmarkLayer)
+
+	ComponentBenchmarkLayer();
+	virtual ~ComponentBenchmarkLayer();
+
+	// Inherited from ApplicationLayer
+
+	virtual void OnSceneLoad() override;
+
+protected:
+	// We only want to benchmark once, not every time a scene is loaded
+	bool _hasRun;
+
+	/**
+	 * Runs the benchmark with the given number of objects, and logs the results
+	 */
+	static void _RunBenchmark(size_t objectCount);
+};
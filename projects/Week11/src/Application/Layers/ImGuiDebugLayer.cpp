@@ -1,11 +1,14 @@
 #include "ImGuiDebugLayer.h"
 #include "../Application.h"
 #include "Utils/ImGuiHelper.h"
+#include "Utils/JsonGlmHelpers.h"
 #include "imgui_internal.h"
 #include "Gameplay/Scene.h"
 #include "../Timing.h"
 #include "Utils/Windows/FileDialogs.h"
+#include "Utils/VirtualFileSystem.h"
 #include <filesystem>
+#include <thread>
 #include "RenderLayer.h"
 
 #include "../Windows/HierarchyWindow.h"
@@ -20,7 +23,10 @@
 
 ImGuiDebugLayer::ImGuiDebugLayer() :
 	ApplicationLayer(),
-	_dockInvalid(true)
+	_dockInvalid(true),
+	_autosaveInterval(120.0f),
+	_autosaveTimer(0.0f),
+	_autosavePath("autosave.json.gz")
 {
 	Name = "ImGui Debug Layer";
 	Overrides = AppLayerFunctions::OnAppLoad | AppLayerFunctions::OnAppUnload | AppLayerFunctions::OnPreRender | AppLayerFunctions::OnRender | AppLayerFunctions::OnPostRender;
@@ -40,16 +46,41 @@ void ImGuiDebugLayer::OnAppLoad(const nlohmann::json& config)
 	RegisterWindow<DebugWindow>();
 	RegisterWindow<GBufferPreviews>();
 	RegisterWindow<PostProcessingSettingsWindow>();
+
+	// Autosaving can be turned off by setting the interval to 0
+	nlohmann::json settings = JsonGet(config, Name, GetDefaultConfig());
+	_autosaveInterval = JsonGet(settings, "autosave_interval", _autosaveInterval);
+	_autosavePath = JsonGet(settings, "autosave_path", _autosavePath);
 }
 
-void ImGuiDebugLayer::OnAppUnload()
+nlohmann::json ImGuiDebugLayer::GetDefaultConfig()
 {
+	return {
+		{ "autosave_interval", 120.0f },
+		{ "autosave_path", "autosave.json.gz" }
+	};
+}
 
+void ImGuiDebugLayer::OnAppUnload()
+{
+	// Make sure any saves that are still being written in the background make it to disk before the job system shuts down
+	while (Gameplay::Scene::IsSaveInProgress()) {
+		std::this_thread::yield();
+	}
 }
 
 void ImGuiDebugLayer::OnPreRender()
 {
-
+	Application& app = Application::Get();
+	Gameplay::Scene::Sptr scene = app.CurrentScene();
+
+	// Autosaves only capture a snapshot here, the rest of the save happens in the background. We skip play mode
+	// since that state gets thrown away, and skip while the last save is still being written
+	_autosaveTimer += Timing::Current().UnscaledDeltaTime();
+	if (_autosaveInterval > 0.0f && _autosaveTimer >= _autosaveInterval && scene != nullptr && !scene->IsPlaying && !Gameplay::Scene::IsSaveInProgress()) {
+		_autosaveTimer = 0.0f;
+		scene->SaveAsync(_autosavePath, false);
+	}
 }
 
 void ImGuiDebugLayer::OnRender(const Framebuffer::Sptr& prevLayer)
@@ -165,23 +196,48 @@ void ImGuiDebugLayer::OnRender(const Framebuffer::Sptr& prevLayer)
 
 				// Load scene item
 				if (ImGui::MenuItem("Load Scene", NULL, false)) {
-					std::optional<std::string> path = FileDialogs::OpenFile("Scene File\0*.json\0\0");
+					std::optional<std::string> path = FileDialogs::OpenFile("Scene File\0*.json;*.bscene;*.gz\0\0");
 					if (path.has_value()) {
 						app.LoadScene(path.value());
 					}
 				}
 
-				// Save scene item
+				// Save scene item, binary scenes are saved when the path ends in .bscene, and compressed when it ends in .gz
 				if (ImGui::MenuItem("Save Scene", NULL, false)) {
-					std::optional<std::string> path = FileDialogs::SaveFile("Scene File\0*.json\0\0");
+					std::optional<std::string> path = FileDialogs::SaveFile("Scene File\0*.json\0Binary Scene\0*.bscene\0Compressed Scene\0*.gz\0\0");
 					if (path.has_value()) {
-						app.CurrentScene()->Save(path.value());
+						app.CurrentScene()->SaveAsync(path.value());
 
 						std::string newFilename = std::filesystem::path(path.value()).stem().string() + "-manifest.json";
 						ResourceManager::SaveManifest(newFilename);
 					}
 				}
 
+				// Converts a JSON scene to a binary scene next to it, which will share the JSON scene's manifest
+				if (ImGui::MenuItem("Convert Scene to Binary", NULL, false)) {
+					std::optional<std::string> path = FileDialogs::OpenFile("Scene File\0*.json\0\0");
+					if (path.has_value()) {
+						std::string manifestPath = std::filesystem::path(path.value()).stem().string() + "-manifest.json";
+						if (std::filesystem::exists(manifestPath)) {
+							ResourceManager::LoadManifest(manifestPath);
+						}
+						std::string outputPath = std::filesystem::path(path.value()).replace_extension(Gameplay::Scene::BinaryExtension).string();
+						Gameplay::Scene::ConvertToBinary(path.value(), outputPath);
+					}
+				}
+
+				// Packs a manifest and all the files it's resources use into an archive, which the application
+				// will load assets from on startup if it matches the asset_archive setting
+				if (ImGui::MenuItem("Pack Assets", NULL, false)) {
+					std::optional<std::string> manifestPath = FileDialogs::OpenFile("Manifest\0*.json\0\0");
+					if (manifestPath.has_value()) {
+						std::optional<std::string> archivePath = FileDialogs::SaveFile("Asset Archive\0*.pak\0\0");
+						if (archivePath.has_value()) {
+							VirtualFileSystem::PackManifest(archivePath.value(), manifestPath.value());
+						}
+					}
+				}
+
 				ImGui::EndMenu();
 			}
 
@@ -46,12 +46,18 @@ public:
 	virtual void OnPreRender() override;
 	virtual void OnRender(const Framebuffer::Sptr& prevLayer) override;
 	virtual void OnPostRender() override;
+	virtual nlohmann::json GetDefaultConfig() override;
 
 protected:
 	std::vector<IEditorWindow::Sptr> _windows;
 	nlohmann::json _backupState;
 	bool           _dockInvalid;
 
+	// Seconds between autosaves (0 to disable), and the time since the last autosave
+	float          _autosaveInterval;
+	float          _autosaveTimer;
+	std::string    _autosavePath;
+
 	void _RenderGameWindow();
 	ImGuiID& _FindOpenParentWindow(const IEditorWindow::Sptr& window, ImGuiID& mainID, ImGuiDir* direction, float* dist);
 };
\ No newline at end of file
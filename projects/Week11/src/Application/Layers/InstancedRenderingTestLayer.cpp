@@ -8,7 +8,7 @@ InstancedRenderingTestLayer::InstancedRenderingTestLayer()
 	: ApplicationLayer()
 {
 	Name = "Instanced Rendering";
-	Overrides = AppLayerFunctions::OnSceneLoad | AppLayerFunctions::OnRender | AppLayerFunctions::OnUpdate;
+	Overrides = AppLayerFunctions::OnSceneLoad | AppLayerFunctions::OnSceneUnload | AppLayerFunctions::OnRender | AppLayerFunctions::OnUpdate;
 }
 
 InstancedRenderingTestLayer::~InstancedRenderingTestLayer()
@@ -49,9 +49,13 @@ void InstancedRenderingTestLayer::OnSceneLoad() {
 
 
 	// Due to how scene stuff is handled in editor, we'll remove all existing instances and re-add them
-	for (auto& instance : _instances) {
-		scene->RemoveGameObject(scene->FindObjectByGUID(instance));
+	for (const Guid& id : _instanceGuids) {
+		Gameplay::GameObject::Sptr instance = scene->FindObjectByGUID(id);
+		if (instance != nullptr) {
+			scene->RemoveGameObject(instance);
+		}
 	}
+	_instanceGuids.clear();
 
 	// Create a bunch of instances in a cube
 	_instances.clear();
@@ -76,6 +80,15 @@ void InstancedRenderingTestLayer::OnSceneLoad() {
 	_UpdateInstances();
 }
 
+void InstancedRenderingTestLayer::OnSceneUnload() {
+	_instanceGuids.clear();
+	_instanceGuids.reserve(_instances.size());
+	for (const auto& instance : _instances) {
+		_instanceGuids.push_back(instance);
+	}
+	_instances.clear();
+}
+
 void InstancedRenderingTestLayer::OnUpdate() {
 	//_UpdateInstances();
 }
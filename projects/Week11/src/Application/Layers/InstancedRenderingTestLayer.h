@@ -20,6 +20,7 @@ public:
 	// Inherited from ApplicationLayer
 
 	virtual void OnSceneLoad() override;
+	virtual void OnSceneUnload() override;
 	virtual void OnUpdate() override;
 	virtual void OnRender(const Framebuffer::Sptr& prevLayer) override;
 
@@ -30,6 +31,9 @@ protected:
 	Texture2D::Sptr     _texture;
 		
 	std::vector<Gameplay::GameObject::WeakRef> _instances;
+	// Handles are only valid within a single scene, so we remember the instance IDs when
+	// the scene unloads in case the next scene was saved with the instances in it
+	std::vector<Guid> _instanceGuids;
 
 	struct InstanceInfo {
 		glm::mat4 ModelMatrix;
@@ -0,0 +1,213 @@
+#include "JobSystemBenchmarkLayer.h"
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <vector>
+#include "Application/JobSystem.h"
+
+// The number of elements to use for the ParallelFor coverage checks
+static const size_t CoverageCount = 100000;
+// The number of empty jobs to time for the overhead benchmark
+static const size_t OverheadJobs = 100000;
+// The number of work items for the scaling benchmark, each item does a bit of floating point math
+static const size_t ScalingItems = 1 << 22;
+// The number of times to run each scaling configuration, the fastest run is reported
+static const int ScalingRuns = 5;
+
+/**
+ * A small amount of work that the compiler can't skip, used for the scaling benchmark
+ */
+static float DoWork(size_t begin, size_t end) {
+	float result = 0.0f;
+	for (size_t ix = begin; ix < end; ix++) {
+		result += std::sqrt(static_cast<float>(ix)) * std::sin(static_cast<float>(ix));
+	}
+	return result;
+}
+
+/**
+ * Logs the result of a check, and returns 1 if it failed so that failures can be counted
+ */
+static int Check(bool passed, const char* name) {
+	if (passed) {
+		LOG_INFO("\t[PASS] {}", name);
+		return 0;
+	}
+	LOG_ERROR("\t[FAIL] {}", name);
+	return 1;
+}
+
+/**
+ * Invokes a function ScalingRuns times, and returns the fastest run in milliseconds
+ */
+template <typename Func>
+static double TimeFastest(Func&& func) {
+	double best = 0.0;
+	for (int ix = 0; ix < ScalingRuns; ix++) {
+		auto start = std::chrono::high_resolution_clock::now();
+		func();
+		double ms = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+		best = ix == 0 ? ms : std::min(best, ms);
+	}
+	return best;
+}
+
+JobSystemBenchmarkLayer::JobSystemBenchmarkLayer()
+	: ApplicationLayer(),
+	_hasRun(false)
+{
+	Name = "Job System Benchmark";
+	Overrides = AppLayerFunctions::OnSceneLoad;
+}
+
+JobSystemBenchmarkLayer::~JobSystemBenchmarkLayer()
+{ }
+
+void JobSystemBenchmarkLayer::OnSceneLoad() {
+	if (_hasRun) {
+		return;
+	}
+	_hasRun = true;
+
+	if (!JobSystem::IsInitialized()) {
+		LOG_WARN("Job system benchmark needs the job system to be running, skipping");
+		return;
+	}
+
+	int failures = _RunChecks();
+	if (failures > 0) {
+		LOG_ERROR("{} job system checks failed, skipping benchmarks", failures);
+		return;
+	}
+	_RunBenchmarks();
+}
+
+int JobSystemBenchmarkLayer::_RunChecks() {
+	JobSystem& jobs = JobSystem::Get();
+	int failures = 0;
+	LOG_INFO("Job system checks ({} threads):", jobs.ThreadCount());
+
+	// Every index should be visited exactly once, with a few different batch sizes
+	for (size_t batchSize : { (size_t)0, (size_t)1, (size_t)7, CoverageCount }) {
+		std::vector<std::atomic<uint32_t>> visits(CoverageCount);
+		jobs.ParallelFor(CoverageCount, batchSize, [&](size_t begin, size_t end) {
+			for (size_t ix = begin; ix < end; ix++) {
+				visits[ix].fetch_add(1, std::memory_order_relaxed);
+			}
+		});
+		bool allOnce = true;
+		for (const auto& count : visits) {
+			allOnce &= count.load() == 1;
+		}
+		failures += Check(allOnce, "ParallelFor visits every index once");
+	}
+
+	// ParallelFor inside of jobs, like systems that go wide from within a job
+	{
+		std::vector<std::atomic<uint32_t>> visits(CoverageCount);
+		const size_t outerCount = 8;
+		const size_t innerCount = CoverageCount / outerCount;
+		jobs.ParallelFor(outerCount, 1, [&](size_t outerBegin, size_t outerEnd) {
+			for (size_t outer = outerBegin; outer < outerEnd; outer++) {
+				JobSystem::Get().ParallelFor(innerCount, 0, [&](size_t begin, size_t end) {
+					for (size_t ix = begin; ix < end; ix++) {
+						visits[outer * innerCount + ix].fetch_add(1, std::memory_order_relaxed);
+					}
+				});
+			}
+		});
+		bool allOnce = true;
+		for (const auto& count : visits) {
+			allOnce &= count.load() == 1;
+		}
+		failures += Check(allOnce, "Nested ParallelFor visits every index once");
+	}
+
+	// Continuations must only run after every job they depend on has finished
+	{
+		JobSystem::Counter first, second;
+		std::atomic<uint32_t> finished(0);
+		std::atomic<uint32_t> seenByContinuation(0);
+		const uint32_t dependencyCount = 64;
+		for (uint32_t ix = 0; ix < dependencyCount; ix++) {
+			jobs.Run([&]() {
+				std::this_thread::sleep_for(std::chrono::microseconds(100));
+				finished.fetch_add(1);
+			}, &first);
+		}
+		jobs.RunAfter(first, [&]() { seenByContinuation = finished.load(); }, &second);
+		jobs.Wait(second);
+		jobs.Wait(first);
+		failures += Check(seenByContinuation.load() == dependencyCount, "RunAfter runs after all of its dependencies");
+	}
+
+	// Main thread jobs must run on the main thread, even when they're queued from a worker
+	{
+		JobSystem::Counter counter;
+		std::atomic<bool> ranOnMain(false);
+		jobs.Run([&]() {
+			JobSystem::Get().RunOnMainThread([&]() { ranOnMain = JobSystem::Get().IsMainThread(); }, &counter);
+		}, &counter);
+		jobs.Wait(counter);
+		failures += Check(ranOnMain.load(), "RunOnMainThread jobs run on the main thread");
+	}
+
+	// Background jobs queued from the main thread must not be picked up by the main thread while it waits on
+	// something else (this is what would cause a hitch when saving in the background). We can only check
+	// this when there are workers to run the background job
+	if (jobs.WorkerCount() > 0) {
+		JobSystem::Counter background;
+		std::atomic<bool> ranOnMain(true);
+		jobs.Run([&]() {
+			std::this_thread::sleep_for(std::chrono::milliseconds(20));
+			ranOnMain = JobSystem::Get().IsMainThread();
+		}, &background);
+		jobs.ParallelFor(CoverageCount, 0, [](size_t begin, size_t end) { DoWork(begin, end); });
+
+		// We don't use Wait here, since that would let the main thread help with the background job
+		while (!background.IsDone()) {
+			std::this_thread::yield();
+		}
+		jobs.Wait(background);
+		failures += Check(!ranOnMain.load(), "The main thread does not run unrelated jobs while it waits");
+	}
+
+	return failures;
+}
+
+void JobSystemBenchmarkLayer::_RunBenchmarks() {
+	JobSystem& jobs = JobSystem::Get();
+
+	// The cost of queueing, running and finishing a job that does nothing
+	JobSystem::Counter counter;
+	auto start = std::chrono::high_resolution_clock::now();
+	for (size_t ix = 0; ix < OverheadJobs; ix++) {
+		jobs.Run([]() {}, &counter);
+	}
+	jobs.Wait(counter);
+	double overheadNs = std::chrono::duration<double, std::nano>(std::chrono::high_resolution_clock::now() - start).count() / OverheadJobs;
+
+	// The same work split into more and more batches, up to one per thread. We keep the result so that the
+	// work can't be optimized out
+	std::atomic<float> sink(0.0f);
+	double directMs = TimeFastest([&]() { sink = DoWork(0, ScalingItems); });
+
+	LOG_INFO("Job system benchmark ({} threads, fastest of {} runs):", jobs.ThreadCount(), ScalingRuns);
+	LOG_INFO("\tEmpty job overhead: {:.0f}ns per job ({} jobs)", overheadNs, OverheadJobs);
+	LOG_INFO("\tDirect:             {:.2f}ms for {} items", directMs, ScalingItems);
+	for (uint32_t batches = 1; ; batches = std::min(batches * 2, jobs.ThreadCount())) {
+		size_t batchSize = (ScalingItems + batches - 1) / batches;
+		double ms = TimeFastest([&]() {
+			jobs.ParallelFor(ScalingItems, batchSize, [&](size_t begin, size_t end) { sink = sink + DoWork(begin, end); });
+		});
+		LOG_INFO("\t{:>2} batches:         {:.2f}ms ({:.2f}x speedup, {:.0f}% efficiency)",
+			batches, ms, directMs / ms, 100.0 * directMs / ms / batches);
+		if (batches == jobs.ThreadCount()) break;
+	}
+
+	// Let the default batch size pick how to split the work
+	double defaultMs = TimeFastest([&]() {
+		jobs.ParallelFor(ScalingItems, 0, [&](size_t begin, size_t end) { sink = sink + DoWork(begin, end); });
+	});
+	LOG_INFO("\tDefault batches:    {:.2f}ms ({:.2f}x speedup)", defaultMs, directMs / defaultMs);
+}
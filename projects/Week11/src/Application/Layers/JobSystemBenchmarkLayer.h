@@ -0,0 +1,37 @@
+#pragma once
+#include "Application/ApplicationLayer.h"
+
+/**
+ * Checks that the job system behaves correctly, then measures how well it scales. The checks cover ParallelFor
+ * visiting every index exactly once (including when nested inside jobs), RunAfter ordering, main thread
+ * affinity, and the main thread not picking up unrelated background jobs while it waits. Failed checks are
+ * logged as errors.
+ *
+ * The benchmarks time the overhead of running many tiny jobs, and a fixed amount of work split into 1, 2, 4...
+ * equal batches, so that at most that many threads can work on it at once. The time for each batch count and
+ * the speedup over running the work directly are logged
+ */
+class JobSystemBenchmarkLayer final : public ApplicationLayer {
+public:
+	MAKE_PTRS(JobSystemBenchmarkLayer)
+
+	JobSystemBenchmarkLayer();
+	virtual ~JobSystemBenchmarkLayer();
+
+	// Inherited from ApplicationLayer
+
+	virtual void OnSceneLoad() override;
+
+protected:
+	// We only want to run once, not every time a scene is loaded
+	bool _hasRun;
+
+	/**
+	 * Runs the correctness checks, and returns the number that failed
+	 */
+	static int _RunChecks();
+	/**
+	 * Runs the scaling benchmarks, and logs the results
+	 */
+	static void _RunBenchmarks();
+};
@@ -0,0 +1,217 @@
+#include "PhysicsStressTestLayer.h"
+#include <algorithm>
+#include <chrono>
+#include "Gameplay/Scene.h"
+#include "Application/Application.h"
+#include "Application/JobSystem.h"
+#include "Gameplay/Physics/RigidBody.h"
+#include "Gameplay/Physics/TriggerVolume.h"
+#include "Gameplay/Physics/Colliders/BoxCollider.h"
+
+// The number of bodies along each axis of the pile, 10 x 10 x 50 = 5000 bodies
+static const glm::ivec3 PileSize = { 10, 10, 50 };
+// The number of trigger volumes along each axis, spread through the lower part of the pile, 10 x 10 x 2 = 200 triggers
+static const glm::ivec3 TriggerGridSize = { 10, 10, 2 };
+// The number of each type of query to run per frame, spread in a grid over the pile
+static const int QueryGridSize = 32;
+// The number of frames to average over before reporting the physics time
+static const uint32_t ReportInterval = 300;
+// The number of frames to simulate before reporting where the bodies ended up
+static const uint32_t SettleFrames = 600;
+
+PhysicsStressTestLayer::PhysicsStressTestLayer()
+	: ApplicationLayer(),
+	_objects(std::vector<Gameplay::GameObject::WeakRef>()),
+	_triggers(std::vector<Gameplay::GameObject::WeakRef>()),
+	_objectGuids(std::vector<Guid>()),
+	_totalPhysicsTime(0.0f),
+	_totalQueryTime(0.0f),
+	_frameCount(0),
+	_simulatedFrames(0)
+{
+	Name = "Physics Stress Test";
+	Overrides = AppLayerFunctions::OnSceneLoad | AppLayerFunctions::OnSceneUnload | AppLayerFunctions::OnUpdate;
+}
+
+PhysicsStressTestLayer::~PhysicsStressTestLayer()
+{ }
+
+void PhysicsStressTestLayer::OnSceneLoad() {
+	using namespace Gameplay;
+	using namespace Gameplay::Physics;
+
+	Scene::Sptr scene = Application::Get().CurrentScene();
+
+	// Remove any objects that were saved with the scene, we'll re-create them
+	for (const Guid& id : _objectGuids) {
+		GameObject::Sptr object = scene->FindObjectByGUID(id);
+		if (object != nullptr) {
+			scene->RemoveGameObject(object);
+		}
+	}
+	_objectGuids.clear();
+	_objects.clear();
+	_objects.reserve(PileSize.x * PileSize.y * PileSize.z + 1);
+	_triggers.clear();
+	_triggers.reserve(TriggerGridSize.x * TriggerGridSize.y * TriggerGridSize.z);
+
+	// A large static floor to catch the pile
+	GameObject::Sptr floor = scene->CreateGameObject("Stress Test Floor");
+	{
+		floor->SetPostion(glm::vec3(0.0f, 0.0f, -1.0f));
+		floor->HideInHierarchy = true;
+
+		RigidBody::Sptr physics = floor->Add<RigidBody>(RigidBodyType::Static);
+		physics->AddCollider(BoxCollider::Create(glm::vec3(50.0f, 50.0f, 1.0f)));
+		_objects.push_back(floor);
+	}
+
+	// Stack the bodies in columns, with a small offset per layer so the pile collapses instead of
+	// stacking perfectly. We don't use rand here, so every run starts from the same state
+	for (int iz = 0; iz < PileSize.z; iz++) {
+		float offset = (iz % 2) * 0.25f;
+		for (int ix = 0; ix < PileSize.x; ix++) {
+			for (int iy = 0; iy < PileSize.y; iy++) {
+				GameObject::Sptr object = scene->CreateGameObject("Stress Test Body");
+				object->SetPostion(glm::vec3(ix * 1.1f + offset, iy * 1.1f + offset, 1.0f + iz * 1.1f));
+				object->HideInHierarchy = true;
+
+				RigidBody::Sptr physics = object->Add<RigidBody>(RigidBodyType::Dynamic);
+				physics->AddCollider(BoxCollider::Create(glm::vec3(0.5f)));
+				_objects.push_back(object);
+			}
+		}
+	}
+
+	// Trigger volumes spread through the bottom of the pile, so that most of them are overlapping several
+	// bodies at any time, and bodies are constantly entering and leaving them as the pile collapses
+	for (int iz = 0; iz < TriggerGridSize.z; iz++) {
+		for (int ix = 0; ix < TriggerGridSize.x; ix++) {
+			for (int iy = 0; iy < TriggerGridSize.y; iy++) {
+				GameObject::Sptr object = scene->CreateGameObject("Stress Test Trigger");
+				object->SetPostion(glm::vec3(ix * 1.1f, iy * 1.1f, 1.0f + iz * 3.0f));
+				object->HideInHierarchy = true;
+
+				TriggerVolume::Sptr volume = object->Add<TriggerVolume>();
+				volume->AddCollider(BoxCollider::Create(glm::vec3(0.75f)));
+				_triggers.push_back(object);
+			}
+		}
+	}
+
+	// The queries stay the same every frame, only the pile changes underneath them. Rays and sphere casts go
+	// straight down through the pile, and the overlap spheres sit in the bottom layers
+	_rayQueries.clear();
+	_sphereCastQueries.clear();
+	_overlapQueries.clear();
+	glm::vec3 pileExtents = glm::vec3(PileSize) * 1.1f;
+	for (int ix = 0; ix < QueryGridSize; ix++) {
+		for (int iy = 0; iy < QueryGridSize; iy++) {
+			glm::vec2 position = glm::vec2(ix + 0.5f, iy + 0.5f) / (float)QueryGridSize * glm::vec2(pileExtents);
+
+			RayQuery ray;
+			ray.From = glm::vec3(position, pileExtents.z + 5.0f);
+			ray.To = glm::vec3(position, -5.0f);
+			_rayQueries.push_back(ray);
+
+			SphereCastQuery sphereCast;
+			sphereCast.From = ray.From;
+			sphereCast.To = ray.To;
+			sphereCast.Radius = 0.25f;
+			_sphereCastQueries.push_back(sphereCast);
+
+			OverlapQuery overlap;
+			overlap.Center = glm::vec3(position, 1.0f + (ix + iy) % 4);
+			overlap.Radius = 1.0f;
+			_overlapQueries.push_back(overlap);
+		}
+	}
+
+	_totalPhysicsTime = 0.0f;
+	_totalQueryTime = 0.0f;
+	_frameCount = 0;
+	_simulatedFrames = 0;
+	LOG_INFO("Created {} bodies and {} triggers for physics stress test ({})", _objects.size() - 1, _triggers.size(),
+		scene->IsPhysicsMultithreaded() ? "multithreaded" : "single threaded");
+}
+
+void PhysicsStressTestLayer::OnSceneUnload() {
+	_objectGuids.clear();
+	_objectGuids.reserve(_objects.size() + _triggers.size());
+	for (const auto& object : _objects) {
+		_objectGuids.push_back(object);
+	}
+	for (const auto& object : _triggers) {
+		_objectGuids.push_back(object);
+	}
+	_objects.clear();
+	_triggers.clear();
+}
+
+void PhysicsStressTestLayer::OnUpdate() {
+	Gameplay::Scene::Sptr scene = Application::Get().CurrentScene();
+
+	// Physics only steps while playing, so there's nothing to measure otherwise
+	if (!scene->IsPlaying) {
+		return;
+	}
+
+	_totalPhysicsTime += scene->GetLastPhysicsTime();
+
+	// Run our batches of queries against the world as it stands after this frame's step
+	auto start = std::chrono::high_resolution_clock::now();
+	scene->Raycast(_rayQueries, _rayResults);
+	scene->SphereCast(_sphereCastQueries, _sphereCastResults);
+	scene->Overlap(_overlapQueries, _overlapResults);
+	_totalQueryTime += std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+
+	_frameCount++;
+	_simulatedFrames++;
+
+	if (_frameCount >= ReportInterval) {
+		uint32_t threads = JobSystem::IsInitialized() ? JobSystem::Get().ThreadCount() : 1;
+		LOG_INFO("Physics step: {:.3f}ms average over {} frames ({} bodies, {} triggers, {} threads, {})",
+			_totalPhysicsTime / _frameCount, _frameCount, _objects.size() - 1, _triggers.size(), threads,
+			scene->IsPhysicsMultithreaded() ? "multithreaded" : "single threaded");
+
+		size_t queryCount = _rayQueries.size() + _sphereCastQueries.size() + _overlapQueries.size();
+		float queryTime = _totalQueryTime / _frameCount;
+		size_t rayHits = std::count_if(_rayResults.begin(), _rayResults.end(), [](const Gameplay::Physics::QueryHit& hit) { return hit.HasHit(); });
+		LOG_INFO("Physics queries: {:.3f}ms average for {} queries ({:.1f} queries/ms), last frame had {} ray hits and {} overlapping objects",
+			queryTime, queryCount, queryTime > 0.0f ? queryCount / queryTime : 0.0f, rayHits, _overlapResults.Objects.size());
+
+		_totalPhysicsTime = 0.0f;
+		_totalQueryTime = 0.0f;
+		_frameCount = 0;
+	}
+
+	if (_simulatedFrames == SettleFrames) {
+		_ReportOutcome();
+	}
+}
+
+void PhysicsStressTestLayer::_ReportOutcome() const {
+	// The solvers are not bit-for-bit identical between worlds, so rather than comparing individual bodies we
+	// summarize the shape of the pile, which should match closely between runs
+	glm::vec3 min = glm::vec3(std::numeric_limits<float>::max());
+	glm::vec3 max = glm::vec3(std::numeric_limits<float>::lowest());
+	glm::vec3 sum = glm::vec3(0.0f);
+	size_t count = 0;
+
+	// Skip the floor, which is always the first object
+	for (size_t ix = 1; ix < _objects.size(); ix++) {
+		if (!_objects[ix].IsAlive()) continue;
+
+		glm::vec3 position = _objects[ix]->GetPosition();
+		min = glm::min(min, position);
+		max = glm::max(max, position);
+		sum += position;
+		count++;
+	}
+
+	if (count > 0) {
+		glm::vec3 centroid = sum / (float)count;
+		LOG_INFO("Pile after {} frames: centroid ({:.3f}, {:.3f}, {:.3f}), bounds ({:.3f}, {:.3f}, {:.3f}) to ({:.3f}, {:.3f}, {:.3f})",
+			SettleFrames, centroid.x, centroid.y, centroid.z, min.x, min.y, min.z, max.x, max.y, max.z);
+	}
+}
@@ -0,0 +1,49 @@
+#pragma once
+#include "Application/ApplicationLayer.h"
+#include <json.hpp>
+#include "Gameplay/GameObject.h"
+#include "Gameplay/Physics/PhysicsQueries.h"
+
+/**
+ * Drops a large pile of dynamic rigidbodies into the scene, with a grid of trigger volumes through the bottom
+ * of the pile, and periodically logs how long the physics step takes (including trigger updates). Each frame it
+ * also runs a batch of ray casts, sphere casts and overlap tests against the pile, and logs the query throughput. Once the pile has had time to settle, it also logs a summary of where the bodies ended up,
+ * so that runs with and without the multithreaded_physics setting can be compared
+ */
+class PhysicsStressTestLayer final : public ApplicationLayer {
+public:
+	MAKE_PTRS(PhysicsStressTestLayer)
+
+	PhysicsStressTestLayer();
+	virtual ~PhysicsStressTestLayer();
+
+	// Inherited from ApplicationLayer
+
+	virtual void OnSceneLoad() override;
+	virtual void OnSceneUnload() override;
+	virtual void OnUpdate() override;
+
+protected:
+	std::vector<Gameplay::GameObject::WeakRef> _objects;
+	std::vector<Gameplay::GameObject::WeakRef> _triggers;
+	// Handles are only valid within a single scene, so we remember the object IDs when
+	// the scene unloads in case the next scene was saved with the objects in it
+	std::vector<Guid> _objectGuids;
+
+	// The total physics time (in ms) and number of frames since we last reported
+	float    _totalPhysicsTime;
+	// The total time (in ms) spent running our queries since we last reported
+	float    _totalQueryTime;
+	uint32_t _frameCount;
+	// The number of frames that have been simulated since the pile was created
+	uint32_t _simulatedFrames;
+
+	std::vector<Gameplay::Physics::RayQuery>        _rayQueries;
+	std::vector<Gameplay::Physics::SphereCastQuery> _sphereCastQueries;
+	std::vector<Gameplay::Physics::OverlapQuery>    _overlapQueries;
+	std::vector<Gameplay::Physics::QueryHit>        _rayResults;
+	std::vector<Gameplay::Physics::QueryHit>        _sphereCastResults;
+	Gameplay::Physics::OverlapResults               _overlapResults;
+
+	void _ReportOutcome() const;
+};
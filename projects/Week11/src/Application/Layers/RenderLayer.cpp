@@ -193,16 +193,16 @@ void RenderLayer::_AccumulateLighting()
 	// Send in how many active lights we have and the global lighting settings
 	data.AmbientCol = glm::vec3(0.1f);
 	int ix = 0;
-	app.CurrentScene()->Components().Each<Light>([&](const Light::Sptr& light) {
+	app.CurrentScene()->Components().ForEach<Light>([&](Light& light) {
 		// Get the light's position in view space, since we're doing view space lighting
-		glm::vec4 pos = glm::vec4(light->GetGameObject()->GetWorldPosition(), 1.0f);
+		glm::vec4 pos = glm::vec4(light.GetGameObject()->GetWorldPosition(), 1.0f);
 		pos = view * pos;
 
 		// Copy to the ubo data
 		data.Lights[ix].Position = (glm::vec3)(pos) / pos.w;
-		data.Lights[ix].Intensity = light->GetIntensity();
-		data.Lights[ix].Color = light->GetColor();
-		data.Lights[ix].Attenuation = 1.0f / (1.0f + light->GetRadius());  
+		data.Lights[ix].Intensity = light.GetIntensity();
+		data.Lights[ix].Color = light.GetColor();
+		data.Lights[ix].Attenuation = 1.0f / (1.0f + light.GetRadius());  
 
 		ix++;
 
@@ -232,13 +232,13 @@ void RenderLayer::_AccumulateLighting()
 	}
 
 	// Re-render the scene for shadows
-	app.CurrentScene()->Components().Each<ShadowCamera>([&](const ShadowCamera::Sptr& shadowCam) {
+	app.CurrentScene()->Components().ForEach<ShadowCamera>([&](ShadowCamera& shadowCam) {
 		// Bind the shadow camera's depth buffer and clear it
-		shadowCam->GetDepthBuffer()->Bind();
+		shadowCam.GetDepthBuffer()->Bind();
 		glClear(GL_DEPTH_BUFFER_BIT);
-		glViewport(0, 0, shadowCam->GetBufferResolution().x, shadowCam->GetBufferResolution().y);
+		glViewport(0, 0, shadowCam.GetBufferResolution().x, shadowCam.GetBufferResolution().y);
 
-		_RenderScene(shadowCam->GetGameObject()->GetInverseTransform(), shadowCam->GetProjection(), shadowCam->GetDepthBuffer()->GetSize());
+		_RenderScene(shadowCam.GetGameObject()->GetInverseTransform(), shadowCam.GetProjection(), shadowCam.GetDepthBuffer()->GetSize());
 
 		glBindFramebuffer(GL_DRAW_FRAMEBUFFER, 0);
 	});
@@ -260,39 +260,39 @@ void RenderLayer::_AccumulateLighting()
 	_shadowShader->Bind();
 
 	// Add each shadow casting light to the lighting buffers
-	app.CurrentScene()->Components().Each<ShadowCamera>([&](const ShadowCamera::Sptr& shadowCam) {
+	app.CurrentScene()->Components().ForEach<ShadowCamera>([&](ShadowCamera& shadowCam) {
 
 		// This gets us the light -> view space matrix, which we'll inverse to go from view space to light space
-		glm::mat4 lightSpaceMatrix = camera->GetView() * shadowCam->GetGameObject()->GetTransform();
+		glm::mat4 lightSpaceMatrix = camera->GetView() * shadowCam.GetGameObject()->GetTransform();
 
 		// Or we have a matrix to go from view space to shadow space
-		glm::mat4 viewToShadow = shadowCam->GetProjection() * glm::inverse(lightSpaceMatrix);
+		glm::mat4 viewToShadow = shadowCam.GetProjection() * glm::inverse(lightSpaceMatrix);
 
 		// Calculate light's position and direction in view space
 		glm::vec3 lightDirViewSpace = glm::mat3(lightSpaceMatrix) * glm::vec3(0, 0, -1.0f); 
 		glm::vec3 lightPosViewSpace = lightSpaceMatrix * glm::vec4(0.0f, 0.0f, 0.0f, 1.0f);
 
 		// Bind depth and projection mask for reading, making sure not to stomp G-Buffer bindings
-		shadowCam->GetDepthBuffer()->BindAttachment(RenderTargetAttachment::Depth, 5);
-		if (shadowCam->GetProjectionMask() != nullptr) {
-			shadowCam->GetProjectionMask()->Bind(6);
+		shadowCam.GetDepthBuffer()->BindAttachment(RenderTargetAttachment::Depth, 5);
+		if (shadowCam.GetProjectionMask() != nullptr) {
+			shadowCam.GetProjectionMask()->Bind(6);
 		}
 
 		//_shadowShader->SetUniformMatrix("u_ClipToShadow", clipToShadow); 
 		_shadowShader->SetUniformMatrix("u_ViewToShadow", viewToShadow); 
 
 		// Get color and normalize it (strip the alpha)
-		glm::vec4 color = shadowCam->GetColor();
+		glm::vec4 color = shadowCam.GetColor();
 		color *= color.w;
 
 		_shadowShader->SetUniform("u_LightDirViewspace", lightDirViewSpace);
-		_shadowShader->SetUniform("u_ShadowBias", shadowCam->Bias);
-		_shadowShader->SetUniform("u_NormalBias", shadowCam->NormalBias);
-		_shadowShader->SetUniform("u_Attenuation", 1/shadowCam->Range);
-		_shadowShader->SetUniform("u_Intensity", shadowCam->Intensity);
+		_shadowShader->SetUniform("u_ShadowBias", shadowCam.Bias);
+		_shadowShader->SetUniform("u_NormalBias", shadowCam.NormalBias);
+		_shadowShader->SetUniform("u_Attenuation", 1/shadowCam.Range);
+		_shadowShader->SetUniform("u_Intensity", shadowCam.Intensity);
 		_shadowShader->SetUniform("u_LightColor", (glm::vec3)color);
 		_shadowShader->SetUniform("u_LightPosViewspace", lightPosViewSpace);
-		_shadowShader->SetUniform("u_ShadowFlags", *shadowCam->Flags);
+		_shadowShader->SetUniform("u_ShadowFlags", *shadowCam.Flags);
 
 		// Draw the fullscreen quad to accumulate the lights
 		_fullscreenQuad->Draw();
@@ -567,17 +567,17 @@ void RenderLayer::_RenderScene(const glm::mat4& view, const glm::mat4& projectio
 	_frameUniforms->Update();
 
 	// Render all our objects
-	app.CurrentScene()->Components().Each<RenderComponent>([&](const RenderComponent::Sptr& renderable) {
+	app.CurrentScene()->Components().ForEach<RenderComponent>([&](RenderComponent& renderable) {
 		// Early bail if mesh not set
-		if (renderable->GetMesh() == nullptr) {
+		if (renderable.GetMesh() == nullptr) {
 			return;
 		}
 
 		// If we don't have a material, try getting the scene's fallback material
 		// If none exists, do not draw anything
-		if (renderable->GetMaterial() == nullptr) {
+		if (renderable.GetMaterial() == nullptr) {
 			if (defaultMat != nullptr) {
-				renderable->SetMaterial(defaultMat);
+				renderable.SetMaterial(defaultMat);
 			}
 			else {
 				return;
@@ -586,8 +586,8 @@ void RenderLayer::_RenderScene(const glm::mat4& view, const glm::mat4& projectio
 
 		// If the material has changed, we need to bind the new shader and set up our material and frame data
 		// Note: This is a good reason why we should be sorting the render components in ComponentManager
-		if (renderable->GetMaterial() != currentMat) {
-			currentMat = renderable->GetMaterial();
+		if (renderable.GetMaterial() != currentMat) {
+			currentMat = renderable.GetMaterial();
 			shader = currentMat->GetShader();
 
 			shader->Bind();
@@ -595,7 +595,7 @@ void RenderLayer::_RenderScene(const glm::mat4& view, const glm::mat4& projectio
 		}
 
 		// Grab the game object so we can do some stuff with it
-		GameObject* object = renderable->GetGameObject();
+		GameObject* object = renderable.GetGameObject();
 
 		// Use our uniform buffer for our instance level uniforms
 		auto& instanceData = _instanceUniforms->GetData();
@@ -606,7 +606,7 @@ void RenderLayer::_RenderScene(const glm::mat4& view, const glm::mat4& projectio
 		_instanceUniforms->Update();
 
 		// Draw the object
-		renderable->GetMesh()->Draw();
+		renderable.GetMesh()->Draw();
 
 	});
 
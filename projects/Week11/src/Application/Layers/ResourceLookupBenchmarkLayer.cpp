@@ -0,0 +1,64 @@
+#include "ResourceLookupBenchmarkLayer.h"
+#include <chrono>
+#include <vector>
+#include "Utils/ResourceManager/ResourceManager.h"
+#include "Graphics/Textures/Texture2D.h"
+
+// The number of lookups to time for each path
+static const size_t LookupIterations = 1000000;
+
+/**
+ * Looks up each of the IDs in turn until we have done LookupIterations lookups, and returns the
+ * average time per lookup in nanoseconds
+ */
+static double TimeLookups(const std::vector<Guid>& ids, size_t& found) {
+	found = 0;
+	auto start = std::chrono::high_resolution_clock::now();
+	for (size_t ix = 0; ix < LookupIterations; ix++) {
+		if (ResourceManager::Get<Texture2D>(ids[ix % ids.size()]) != nullptr) {
+			found++;
+		}
+	}
+	return std::chrono::duration<double, std::nano>(std::chrono::high_resolution_clock::now() - start).count() / LookupIterations;
+}
+
+ResourceLookupBenchmarkLayer::ResourceLookupBenchmarkLayer()
+	: ApplicationLayer(),
+	_hasRun(false)
+{
+	Name = "Resource Lookup Benchmark";
+	Overrides = AppLayerFunctions::OnSceneLoad;
+}
+
+ResourceLookupBenchmarkLayer::~ResourceLookupBenchmarkLayer()
+{ }
+
+void ResourceLookupBenchmarkLayer::OnSceneLoad() {
+	if (_hasRun) {
+		return;
+	}
+	_hasRun = true;
+
+	// Hits use the textures that are already loaded, misses use random GUIDs that won't be in the manifest
+	std::vector<Guid> hits;
+	ResourceManager::Each<Texture2D>([&](const Texture2D::Sptr& texture) {
+		hits.push_back(texture->GetGUID());
+	});
+	if (hits.empty()) {
+		LOG_WARN("Resource lookup benchmark needs at least one loaded texture, skipping");
+		return;
+	}
+
+	std::vector<Guid> misses;
+	misses.reserve(hits.size());
+	for (size_t ix = 0; ix < hits.size(); ix++) {
+		misses.push_back(Guid::New());
+	}
+
+	size_t hitCount = 0, missCount = 0;
+	double hitNs = TimeLookups(hits, hitCount);
+	double missNs = TimeLookups(misses, missCount);
+	LOG_INFO("Resource lookup benchmark ({} lookups over {} textures):", LookupIterations, hits.size());
+	LOG_INFO("\tHit:  {:.1f}ns average ({} found)", hitNs, hitCount);
+	LOG_INFO("\tMiss: {:.1f}ns average ({} found)", missNs, missCount);
+}
@@ -0,0 +1,23 @@
+#pragma once
+#include "Application/ApplicationLayer.h"
+
+/**
+ * Measures how long ResourceManager::Get takes for resources that exist (hits) and for GUIDs that
+ * do not (misses), using the textures that were loaded with the first scene. The average time per
+ * lookup for each path is logged
+ */
+class ResourceLookupBenchmarkLayer final : public ApplicationLayer {
+public:
+	MAKE_PTRS(ResourceLookupBenchmarkLayer)
+
+	ResourceLookupBenchmarkLayer();
+	virtual ~ResourceLookupBenchmarkLayer();
+
+	// Inherited from ApplicationLayer
+
+	virtual void OnSceneLoad() override;
+
+protected:
+	// We only want to benchmark once, not every time a scene is loaded
+	bool _hasRun;
+};
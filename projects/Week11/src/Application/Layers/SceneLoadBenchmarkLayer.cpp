@@ -0,0 +1,55 @@
+#include "SceneLoadBenchmarkLayer.h"
+#include <chrono>
+#include <filesystem>
+#include "Gameplay/Scene.h"
+#include "Application/Application.h"
+
+// The number of times to load each version of the scene
+static const int LoadIterations = 10;
+
+SceneLoadBenchmarkLayer::SceneLoadBenchmarkLayer()
+	: ApplicationLayer(),
+	_hasRun(false)
+{
+	Name = "Scene Load Benchmark";
+	Overrides = AppLayerFunctions::OnSceneLoad;
+}
+
+SceneLoadBenchmarkLayer::~SceneLoadBenchmarkLayer()
+{ }
+
+void SceneLoadBenchmarkLayer::OnSceneLoad() {
+	if (_hasRun) {
+		return;
+	}
+	_hasRun = true;
+
+	const std::string& jsonPath = Application::Get().CurrentScene()->GetFilePath();
+	if (jsonPath.empty() || Gameplay::Scene::IsBinaryScene(jsonPath)) {
+		LOG_WARN("Scene load benchmark needs a scene that was loaded from JSON, skipping");
+		return;
+	}
+
+	std::string binaryPath = std::filesystem::path(jsonPath).replace_extension("benchmark" + Gameplay::Scene::BinaryExtension).string();
+	if (!Gameplay::Scene::ConvertToBinary(jsonPath, binaryPath)) {
+		return;
+	}
+
+	double jsonMs = _TimeLoad(jsonPath);
+	double binaryMs = _TimeLoad(binaryPath);
+	LOG_INFO("Scene load benchmark ({} iterations):", LoadIterations);
+	LOG_INFO("\tJSON:   {:.2f}ms average, {} bytes", jsonMs, std::filesystem::file_size(jsonPath));
+	LOG_INFO("\tBinary: {:.2f}ms average, {} bytes", binaryMs, std::filesystem::file_size(binaryPath));
+
+	std::filesystem::remove(binaryPath);
+}
+
+double SceneLoadBenchmarkLayer::_TimeLoad(const std::string& path) {
+	double totalMs = 0.0;
+	for (int ix = 0; ix < LoadIterations; ix++) {
+		auto start = std::chrono::high_resolution_clock::now();
+		Gameplay::Scene::Sptr scene = Gameplay::Scene::Load(path);
+		totalMs += std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+	}
+	return totalMs / LoadIterations;
+}
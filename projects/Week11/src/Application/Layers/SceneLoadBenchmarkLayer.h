@@ -0,0 +1,28 @@
+#pragma once
+#include "Application/ApplicationLayer.h"
+
+/**
+ * Compares how long it takes to load the first scene from JSON and from the binary scene format. The
+ * scene is converted to a temporary binary file next to the JSON file, then both are loaded several times
+ * and the average load times and file sizes are logged
+ */
+class SceneLoadBenchmarkLayer final : public ApplicationLayer {
+public:
+	MAKE_PTRS(SceneLoadBenchmarkLayer)
+
+	SceneLoadBenchmarkLayer();
+	virtual ~SceneLoadBenchmarkLayer();
+
+	// Inherited from ApplicationLayer
+
+	virtual void OnSceneLoad() override;
+
+protected:
+	// We only want to benchmark once, not every time a scene is loaded
+	bool _hasRun;
+
+	/**
+	 * Loads the scene at the given path several times, and returns the average load time in milliseconds
+	 */
+	static double _TimeLoad(const std::string& path);
+};
@@ -0,0 +1,151 @@
+#include "TransformBenchmarkLayer.h"
+#include <GLM/gtc/matrix_transform.hpp>
+#include "Gameplay/Scene.h"
+
+// The total number of objects in the benchmark scene
+static const uint32_t ObjectCount = 10000;
+// The depths of the chains to test, the objects are split into ObjectCount / depth chains
+static const uint32_t ChainDepths[] = { 1, 4, 16, 100 };
+// The number of frames to average each update time over
+static const int UpdatePasses = 50;
+// Only every PartialStride'th object moves in the partial update frames
+static const uint32_t PartialStride = 100;
+// The largest (relative) difference we allow between our matrices and the reference ones
+static const float Tolerance = 1e-3f;
+
+/**
+ * Builds an object's local transform the slow way, to check the hierarchy against
+ */
+static glm::mat4 ReferenceLocal(const Gameplay::GameObject& object) {
+	return glm::translate(glm::mat4(1.0f), object.GetPosition()) * glm::mat4_cast(object.GetRotation()) * glm::scale(glm::mat4(1.0f), object.GetScale());
+}
+
+/**
+ * Gets the largest difference between any 2 elements of a pair of matrices, relative to the size of the
+ * element in the reference matrix (deep chains can have large translations and scales)
+ */
+static float MaxDifference(const glm::mat4& a, const glm::mat4& b) {
+	float result = 0.0f;
+	for (int col = 0; col < 4; col++) {
+		for (int row = 0; row < 4; row++) {
+			result = glm::max(result, glm::abs(a[col][row] - b[col][row]) / glm::max(1.0f, glm::abs(b[col][row])));
+		}
+	}
+	return result;
+}
+
+/**
+ * Checks the world transforms of all the objects against ones built by multiplying down each chain. Objects
+ * must be ordered so that each chain is contiguous, starting at it's root
+ */
+static float CheckTransforms(const std::vector<Gameplay::GameObject::Sptr>& objects, uint32_t depth) {
+	float error = 0.0f;
+	glm::mat4 parentWorld = glm::mat4(1.0f);
+	for (size_t ix = 0; ix < objects.size(); ix++) {
+		glm::mat4 world = (ix % depth == 0 ? glm::mat4(1.0f) : parentWorld) * ReferenceLocal(*objects[ix]);
+		error = glm::max(error, MaxDifference(objects[ix]->GetTransform(), world));
+		error = glm::max(error, MaxDifference(objects[ix]->GetInverseTransform(), glm::inverse(world)));
+		parentWorld = world;
+	}
+	return error;
+}
+
+TransformBenchmarkLayer::TransformBenchmarkLayer()
+	: ApplicationLayer(),
+	_hasRun(false)
+{
+	Name = "Transform Benchmark";
+	Overrides = AppLayerFunctions::OnSceneLoad;
+}
+
+TransformBenchmarkLayer::~TransformBenchmarkLayer()
+{ }
+
+void TransformBenchmarkLayer::OnSceneLoad() {
+	if (_hasRun) {
+		return;
+	}
+	_hasRun = true;
+
+	for (uint32_t depth : ChainDepths) {
+		_RunBenchmark(depth);
+	}
+}
+
+void TransformBenchmarkLayer::_RunBenchmark(uint32_t depth) {
+	using namespace Gameplay;
+
+	// We use our own scene so that the benchmark doesn't disturb the one that's loaded. The scene is not
+	// playing, so Update only flushes deleted objects and runs the transform pass
+	Scene::Sptr scene = std::make_shared<Scene>();
+
+	// Build the chains, with small offsets and rotations at every level so that errors would show up. We
+	// don't use rand here, so every run is the same
+	std::vector<GameObject::Sptr> objects;
+	objects.reserve(ObjectCount);
+	for (uint32_t ix = 0; ix < ObjectCount; ix++) {
+		GameObject::Sptr object = scene->CreateGameObject("Transform Benchmark");
+		object->SetPostion(glm::vec3(0.1f, 0.05f * (ix % 7), 0.2f));
+		object->SetRotation(glm::vec3(3.0f * (ix % 5), 2.0f, 7.0f * (ix % 3)));
+		object->SetScale(glm::vec3(1.0f + 0.01f * (ix % 4)));
+		if (ix % depth != 0) {
+			objects.back()->AddChild(object);
+		}
+		objects.push_back(object);
+	}
+	scene->Update(0.0f);
+	float initialError = CheckTransforms(objects, depth);
+
+	// Moving every root dirties every object below it, so the whole hierarchy is recalculated
+	float fullMs = 0.0f, partialMs = 0.0f, cleanMs = 0.0f;
+	for (int pass = 0; pass < UpdatePasses; pass++) {
+		for (uint32_t ix = 0; ix < ObjectCount; ix += depth) {
+			objects[ix]->SetRotation(glm::vec3(0.0f, 0.0f, pass * 5.0f));
+		}
+		scene->Update(0.0f);
+		fullMs += scene->GetLastUpdateTime();
+	}
+	float fullError = CheckTransforms(objects, depth);
+
+	// A few objects anywhere in the chains move, only their subtrees need to be recalculated
+	for (int pass = 0; pass < UpdatePasses; pass++) {
+		for (uint32_t ix = pass % PartialStride; ix < ObjectCount; ix += PartialStride) {
+			objects[ix]->SetPostion(glm::vec3(0.1f, 0.05f * pass, 0.2f));
+		}
+		scene->Update(0.0f);
+		partialMs += scene->GetLastUpdateTime();
+	}
+	float partialError = CheckTransforms(objects, depth);
+
+	// Nothing moves, so every object should be skipped
+	for (int pass = 0; pass < UpdatePasses; pass++) {
+		scene->Update(0.0f);
+		cleanMs += scene->GetLastUpdateTime();
+	}
+
+	// Move the roots and read the leaves straight away, without the per-frame pass. The lazy getters need
+	// to notice that an ancestor several levels up has changed
+	for (uint32_t ix = 0; ix < ObjectCount; ix += depth) {
+		objects[ix]->SetPostion(glm::vec3(-1.0f, 2.0f, 0.5f));
+	}
+	float lazyError = 0.0f;
+	for (uint32_t ix = depth - 1; ix < ObjectCount; ix += depth) {
+		glm::mat4 world = glm::mat4(1.0f);
+		for (uint32_t level = ix + 1 - depth; level <= ix; level++) {
+			world = world * ReferenceLocal(*objects[level]);
+		}
+		lazyError = glm::max(lazyError, MaxDifference(objects[ix]->GetTransform(), world));
+	}
+
+	float maxError = glm::max(glm::max(initialError, fullError), glm::max(partialError, lazyError));
+	LOG_INFO("Transform benchmark ({} objects in chains of {}, {} passes):", ObjectCount, depth, UpdatePasses);
+	LOG_INFO("\tFull update:    {:.3f}ms average", fullMs / UpdatePasses);
+	LOG_INFO("\tPartial update: {:.3f}ms average (1 in {} objects moved)", partialMs / UpdatePasses, PartialStride);
+	LOG_INFO("\tClean update:   {:.3f}ms average", cleanMs / UpdatePasses);
+	if (maxError <= Tolerance) {
+		LOG_INFO("\tAll transforms match the reference (max error {:.2e})", maxError);
+	} else {
+		LOG_WARN("\tTransforms do not match the reference! Max error {:.2e} (initial {:.2e}, full {:.2e}, partial {:.2e}, lazy {:.2e})",
+			maxError, initialError, fullError, partialError, lazyError);
+	}
+}
@@ -0,0 +1,31 @@
+#pragma once
+#include "Application/ApplicationLayer.h"
+
+/**
+ * Measures the scene's transform hierarchy by filling a separate scene with 10k objects, arranged in chains
+ * of several different depths. For each depth, the average time of the per-frame transform pass is logged
+ * for frames where every object moved, where a few objects moved, and where nothing moved.
+ *
+ * Every world transform (and it's inverse) is also checked against one built by multiplying down the chain,
+ * both after the per-frame pass and when read lazily right after a root has moved
+ */
+class TransformBenchmarkLayer final : public ApplicationLayer {
+public:
+	MAKE_PTRS(TransformBenchmarkLayer)
+
+	TransformBenchmarkLayer();
+	virtual ~TransformBenchmarkLayer();
+
+	// Inherited from ApplicationLayer
+
+	virtual void OnSceneLoad() override;
+
+protected:
+	// We only want to benchmark once, not every time a scene is loaded
+	bool _hasRun;
+
+	/**
+	 * Runs the benchmark with chains of the given depth, and logs the results
+	 */
+	static void _RunBenchmark(uint32_t depth);
+};
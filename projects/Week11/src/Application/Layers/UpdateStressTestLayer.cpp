@@ -0,0 +1,98 @@
+#include "UpdateStressTestLayer.h"
+#include "Gameplay/Scene.h"
+#include "Application/Application.h"
+#include "Application/JobSystem.h"
+#include "Gameplay/Components/RotatingBehaviour.h"
+#include "Gameplay/Components/ShipMoveBehaviour.h"
+
+// The number of objects to create along each axis
+static const glm::ivec3 StressGridSize = { 40, 40, 10 };
+// The number of frames to average over before reporting the update time
+static const uint32_t ReportInterval = 300;
+
+UpdateStressTestLayer::UpdateStressTestLayer()
+	: ApplicationLayer(),
+	_objects(std::vector<Gameplay::GameObject::WeakRef>()),
+	_objectGuids(std::vector<Guid>()),
+	_totalUpdateTime(0.0f),
+	_frameCount(0)
+{
+	Name = "Update Stress Test";
+	Overrides = AppLayerFunctions::OnSceneLoad | AppLayerFunctions::OnSceneUnload | AppLayerFunctions::OnUpdate;
+}
+
+UpdateStressTestLayer::~UpdateStressTestLayer()
+{ }
+
+void UpdateStressTestLayer::OnSceneLoad() {
+	Gameplay::Scene::Sptr scene = Application::Get().CurrentScene();
+
+	// Remove any objects that were saved with the scene, we'll re-create them
+	for (const Guid& id : _objectGuids) {
+		Gameplay::GameObject::Sptr object = scene->FindObjectByGUID(id);
+		if (object != nullptr) {
+			scene->RemoveGameObject(object);
+		}
+	}
+	_objectGuids.clear();
+
+	// Create a grid of objects, alternating between our 2 thread safe behaviours so that the
+	// scene has to schedule more than one batch
+	_objects.clear();
+	_objects.reserve(StressGridSize.x * StressGridSize.y * StressGridSize.z);
+	for (int ix = 0; ix < StressGridSize.x; ix++) {
+		for (int iy = 0; iy < StressGridSize.y; iy++) {
+			for (int iz = 0; iz < StressGridSize.z; iz++) {
+				Gameplay::GameObject::Sptr object = scene->CreateGameObject("Stress Test");
+				object->SetPostion({ ix * 2.0f, iy * 2.0f, iz * 2.0f });
+				object->HideInHierarchy = true;
+
+				if ((ix + iy + iz) % 2 == 0) {
+					object->Add<RotatingBehaviour>()->RotationSpeed = {
+						(rand() / (float)RAND_MAX) * 90.0f,
+						0,
+						(rand() / (float)RAND_MAX) * 90.0f
+					};
+				} else {
+					ShipMoveBehaviour::Sptr mover = object->Add<ShipMoveBehaviour>();
+					mover->Center = object->GetPosition();
+					mover->Radius = 1.0f;
+				}
+				_objects.push_back(object);
+			}
+		}
+	}
+
+	_totalUpdateTime = 0.0f;
+	_frameCount = 0;
+	LOG_INFO("Created {} objects for update stress test", _objects.size());
+}
+
+void UpdateStressTestLayer::OnSceneUnload() {
+	_objectGuids.clear();
+	_objectGuids.reserve(_objects.size());
+	for (const auto& object : _objects) {
+		_objectGuids.push_back(object);
+	}
+	_objects.clear();
+}
+
+void UpdateStressTestLayer::OnUpdate() {
+	Gameplay::Scene::Sptr scene = Application::Get().CurrentScene();
+
+	// Components only update while playing, so there's nothing to measure otherwise
+	if (!scene->IsPlaying) {
+		return;
+	}
+
+	_totalUpdateTime += scene->GetLastUpdateTime();
+	_frameCount++;
+
+	if (_frameCount >= ReportInterval) {
+		uint32_t threads = JobSystem::IsInitialized() ? JobSystem::Get().ThreadCount() : 1;
+		LOG_INFO("Scene update: {:.3f}ms average over {} frames ({} objects, {} threads)", 
+			_totalUpdateTime / _frameCount, _frameCount, _objects.size(), threads);
+		_totalUpdateTime = 0.0f;
+		_frameCount = 0;
+	}
+}
@@ -0,0 +1,33 @@
+#pragma once
+#include "Application/ApplicationLayer.h"
+#include <json.hpp>
+#include "Gameplay/GameObject.h"
+
+/**
+ * Fills the scene with a large number of objects with thread safe behaviours, and periodically
+ * logs how long the scene update takes. Combined with the worker_threads app setting, this lets
+ * us see how the parallel component update scales with the number of threads
+ */
+class UpdateStressTestLayer final : public ApplicationLayer {
+public:
+	MAKE_PTRS(UpdateStressTestLayer)
+
+	UpdateStressTestLayer();
+	virtual ~UpdateStressTestLayer();
+
+	// Inherited from ApplicationLayer
+
+	virtual void OnSceneLoad() override;
+	virtual void OnSceneUnload() override;
+	virtual void OnUpdate() override;
+
+protected:
+	std::vector<Gameplay::GameObject::WeakRef> _objects;
+	// Handles are only valid within a single scene, so we remember the object IDs when
+	// the scene unloads in case the next scene was saved with the objects in it
+	std::vector<Guid> _objectGuids;
+
+	// The total update time (in ms) and number of frames since we last reported
+	float    _totalUpdateTime;
+	uint32_t _frameCount;
+};
@@ -2,6 +2,7 @@
 #include "Application/Application.h"
 #include "Application/ApplicationLayer.h"
 #include "Application/Layers/RenderLayer.h"
+#include "Utils/ResourceManager/ResourceManager.h"
 
 DebugWindow::DebugWindow() :
 	IEditorWindow()
@@ -24,6 +25,22 @@ void DebugWindow::RenderMenuBar()
 		app.CurrentScene()->SetPhysicsDebugDrawMode(physicsDrawMode);
 	}
 
+	ImGui::Separator();
+
+	// Show how much memory our resources are using, and how close we are to the budget
+	const ResourceManager::MemoryStats& stats = ResourceManager::GetMemoryStats();
+	const float toMb = 1.0f / (1024.0f * 1024.0f);
+	ImGui::Text("Resources: %u loaded, %u evicted", stats.ResidentCount, stats.EvictedCount);
+	ImGui::Text("CPU: %.1f MB  GPU: %.1f MB", stats.CpuBytes * toMb, stats.GpuBytes * toMb);
+	if (stats.BudgetBytes > 0) {
+		size_t total = stats.CpuBytes + stats.GpuBytes;
+		char label[64];
+		snprintf(label, sizeof(label), "%.1f / %.1f MB", total * toMb, stats.BudgetBytes * toMb);
+		ImGui::ProgressBar(static_cast<float>(total) / static_cast<float>(stats.BudgetBytes), ImVec2(200.0f, 0.0f), label);
+	} else {
+		ImGui::Text("No resource budget");
+	}
+
 	/*ImGui::Separator();
 
 	RenderFlags flags = renderLayer->GetRenderFlags();
@@ -37,7 +37,9 @@ void InspectorWindow::Render()
 		ImGui::Separator();
 
 		// Render position label
-		selection->_isLocalTransformDirty |= LABEL_LEFT(ImGui::DragFloat3, "Position", &selection->_position.x, 0.01f);
+		if (LABEL_LEFT(ImGui::DragFloat3, "Position", &selection->_position.x, 0.01f)) {
+			selection->_OnTransformChanged();
+		}
 
 		// Get the ImGui storage state so we can avoid gimbal locking issues by storing euler angles in the editor
 		glm::vec3 euler = selection->GetRotationEuler();
@@ -63,7 +65,9 @@ void InspectorWindow::Render()
 		}
 
 		// Draw the scale
-		selection->_isLocalTransformDirty |= LABEL_LEFT(ImGui::DragFloat3, "Scale   ", &selection->_scale.x, 0.01f, 0.0f);
+		if (LABEL_LEFT(ImGui::DragFloat3, "Scale   ", &selection->_scale.x, 0.01f, 0.0f)) {
+			selection->_OnTransformChanged();
+		}
 
 		// For if we're not in play mode
 		selection->_RecalcLocalTransform(); 
@@ -76,7 +80,7 @@ void InspectorWindow::Render()
 			std::shared_ptr<Gameplay::IComponent> component = selection->_components[ix];
 
 			if (_RenderComponent(component)) {
-				selection->_components.erase(selection->_components.begin() + ix);
+				selection->_RemoveComponentAt(ix);
 				ix--;
 			}
 		}
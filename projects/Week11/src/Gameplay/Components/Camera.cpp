@@ -5,6 +5,9 @@
 #include "Utils/GlmDefines.h"
 #include "Gameplay/GameObject.h"
 #include "Utils/ImGuiHelper.h"
+#include "Utils/CerealGlmHelpers.h"
+
+#include <cereal/archives/binary.hpp>
 
 namespace Gameplay {
 	void Camera::RenderImGui()
@@ -55,6 +58,19 @@ namespace Gameplay {
 		return result;
 	}
 
+	void Camera::ToBinary(cereal::BinaryOutputArchive& archive) const
+	{
+		archive(_nearPlane, _farPlane, _fovRadians, _orthoVerticalScale, _isOrtho, _clearColor);
+	}
+
+	Camera::Sptr Camera::FromBinary(cereal::BinaryInputArchive& archive)
+	{
+		Camera::Sptr result = Camera::Create();
+		archive(result->_nearPlane, result->_farPlane, result->_fovRadians, result->_orthoVerticalScale, result->_isOrtho, result->_clearColor);
+		result->_isProjectionDirty = true;
+		return result;
+	}
+
 	Camera::Camera() :
 		_nearPlane(0.1f),
 		_farPlane(1000.0f),
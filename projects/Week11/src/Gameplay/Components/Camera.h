@@ -29,6 +29,8 @@ namespace Gameplay {
 
 		virtual nlohmann::json ToJson() const override;
 		static Camera::Sptr FromJson(const nlohmann::json& data);
+		void ToBinary(cereal::BinaryOutputArchive& archive) const;
+		static Camera::Sptr FromBinary(cereal::BinaryInputArchive& archive);
 
 
 	public:
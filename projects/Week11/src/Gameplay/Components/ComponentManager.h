@@ -1,8 +1,11 @@
 #pragma once
 #include <functional>
+#include <algorithm>
 #include "IComponent.h"
 #include <typeindex>
+#include <unordered_map>
 #include <optional>
+#include <vector>
 #include <Logging.h>
 
 namespace Gameplay {
@@ -15,9 +18,19 @@ namespace Gameplay {
 	public:
 		typedef std::function<IComponent::Sptr(const nlohmann::json&)> LoadComponentFunc;
 		typedef std::function<IComponent::Sptr()> CreateComponentFunc;
+		typedef std::function<IComponent::Sptr(cereal::BinaryInputArchive&)> LoadBinaryComponentFunc;
+		typedef std::function<void(const IComponent&, cereal::BinaryOutputArchive&, std::vector<Guid>*)> SaveBinaryComponentFunc;
+		typedef std::function<nlohmann::json(cereal::BinaryInputArchive&)> BinaryToJsonComponentFunc;
+
+		// The maximum number of component types that may be registered, since gameobjects track their
+		// components with a 64 bit mask
+		static constexpr uint32_t MaxComponentTypes = 64;
+		// The type ID returned for types that have not been registered
+		static constexpr uint32_t InvalidTypeId = ~0u;
 
 		inline void Clear() {
 			_Components.clear();
+			_ComponentsByGuid.clear();
 		}
 
 		/// <summary>
@@ -29,28 +42,104 @@ namespace Gameplay {
 		/// <param name="blob">The JSON blob to decode</param>
 		/// <returns>The component as decoded from the JSON data, or nullptr</returns>
 		inline IComponent::Sptr Load(const std::string& typeName, const nlohmann::json& blob) {
-			// Try and get the type index from the name
-			std::optional<std::type_index> typeIndex = _TypeNameMap[typeName];
+			IComponent::Sptr result = Construct(typeName, blob);
+			if (result != nullptr) {
+				// Add the component to the global pools
+				_AddToPool(result.get());
+			}
+			return result;
+		}
 
-			// If we have a value for type index, this component type was registered!
-			if (typeIndex.has_value()) {
-				// Get the load callback and make sure it exists
-				LoadComponentFunc callback = _TypeLoadRegistry[typeIndex.value()];
-				if (callback) {
-					// Invoke the loader, also load additional component data
-					IComponent::Sptr result = callback(blob);
-					IComponent::LoadBaseJson(result, blob);
+		/// <summary>
+		/// Loads a component with the given type name from a JSON blob, without adding it to the pools
+		/// (see Add). This does not modify the component manager, so it may be used from worker threads
+		/// If the type name does not correspond to a registered type, will return nullptr
+		/// </summary>
+		/// <param name="typeName">The name of the type to load (taken from GetComponentTypeName of component)</param>
+		/// <param name="blob">The JSON blob to decode</param>
+		/// <returns>The component as decoded from the JSON data, or nullptr</returns>
+		static IComponent::Sptr Construct(const std::string& typeName, const nlohmann::json& blob) {
+			// Try and get the type ID from the name, if we have one this component type was registered!
+			uint32_t typeId = GetTypeId(typeName);
+			if (typeId == InvalidTypeId) {
+				return nullptr;
+			}
 
-					// Make sure the component knows it's own type
-					result->_realType = typeIndex.value();
-					result->_weakSelfPtr = result;
+			// Get the load callback and make sure it exists
+			auto callback = _TypeLoadRegistry.find(_TypeIdList[typeId]);
+			if (callback == _TypeLoadRegistry.end() || !callback->second) {
+				return nullptr;
+			}
 
-					// Add the component to the global pools
-					_Components[result->_realType].push_back(result);
-					return result;
-				}
+			// Invoke the loader, also load additional component data
+			IComponent::Sptr result = callback->second(blob);
+			IComponent::LoadBaseJson(result, blob);
+
+			// Make sure the component knows it's own type
+			result->_realType = _TypeIdList[typeId];
+			result->_typeId = typeId;
+			result->_weakSelfPtr = result;
+			return result;
+		}
+
+		/// <summary>
+		/// Loads a component of the given type from a binary archive, as written by SaveBinary, without
+		/// adding it to the pools (see Add). This does not modify the component manager, so it may be used
+		/// from worker threads
+		/// If the type ID does not correspond to a registered type, will return nullptr without reading anything
+		/// </summary>
+		/// <param name="typeId">The dense ID of the type to load, as returned by GetTypeId</param>
+		/// <param name="archive">The archive to read the component from</param>
+		/// <returns>The component as decoded from the archive, or nullptr</returns>
+		static IComponent::Sptr ConstructBinary(uint32_t typeId, cereal::BinaryInputArchive& archive) {
+			if (typeId >= _TypeBinaryLoadRegistry.size() || !_TypeBinaryLoadRegistry[typeId]) {
+				return nullptr;
 			}
-			return nullptr;
+
+			IComponent::Sptr result = _TypeBinaryLoadRegistry[typeId](archive);
+			IComponent::LoadBaseBinary(result, archive);
+
+			// Make sure the component knows it's own type
+			result->_realType = _TypeIdList[typeId];
+			result->_typeId = typeId;
+			result->_weakSelfPtr = result;
+			return result;
+		}
+
+		/// <summary>
+		/// Reads a component from a binary archive, as written by SaveBinary, and returns the JSON data that
+		/// GameObject::ToJson would store for it. This does not use the component manager or the resource
+		/// manager, so it may be used from worker threads while the main thread keeps running
+		/// </summary>
+		/// <param name="typeId">The dense ID of the type to read, as returned by GetTypeId</param>
+		/// <param name="archive">The archive to read the component from</param>
+		static nlohmann::json BinaryToJson(uint32_t typeId, cereal::BinaryInputArchive& archive) {
+			LOG_ASSERT(typeId < _TypeBinaryToJsonRegistry.size(), "Component type has not been registered!");
+
+			nlohmann::json result = _TypeBinaryToJsonRegistry[typeId](archive);
+			IComponent::LoadBaseBinaryAsJson(archive, result);
+			return result;
+		}
+
+		/// <summary>
+		/// Adds a component that was made with Construct or ConstructBinary to the global pools
+		/// </summary>
+		/// <param name="component">The component to add</param>
+		inline void Add(const IComponent::Sptr& component) {
+			_AddToPool(component.get());
+		}
+
+		/// <summary>
+		/// Writes a component to a binary archive, using the type's own binary serializers if it
+		/// has them, or it's JSON data if it does not
+		/// </summary>
+		/// <param name="component">The component to save</param>
+		/// <param name="archive">The archive to write the component to</param>
+		/// <param name="dependencies">If not null, the GUIDs of the resources the component uses are appended to this list</param>
+		static void SaveBinary(const IComponent& component, cereal::BinaryOutputArchive& archive, std::vector<Guid>* dependencies = nullptr) {
+			LOG_ASSERT(component._typeId < _TypeBinarySaveRegistry.size(), "Component type has not been registered!");
+			_TypeBinarySaveRegistry[component._typeId](component, archive, dependencies);
+			IComponent::SaveBaseBinary(component, archive);
 		}
 
 		/// <summary>
@@ -73,9 +162,10 @@ namespace Gameplay {
 					IComponent::Sptr result = callback();
 					// Make sure the component knows it's own type
 					result->_realType = typeIndex.value();
+					result->_typeId = GetTypeId(typeIndex.value());
 					result->_weakSelfPtr = result;
 					// Add the component to the global pools
-					_Components[result->_realType].push_back(result);
+					_AddToPool(result.get());
 					return result;
 				}
 			}
@@ -100,9 +190,10 @@ namespace Gameplay {
 				IComponent::Sptr result = callback();
 				// Make sure the component knows it's own type
 				result->_realType = type;
+				result->_typeId = GetTypeId(type);
 				result->_weakSelfPtr = result;
 				// Add the component to the global pools
-				_Components[result->_realType].push_back(result);
+				_AddToPool(result.get());
 				return result;
 			}
 			return nullptr;
@@ -140,11 +231,12 @@ namespace Gameplay {
 
 			// Make sure the component knows it's concrete type
 			component->_realType = type;
+			component->_typeId = _TypeIdOf<ComponentType>;
 			// Give the component a weak pointer to itself that it can upcast to a shared pointer when needed
 			component->_weakSelfPtr = component;
 
 			// Add to global component list for that type
-			_Components[type].push_back(component);
+			_AddToPool(component.get());
 
 			// Return the result
 			return component;
@@ -165,28 +257,22 @@ namespace Gameplay {
 			std::type_index type = std::type_index(typeid(ComponentType));
 			LOG_ASSERT(_TypeLoadRegistry[type] != nullptr, "You must register component types before creating them!");
 
-			// Clear any dead weak pointers
-			auto removeIt = std::remove_if(_Components[type].begin(), _Components[type].end(), [](const std::weak_ptr<IComponent>& ptr) {
-				return ptr.expired();
-			});
-			_Components[type].erase(removeIt, _Components[type].end());
-
-			// Search the component store for a component that matches that ID
-			auto& it = std::find_if(_Components[type].begin(), _Components[type].end(), [&](const std::weak_ptr<IComponent>& ptr) {
-				return (ptr.lock())->GetGUID() == id;
-			});
-
-			// If the component was found, return it. Otherwise return nullptr
-			if (it != _Components[type].end()) {
-				// We need to lock the weak pointer to convert it to a shared ptr
-				return std::dynamic_pointer_cast<ComponentType>((*it).lock());
-			} else {
-				return nullptr;
+			// Look up the component in our GUID index, and make sure it's actually of the type requested
+			auto it = _ComponentsByGuid.find(id);
+			if (it != _ComponentsByGuid.end() && it->second->_realType == type) {
+				// We need to lock the weak pointer to convert it to a shared ptr, since we've checked the
+				// concrete type we know that the static cast is safe
+				return std::static_pointer_cast<ComponentType>(it->second->_weakSelfPtr.lock());
 			}
+
+			// The component was not found
+			return nullptr;
 		}
 
 		/// <summary>
 		/// Iterates over all components of the given type and invokes a method with them
+		/// For per-frame iteration, prefer ForEach. The same rules for modifying components during
+		/// iteration apply (see ForEach)
 		/// </summary>
 		/// <typeparam name="ComponentType">The type of component to iterate on</typeparam>
 		/// <param name="callback">The callback to invoke with the components</param>
@@ -199,18 +285,152 @@ namespace Gameplay {
 			std::type_index type = std::type_index(typeid(ComponentType));
 			LOG_ASSERT(_TypeLoadRegistry[type] != nullptr, "You must register component types before creating them!");
 
-			// Iterate over all the components in the store
-			for (auto& wptr : _Components[type]) {
-				// Lock the weak pointer to get a shared pointer (maybe)
-				std::shared_ptr<IComponent> sptr = wptr.lock();
-				// If the pointer is alive and matches our enabled criteria, invoke the callback
-				if (sptr && sptr->IsEnabled | includeDisabled) {
-					// Upcast to component type and invoke the callback
-					callback(std::dynamic_pointer_cast<ComponentType>(sptr));
+			// Grab the pool for the type, if there's no pool then there's nothing to iterate
+			auto it = _Components.find(type);
+			if (it == _Components.end()) {
+				return;
+			}
+
+			// Iterate over all the components in the store. We use indices here since callbacks may add
+			// new components to the pool, which could invalidate our iterators
+			ComponentPool& pool = it->second;
+			_BeginIteration();
+			for (size_t ix = 0; ix < pool.size(); ix++) {
+				IComponent* component = pool[ix];
+				// If the component matches our enabled criteria, invoke the callback (removed components leave a null slot)
+				if (component != nullptr && (component->IsEnabled | includeDisabled)) {
+					// Pools only store a single concrete type, so we can static cast back to the component type
+					callback(std::static_pointer_cast<ComponentType>(component->_weakSelfPtr.lock()));
+				}
+			}
+			_EndIteration();
+		}
+
+		/// <summary>
+		/// Iterates over all components of the given type and invokes a callable with a reference to each. Unlike
+		/// Each, this does not copy a shared pointer or go through std::function per component, so the callback
+		/// can be inlined. This should be preferred for any per-frame iteration
+		///
+		/// Callbacks may add components (they are visited by this walk as well) and destroy components other than
+		/// the one they were given. Components that are destroyed during the walk leave an empty slot that is skipped,
+		/// and the pools are compacted once the outermost walk finishes. Since we don't hold a reference to the
+		/// components, a callback must never destroy the component it was given (use Scene::RemoveGameObject, which
+		/// defers deletion, or keep a shared pointer to it until the callback returns)
+		/// </summary>
+		/// <typeparam name="ComponentType">The type of component to iterate on</typeparam>
+		/// <typeparam name="Fn">The callable type, should accept a ComponentType&</typeparam>
+		/// <param name="callback">The callable to invoke with the components</param>
+		/// <param name="includeDisabled">True to include disabled components, false if otherwise</param>
+		template <
+			typename ComponentType,
+			typename Fn,
+			typename = typename std::enable_if<std::is_base_of<IComponent, ComponentType>::value>::type>
+		void ForEach(Fn&& callback, bool includeDisabled = false) {
+			ComponentPool* pool = _GetPool<ComponentType>();
+			if (pool == nullptr) {
+				return;
+			}
+
+			// Use indices since callbacks may add new components to the pool
+			_BeginIteration();
+			for (size_t ix = 0; ix < pool->size(); ix++) {
+				IComponent* component = (*pool)[ix];
+				if (component != nullptr && (component->IsEnabled | includeDisabled)) {
+					callback(*static_cast<ComponentType*>(component));
+				}
+			}
+			_EndIteration();
+		}
+
+		/// <summary>
+		/// Invokes a callable for the components in the range [begin, end) of the pool for the given type. Combined 
+		/// with Count, this lets callers split iteration into chunks (for instance to spread work across threads).
+		/// Note that components must not be added or removed while ranges are being processed
+		/// </summary>
+		/// <typeparam name="ComponentType">The type of component to iterate on</typeparam>
+		/// <typeparam name="Fn">The callable type, should accept a ComponentType&</typeparam>
+		/// <param name="begin">The index of the first component to process</param>
+		/// <param name="end">One past the index of the last component to process, will be clamped to the pool size</param>
+		/// <param name="callback">The callable to invoke with the components</param>
+		/// <param name="includeDisabled">True to include disabled components, false if otherwise</param>
+		template <
+			typename ComponentType,
+			typename Fn,
+			typename = typename std::enable_if<std::is_base_of<IComponent, ComponentType>::value>::type>
+		void ForEachInRange(size_t begin, size_t end, Fn&& callback, bool includeDisabled = false) {
+			ComponentPool* pool = _GetPool<ComponentType>();
+			if (pool == nullptr) {
+				return;
+			}
+
+			end = std::min(end, pool->size());
+			for (size_t ix = begin; ix < end; ix++) {
+				IComponent* component = (*pool)[ix];
+				if (component != nullptr && (component->IsEnabled | includeDisabled)) {
+					callback(*static_cast<ComponentType*>(component));
 				}
 			}
 		}
 
+		/// <summary>
+		/// Gets the number of components of the given type (including disabled components), for use with
+		/// ForEachInRange
+		/// </summary>
+		/// <typeparam name="ComponentType">The type of component to count</typeparam>
+		template <
+			typename ComponentType,
+			typename = typename std::enable_if<std::is_base_of<IComponent, ComponentType>::value>::type>
+		size_t Count() {
+			ComponentPool* pool = _GetPool<ComponentType>();
+			return pool != nullptr ? pool->size() : 0;
+		}
+
+		/// <summary>
+		/// Gets the dense integer ID that was assigned to a component type when it was registered, or
+		/// InvalidTypeId if the type has not been registered
+		/// </summary>
+		/// <typeparam name="ComponentType">The type of component to get the ID for</typeparam>
+		template <typename ComponentType>
+		static uint32_t GetTypeId() {
+			return _TypeIdOf<ComponentType>;
+		}
+
+		/// <summary>
+		/// Gets the dense integer ID that was assigned to a component type when it was registered, or
+		/// InvalidTypeId if the type has not been registered
+		/// </summary>
+		/// <param name="type">The type of component to get the ID for</param>
+		static uint32_t GetTypeId(const std::type_index& type) {
+			auto it = _TypeIdMap.find(type);
+			return it != _TypeIdMap.end() ? it->second : InvalidTypeId;
+		}
+
+		/// <summary>
+		/// Gets the dense integer ID that was assigned to the component type with the given name, or
+		/// InvalidTypeId if no type with that name has been registered
+		/// </summary>
+		/// <param name="typeName">The name of the type (taken from GetComponentTypeName of component)</param>
+		static uint32_t GetTypeId(const std::string& typeName) {
+			auto it = _TypeNameMap.find(typeName);
+			return it != _TypeNameMap.end() && it->second.has_value() ? GetTypeId(it->second.value()) : InvalidTypeId;
+		}
+
+		/// <summary>
+		/// Gets the name of the type that was assigned the given dense ID
+		/// </summary>
+		/// <param name="typeId">The dense type ID, as returned by GetTypeId</param>
+		static const std::string& GetTypeName(uint32_t typeId) {
+			LOG_ASSERT(typeId < _TypeNameList.size(), "Component type has not been registered!");
+			return _TypeNameList[typeId];
+		}
+
+		/// <summary>
+		/// Gets the number of component types that have been registered
+		/// </summary>
+		static uint32_t TypeCount() {
+			return static_cast<uint32_t>(_TypeIdList.size());
+		}
+
 		/// <summary>
 		/// Attempts to register a given type as a component, should be called for each component type 
 		/// at the start of you application
@@ -231,14 +451,108 @@ namespace Gameplay {
 				_TypeLoadRegistry[type] = &ComponentManager::ParseTypeFromBlob<T>;
 				_TypeCreateRegistry[type] = &ComponentManager::_InternalCreate<T>;
 				_TypeNameMap[StringTools::SanitizeClassName(typeid(T).name())] = type;
+
+				// Assign the type the next dense ID, used by gameobjects to quickly find components
+				LOG_ASSERT(_TypeIdMap.size() < MaxComponentTypes, "Too many component types registered!");
+				uint32_t id = static_cast<uint32_t>(_TypeIdMap.size());
+				_TypeIdMap[type] = id;
+				_TypeIdOf<T> = id;
+				_TypeIdList.push_back(type);
+				_TypeNameList.push_back(StringTools::SanitizeClassName(typeid(T).name()));
+
+				// Types without their own binary serializers fall back to storing their JSON data
+				if constexpr (has_binary_serializers<T>()) {
+					static_assert(!has_dependency_getter<T>() || has_binary_to_json<T>(), "Component types with resource dependencies must define BinaryToJson!");
+					_TypeBinaryLoadRegistry.push_back(&ComponentManager::_ParseTypeFromBinary<T>);
+					_TypeBinarySaveRegistry.push_back(&ComponentManager::_SaveTypeToBinary<T>);
+					_TypeBinaryToJsonRegistry.push_back(&ComponentManager::_BinaryTypeToJson<T>);
+				} else {
+					_TypeBinaryLoadRegistry.push_back(&ComponentManager::_ParseTypeFromJsonBinary<T>);
+					_TypeBinarySaveRegistry.push_back(&IComponent::SaveJsonBinary);
+					_TypeBinaryToJsonRegistry.push_back(&IComponent::LoadJsonBinary);
+				}
+
+				// Store how the type's update may be scheduled, and make sure the batches get rebuilt
+				_TypeUpdateTraits.push_back(get_update_traits<T>());
+				_IsUpdateScheduleDirty = true;
+			}
+		}
+
+		/// <summary>
+		/// Gets the update traits that were declared by the type with the given ID
+		/// </summary>
+		/// <param name="typeId">The dense type ID, as returned by GetTypeId</param>
+		static const ComponentUpdateTraits& GetUpdateTraits(uint32_t typeId) {
+			LOG_ASSERT(typeId < _TypeUpdateTraits.size(), "Component type has not been registered!");
+			return _TypeUpdateTraits[typeId];
+		}
+
+		/// <summary>
+		/// Gets the component types with thread safe updates, grouped into batches that can each be
+		/// updated in parallel. Types that write to one another (or that both write transforms) are always placed into different batches.
+		/// Batches (and the types within them) are in registration order, so the schedule is deterministic
+		/// </summary>
+		/// <returns>A list of batches, where each batch is a list of type IDs</returns>
+		static const std::vector<std::vector<uint32_t>>& GetParallelUpdateBatches() {
+			if (_IsUpdateScheduleDirty) {
+				_RebuildUpdateSchedule();
 			}
+			return _ParallelUpdateBatches;
+		}
+
+		/// <summary>
+		/// Gets the number of components of the given type (including disabled components), for use with
+		/// ForEachInRange
+		/// </summary>
+		/// <param name="type">The type of component to count</param>
+		size_t Count(const std::type_index& type) {
+			auto it = _Components.find(type);
+			return it != _Components.end() ? it->second.size() : 0;
+		}
+
+		/// <summary>
+		/// Invokes a callable for the components in the range [begin, end) of the pool for the given type, for
+		/// when the type is only known at runtime. Note that components must not be added or removed while ranges
+		/// are being processed
+		/// </summary>
+		/// <typeparam name="Fn">The callable type, should accept an IComponent&</typeparam>
+		/// <param name="type">The type of component to iterate on</param>
+		/// <param name="begin">The index of the first component to process</param>
+		/// <param name="end">One past the index of the last component to process, will be clamped to the pool size</param>
+		/// <param name="callback">The callable to invoke with the components</param>
+		/// <param name="includeDisabled">True to include disabled components, false if otherwise</param>
+		template <typename Fn>
+		void ForEachInRange(const std::type_index& type, size_t begin, size_t end, Fn&& callback, bool includeDisabled = false) {
+			auto it = _Components.find(type);
+			if (it == _Components.end()) {
+				return;
+			}
+
+			ComponentPool& pool = it->second;
+			end = std::min(end, pool.size());
+			for (size_t ix = begin; ix < end; ix++) {
+				IComponent* component = pool[ix];
+				if (component != nullptr && (component->IsEnabled | includeDisabled)) {
+					callback(*component);
+				}
+			}
+		}
+
+		/// <summary>
+		/// Gets the type that was assigned the given dense ID
+		/// </summary>
+		/// <param name="typeId">The dense type ID, as returned by GetTypeId</param>
+		static const std::type_index& GetTypeFromId(uint32_t typeId) {
+			LOG_ASSERT(typeId < _TypeIdList.size(), "Component type has not been registered!");
+			return _TypeIdList[typeId];
 		}
 
 		/// <summary>
 		/// Removes all components of all types from the registry, whether they are referenced elsewhere or not
 		/// </summary>
 		inline void FlushAll() {
-			_Components = std::unordered_map<std::type_index, std::vector<std::weak_ptr<IComponent>>>();
+			_Components = std::unordered_map<std::type_index, ComponentPool>();
+			_ComponentsByGuid = std::unordered_map<Guid, IComponent*>();
 		}
 
 	private:
@@ -253,17 +567,74 @@ namespace Gameplay {
 		inline static std::unordered_map<std::type_index, LoadComponentFunc> _TypeLoadRegistry;
 		// Stores functions to load components from JSON, indexed on the type that they load
 		inline static std::unordered_map<std::type_index, CreateComponentFunc> _TypeCreateRegistry;
-
-		// Weak pointers let us store a reference to an object stored by a shared pointer, without
-		// actually increasing the reference count. Thus components will be destroyed at the correct
-		// time (when the only reference is the one stored here).
-		std::unordered_map<std::type_index, std::vector<std::weak_ptr<IComponent>>> _Components;  
+		// Maps types to the dense ID they were assigned on registration
+		inline static std::unordered_map<std::type_index, uint32_t> _TypeIdMap;
+		// Per-type storage for the dense type ID, so that templated lookups don't need to hash the type
+		template <typename T>
+		inline static uint32_t _TypeIdOf = InvalidTypeId;
+		// Maps dense type IDs back to their types
+		inline static std::vector<std::type_index> _TypeIdList;
+		// Maps dense type IDs back to their type names
+		inline static std::vector<std::string> _TypeNameList;
+		// Stores functions to load and save components in binary archives, indexed by type ID
+		inline static std::vector<LoadBinaryComponentFunc> _TypeBinaryLoadRegistry;
+		inline static std::vector<SaveBinaryComponentFunc> _TypeBinarySaveRegistry;
+		inline static std::vector<BinaryToJsonComponentFunc> _TypeBinaryToJsonRegistry;
+		// The update traits declared by each type, indexed by type ID
+		inline static std::vector<ComponentUpdateTraits> _TypeUpdateTraits;
+		// Thread safe types grouped into batches that can run in parallel, see GetParallelUpdateBatches
+		inline static std::vector<std::vector<uint32_t>> _ParallelUpdateBatches;
+		inline static bool _IsUpdateScheduleDirty = false;
+
+		// Each pool stores raw pointers to all live components of a single concrete type, packed densely so
+		// that iteration is a linear walk with no locking or casting. Components are still owned by their
+		// gameobjects, and remove themselves from their pool in the IComponent destructor. Each component
+		// stores it's index into the pool, so removal is a swap-and-pop instead of a search
+		typedef std::vector<IComponent*> ComponentPool;
+		std::unordered_map<std::type_index, ComponentPool> _Components;
+		// The number of Each and ForEach walks in progress. While walking, removed components are replaced with
+		// null rather than swapped out, so that components don't move around under the walk
+		uint32_t _iterationDepth = 0;
+		// Set when components were removed during a walk, and the pools need to be compacted
+		bool     _hasEmptySlots = false;
+		// Maps component GUIDs to the live component with that ID, so that cross references can be resolved
+		// without searching the pools
+		std::unordered_map<Guid, IComponent*> _ComponentsByGuid;
 
 		template <typename T>
 		static IComponent::Sptr ParseTypeFromBlob(const nlohmann::json& blob) {
 			return T::FromJson(blob);
 		}
 
+		template <typename T>
+		static IComponent::Sptr _ParseTypeFromBinary(cereal::BinaryInputArchive& archive) {
+			return T::FromBinary(archive);
+		}
+
+		template <typename T>
+		static void _SaveTypeToBinary(const IComponent& component, cereal::BinaryOutputArchive& archive, std::vector<Guid>* dependencies) {
+			static_cast<const T&>(component).ToBinary(archive);
+			if constexpr (has_dependency_getter<T>()) {
+				if (dependencies != nullptr) {
+					static_cast<const T&>(component).GetDependencies(*dependencies);
+				}
+			}
+		}
+
+		template <typename T>
+		static nlohmann::json _BinaryTypeToJson(cereal::BinaryInputArchive& archive) {
+			if constexpr (has_binary_to_json<T>()) {
+				return T::BinaryToJson(archive);
+			} else {
+				return T::FromBinary(archive)->ToJson();
+			}
+		}
+
+		template <typename T>
+		static IComponent::Sptr _ParseTypeFromJsonBinary(cereal::BinaryInputArchive& archive) {
+			return T::FromJson(IComponent::LoadJsonBinary(archive));
+		}
+
 		template <typename ComponentType>
 		static IComponent::Sptr _InternalCreate() {
 			// We can use typeid and type_index to get a unique ID for our types
@@ -275,6 +646,7 @@ namespace Gameplay {
 
 			// Make sure the component knows it's concrete type
 			component->_realType = type;
+			component->_typeId = _TypeIdOf<ComponentType>;
 			// Give the component a weak pointer to itself that it can upcast to a shared pointer when needed
 			component->_weakSelfPtr = component;
 
@@ -291,20 +663,117 @@ namespace Gameplay {
 		inline void Remove(const IComponent* component) {
 			if (_Components.size() == 0) return;
 
-			// Make sure the component's type was one that was registered
-			LOG_ASSERT(_TypeLoadRegistry[component->_realType] != nullptr, "You must register component types before creating them!");
+			// Find the pool for the component's type, if it does not exist there's nothing to remove
+			auto it = _Components.find(component->_realType);
+			if (it == _Components.end()) return;
+
+			// Make sure the component is actually stored in this pool (it may have been flushed)
+			ComponentPool& pool = it->second;
+			size_t index = component->_poolIndex;
+			if (index >= pool.size() || pool[index] != component) return;
+
+			// If we're in the middle of a walk we leave an empty slot, and compact the pool when the walk is done
+			if (_iterationDepth > 0) {
+				pool[index] = nullptr;
+				_hasEmptySlots = true;
+			}
+			// Otherwise swap the last element into the removed slot, then pop the back of the pool
+			else {
+				IComponent* last = pool.back();
+				pool[index] = last;
+				last->_poolIndex = index;
+				pool.pop_back();
+			}
+
+			// Drop the component from the GUID index, making sure we don't remove a different component
+			// that happens to share the ID
+			auto guidIt = _ComponentsByGuid.find(component->GetGUID());
+			if (guidIt != _ComponentsByGuid.end() && guidIt->second == component) {
+				_ComponentsByGuid.erase(guidIt);
+			}
+		}
+
+		/// <summary>
+		/// Groups the thread safe component types into batches, greedily placing each type in the first batch
+		/// that does not contain a type that it writes to, that writes to it, or that also writes transforms
+		/// </summary>
+		static void _RebuildUpdateSchedule() {
+			_ParallelUpdateBatches.clear();
+			for (uint32_t id = 0; id < _TypeUpdateTraits.size(); id++) {
+				if (!_TypeUpdateTraits[id].IsThreadSafe) continue;
+
+				auto conflicts = [id](uint32_t other) {
+					const std::vector<std::type_index>& ourWrites = _TypeUpdateTraits[id].Writes;
+					const std::vector<std::type_index>& theirWrites = _TypeUpdateTraits[other].Writes;
+					if (_TypeUpdateTraits[id].WritesTransform && _TypeUpdateTraits[other].WritesTransform) {
+						return true;
+					}
+					return std::find(ourWrites.begin(), ourWrites.end(), _TypeIdList[other]) != ourWrites.end() ||
+						std::find(theirWrites.begin(), theirWrites.end(), _TypeIdList[id]) != theirWrites.end();
+				};
+
+				bool placed = false;
+				for (std::vector<uint32_t>& batch : _ParallelUpdateBatches) {
+					if (std::none_of(batch.begin(), batch.end(), conflicts)) {
+						batch.push_back(id);
+						placed = true;
+						break;
+					}
+				}
+				if (!placed) {
+					_ParallelUpdateBatches.push_back({ id });
+				}
+			}
+			_IsUpdateScheduleDirty = false;
+		}
 
-			
-			// Get a reference to the vector of components for easy access
-			std::vector<std::weak_ptr<IComponent>>& componentStore = _Components[component->_realType];
+		/// <summary>
+		/// Marks the start of a walk over a pool, see ForEach
+		/// </summary>
+		inline void _BeginIteration() {
+			_iterationDepth++;
+		}
 
-			// Clear any dead weak pointers
-			auto it = std::remove_if(componentStore.begin(), componentStore.end(), [](const std::weak_ptr<IComponent>& ptr) {
-				return ptr.expired();
-				});
-			if (it != componentStore.end()) {
-				componentStore.erase(it);
+		/// <summary>
+		/// Marks the end of a walk over a pool, and removes any empty slots left by components that were
+		/// destroyed during the walk once the outermost walk is done
+		/// </summary>
+		inline void _EndIteration() {
+			_iterationDepth--;
+			if (_iterationDepth > 0 || !_hasEmptySlots) return;
+
+			for (auto& [type, pool] : _Components) {
+				size_t count = 0;
+				for (IComponent* component : pool) {
+					if (component != nullptr) {
+						component->_poolIndex = count;
+						pool[count++] = component;
+					}
+				}
+				pool.resize(count);
 			}
+			_hasEmptySlots = false;
+		}
+
+		/// <summary>
+		/// Gets the pool for the given component type, or nullptr if no components of that type exist
+		/// </summary>
+		template <typename ComponentType>
+		ComponentPool* _GetPool() {
+			auto it = _Components.find(std::type_index(typeid(ComponentType)));
+			return it != _Components.end() ? &it->second : nullptr;
+		}
+
+		/// <summary>
+		/// Appends a component to the pool for it's concrete type, and stores the pool index in the
+		/// component so that it can be removed quickly. Also adds the component to the GUID index
+		/// </summary>
+		/// <param name="component">The component to add, it's real type and GUID must already be set</param>
+		inline void _AddToPool(IComponent* component) {
+			ComponentPool& pool = _Components[component->_realType];
+			component->_poolIndex = pool.size();
+			pool.push_back(component);
+			_ComponentsByGuid[component->GetGUID()] = component;
 		}
 	};
 }
\ No newline at end of file
@@ -3,6 +3,9 @@
 #include "Gameplay/GameObject.h"
 #include "Gameplay/Scene.h"
 
+#include <cereal/archives/binary.hpp>
+#include <cereal/types/vector.hpp>
+
 namespace Gameplay {
 	GameObject* IComponent::GetGameObject() const {
 		return _context;
@@ -24,14 +27,58 @@ namespace Gameplay {
 		data["enabled"] = instance->IsEnabled;
 	}
 
+	void IComponent::LoadBaseBinary(const Sptr& result, cereal::BinaryInputArchive& archive)
+	{
+		Guid guid;
+		archive(guid, result->IsEnabled);
+		result->OverrideGUID(guid);
+	}
+
+	void IComponent::SaveBaseBinary(const IComponent& instance, cereal::BinaryOutputArchive& archive)
+	{
+		archive(instance.GetGUID(), instance.IsEnabled);
+	}
+
+	void IComponent::LoadBaseBinaryAsJson(cereal::BinaryInputArchive& archive, nlohmann::json& data)
+	{
+		Guid guid;
+		bool enabled = true;
+		archive(guid, enabled);
+		data["guid"] = guid.str();
+		data["enabled"] = enabled;
+	}
+
+	nlohmann::json IComponent::LoadJsonBinary(cereal::BinaryInputArchive& archive)
+	{
+		std::vector<uint8_t> data;
+		archive(data);
+		return nlohmann::json::from_msgpack(data);
+	}
+
+	void IComponent::SaveJsonBinary(const IComponent& instance, cereal::BinaryOutputArchive& archive, std::vector<Guid>* dependencies)
+	{
+		nlohmann::json data = instance.ToJson();
+		// We already have the JSON, so we can search it for resources the same way JSON scenes do
+		if (dependencies != nullptr) {
+			std::vector<Guid> found = ResourceManager::FindDependencies(data);
+			dependencies->insert(dependencies->end(), found.begin(), found.end());
+		}
+		archive(nlohmann::json::to_msgpack(data));
+	}
+
 	IComponent::IComponent() :
 		IResource(),
 		IsEnabled(true),
 		_realType(typeid(IComponent)),
-		_context(nullptr)
+		_typeId(ComponentManager::InvalidTypeId),
+		_context(nullptr),
+		_poolIndex(0)
 	{ }
 
 	IComponent::~IComponent() {
-		_context->GetScene()->Components().Remove(this);
+		// Components that were loaded but never attached (ex: prefab templates) are not in any pools
+		if (_context != nullptr) {
+			_context->GetScene()->Components().Remove(this);
+		}
 	}
 }
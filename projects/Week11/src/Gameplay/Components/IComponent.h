@@ -1,5 +1,7 @@
 #pragma once
 #include <memory>
+#include <vector>
+#include <typeindex>
 #include "json.hpp"
 #include <imgui.h>
 #include <GLM/glm.hpp>
@@ -9,6 +11,12 @@
 #include "Utils/ResourceManager/IResource.h"
 #include "Utils/TypeHelpers.h"
 
+// We pre-declare the cereal archives so that only the files that serialize binary data need the headers
+namespace cereal {
+	class BinaryOutputArchive;
+	class BinaryInputArchive;
+}
+
 namespace Gameplay {
 	// We pre-declare GameObject to avoid circular dependencies in the headers
 	class GameObject;
@@ -18,6 +26,34 @@ namespace Gameplay {
 		class RigidBody;
 	}
 
+	/// <summary>
+	/// Describes how a component type's Update may be scheduled. Component types can provide
+	/// these by defining a static method as such:
+	/// 
+	/// static ComponentUpdateTraits GetUpdateTraits();
+	/// 
+	/// Types that do not define it are updated serially, in scene order
+	/// </summary>
+	struct ComponentUpdateTraits {
+		/// <summary>
+		/// True if Update may run on a worker thread, at the same time as other components. A thread
+		/// safe Update may only modify it's own component and the position, rotation and scale of it's
+		/// gameobject (see WritesTransform). It must not read world transforms, touch other gameobjects, create or destroy
+		/// objects or components, or call into physics or rendering
+		/// </summary>
+		bool IsThreadSafe = false;
+		/// <summary>
+		/// True if Update modifies the position, rotation or scale of it's gameobject. Types that write the
+		/// transform are never updated at the same time as each other, since they may share a gameobject
+		/// </summary>
+		bool WritesTransform = false;
+		/// <summary>
+		/// The other component types that Update modifies, types that write to each other will never
+		/// be updated at the same time
+		/// </summary>
+		std::vector<std::type_index> Writes;
+	};
+
 	/// <summary>
 	/// Base class for components that can be attached to game objects
 	/// 
@@ -27,6 +63,29 @@ namespace Gameplay {
 	/// static std::shared_ptr<Type> FromJson(const nlohmann::json&);
 	/// 
 	/// where Type is the Type of component
+	/// 
+	/// Components that are common in scenes may also define the following to be stored 
+	/// natively in binary scene files:
+	/// 
+	/// void ToBinary(cereal::BinaryOutputArchive&) const;
+	/// static std::shared_ptr<Type> FromBinary(cereal::BinaryInputArchive&);
+	/// 
+	/// Types that do not define them are stored in binary scenes as their JSON data. Types with binary
+	/// serializers that reference resources should also define:
+	/// 
+	/// void GetDependencies(std::vector<Guid>&) const;
+	/// 
+	/// which appends the GUIDs of those resources, so that binary scenes know what to preload. Since
+	/// background saves convert binary data to JSON without touching the resource manager, these types
+	/// must also define:
+	/// 
+	/// static nlohmann::json BinaryToJson(cereal::BinaryInputArchive&);
+	/// 
+	/// which reads the data written by ToBinary and returns what ToJson would have. Other types are
+	/// converted by loading them with FromBinary and calling ToJson
+	/// 
+	/// Scenes are loaded on worker threads, so FromJson and FromBinary should only construct the component
+	/// (looking up resources is fine). Anything that touches the scene or OpenGL belongs in OnLoad or Awake
 	/// </summary>
 	class IComponent : public IResource {
 	public:
@@ -161,7 +220,11 @@ namespace Gameplay {
 		friend class GameObject;
 
 		std::type_index _realType;
+		// The dense type ID assigned by the component manager
+		uint32_t _typeId;
 		GameObject* _context;
+		// Our index in the component manager's pool for our type
+		size_t _poolIndex;
 
 		// By storing a weak pointer to ourselves, we can pass a pointer to this
 		// for things like bullet user pointers
@@ -169,6 +232,16 @@ namespace Gameplay {
 
 		static void LoadBaseJson(const IComponent::Sptr& result, const nlohmann::json& blob);
 		static void SaveBaseJson(const IComponent::Sptr& instance, nlohmann::json& data);
+		static void LoadBaseBinary(const IComponent::Sptr& result, cereal::BinaryInputArchive& archive);
+		static void SaveBaseBinary(const IComponent& instance, cereal::BinaryOutputArchive& archive);
+		static void LoadBaseBinaryAsJson(cereal::BinaryInputArchive& archive, nlohmann::json& data);
+
+		/// <summary>
+		/// Fallbacks for component types that do not have binary serializers, these store the
+		/// component's JSON data as MessagePack
+		/// </summary>
+		static nlohmann::json LoadJsonBinary(cereal::BinaryInputArchive& archive);
+		static void SaveJsonBinary(const IComponent& instance, cereal::BinaryOutputArchive& archive, std::vector<Guid>* dependencies);
 	};
 
 	/// <summary>
@@ -179,6 +252,47 @@ namespace Gameplay {
 	constexpr bool is_valid_component() {
 		return std::is_base_of<IComponent, T>::value && test_json<T, const nlohmann::json&>::value;
 	}
+
+	/// <summary>
+	/// Returns true if the given component type defines it's own binary serializers
+	/// </summary>
+	/// <typeparam name="T">The type to check</typeparam>
+	template <typename T>
+	constexpr bool has_binary_serializers() {
+		return test_binary<T, cereal::BinaryInputArchive&>::value;
+	}
+
+	/// <summary>
+	/// Returns true if the given component type can list the resources it depends on
+	/// </summary>
+	/// <typeparam name="T">The type to check</typeparam>
+	template <typename T>
+	constexpr bool has_dependency_getter() {
+		return test_dependencies<T, std::vector<Guid>&>::value;
+	}
+
+	/// <summary>
+	/// Returns true if the given component type can convert it's binary data to JSON without being loaded
+	/// </summary>
+	/// <typeparam name="T">The type to check</typeparam>
+	template <typename T>
+	constexpr bool has_binary_to_json() {
+		return test_binary_to_json<T, cereal::BinaryInputArchive&>::value;
+	}
+
+	/// <summary>
+	/// Gets the update traits for a component type, or the default (serial) traits if the type does
+	/// not define GetUpdateTraits
+	/// </summary>
+	/// <typeparam name="T">The type to get the traits for</typeparam>
+	template <typename T>
+	ComponentUpdateTraits get_update_traits() {
+		if constexpr (test_update_traits<T>::value) {
+			return T::GetUpdateTraits();
+		} else {
+			return ComponentUpdateTraits();
+		}
+	}
 }
 
 // Defines the ComponentTypeName interface to match those used elsewhere by other systems
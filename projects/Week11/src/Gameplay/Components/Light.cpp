@@ -1,6 +1,9 @@
 #include "Light.h"
 #include "Utils/JsonGlmHelpers.h"
 #include "Utils/ImGuiHelper.h"
+#include "Utils/CerealGlmHelpers.h"
+
+#include <cereal/archives/binary.hpp>
 
 Light::Light() : 
 	Gameplay::IComponent(),
@@ -92,6 +95,18 @@ inline nlohmann::json Light::ToJson() const {
 	};
 }
 
+void Light::ToBinary(cereal::BinaryOutputArchive& archive) const {
+	archive(_color, _radius, _direction, _params, static_cast<int>(_type), _intensity);
+}
+
+Light::Sptr Light::FromBinary(cereal::BinaryInputArchive& archive) {
+	Light::Sptr result = std::make_shared<Light>();
+	int type = 0;
+	archive(result->_color, result->_radius, result->_direction, result->_params, type, result->_intensity);
+	result->_type = static_cast<LightType>(type);
+	return result;
+}
+
 void Light::RenderImGui()
 {
 	LABEL_LEFT(ImGui::ColorPicker3, "    Color", &_color.x);
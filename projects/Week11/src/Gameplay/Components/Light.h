@@ -45,6 +45,8 @@ public:
 	MAKE_TYPENAME(Light);
 	virtual nlohmann::json ToJson() const override;
 	static Light::Sptr FromJson(const nlohmann::json& blob);
+	void ToBinary(cereal::BinaryOutputArchive& archive) const;
+	static Light::Sptr FromBinary(cereal::BinaryInputArchive& archive);
 
 protected:
 	LightType _type;
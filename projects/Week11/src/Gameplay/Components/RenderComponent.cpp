@@ -3,6 +3,8 @@
 #include "Utils/ResourceManager/ResourceManager.h"
 #include "Utils/ImGuiHelper.h"
 
+#include <cereal/archives/binary.hpp>
+
 
 RenderComponent::RenderComponent(const Gameplay::MeshResource::Sptr& mesh, const Gameplay::Material::Sptr& material) :
 	_mesh(mesh), 
@@ -53,6 +55,40 @@ RenderComponent::Sptr RenderComponent::FromJson(const nlohmann::json& data) {
 	return result;
 }
 
+void RenderComponent::ToBinary(cereal::BinaryOutputArchive& archive) const {
+	archive(
+		_mesh ? _mesh->GetGUID() : Guid(),
+		_material ? _material->GetGUID() : Guid()
+	);
+}
+
+void RenderComponent::GetDependencies(std::vector<Guid>& result) const {
+	if (_mesh != nullptr) {
+		result.push_back(_mesh->GetGUID());
+	}
+	if (_material != nullptr) {
+		result.push_back(_material->GetGUID());
+	}
+}
+
+nlohmann::json RenderComponent::BinaryToJson(cereal::BinaryInputArchive& archive) {
+	Guid mesh, material;
+	archive(mesh, material);
+	nlohmann::json result;
+	result["mesh"] = mesh.isValid() ? mesh.str() : "null";
+	result["material"] = material.isValid() ? material.str() : "null";
+	return result;
+}
+
+RenderComponent::Sptr RenderComponent::FromBinary(cereal::BinaryInputArchive& archive) {
+	RenderComponent::Sptr result = std::make_shared<RenderComponent>();
+	Guid mesh, material;
+	archive(mesh, material);
+	result->_mesh = ResourceManager::Get<Gameplay::MeshResource>(mesh);
+	result->_material = ResourceManager::Get<Gameplay::Material>(material);
+	return result;
+}
+
 void RenderComponent::RenderImGui() {
 	ImGui::Text("Indexed:   %s", GetMesh() != nullptr ? (_mesh->Mesh->GetIndexBuffer() != nullptr ? "true" : "false") : "N/A");
 	ImGui::Text("Triangles: %d", GetMesh() != nullptr ? (_mesh->Mesh->GetElementCount() / 3) : 0);
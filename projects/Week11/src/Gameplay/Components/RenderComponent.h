@@ -47,6 +47,10 @@ public:
 	virtual void RenderImGui() override;
 	virtual nlohmann::json ToJson() const override;
 	static RenderComponent::Sptr FromJson(const nlohmann::json& data);
+	void ToBinary(cereal::BinaryOutputArchive& archive) const;
+	static RenderComponent::Sptr FromBinary(cereal::BinaryInputArchive& archive);
+	void GetDependencies(std::vector<Guid>& result) const;
+	static nlohmann::json BinaryToJson(cereal::BinaryInputArchive& archive);
 	MAKE_TYPENAME(RenderComponent);
 
 protected:
@@ -4,6 +4,16 @@
 
 #include "Utils/ImGuiHelper.h"
 #include "Utils/JsonGlmHelpers.h"
+#include "Utils/CerealGlmHelpers.h"
+
+#include <cereal/archives/binary.hpp>
+
+Gameplay::ComponentUpdateTraits RotatingBehaviour::GetUpdateTraits() {
+	Gameplay::ComponentUpdateTraits result;
+	result.IsThreadSafe = true;
+	result.WritesTransform = true;
+	return result;
+}
 
 void RotatingBehaviour::Update(float deltaTime) {
 	GetGameObject()->SetRotation(GetGameObject()->GetRotationEuler() + RotationSpeed * deltaTime);
@@ -24,3 +34,13 @@ RotatingBehaviour::Sptr RotatingBehaviour::FromJson(const nlohmann::json& data)
 	result->RotationSpeed = JsonGet(data, "speed", result->RotationSpeed);
 	return result;
 }
+
+void RotatingBehaviour::ToBinary(cereal::BinaryOutputArchive& archive) const {
+	archive(RotationSpeed);
+}
+
+RotatingBehaviour::Sptr RotatingBehaviour::FromBinary(cereal::BinaryInputArchive& archive) {
+	RotatingBehaviour::Sptr result = std::make_shared<RotatingBehaviour>();
+	archive(result->RotationSpeed);
+	return result;
+}
@@ -13,10 +13,17 @@ public:
 
 	virtual void Update(float deltaTime) override;
 
+	/// <summary>
+	/// Update only sets our gameobject's transform, so it can safely be run in parallel
+	/// </summary>
+	static Gameplay::ComponentUpdateTraits GetUpdateTraits();
+
 	virtual void RenderImGui() override;
 
 	virtual nlohmann::json ToJson() const override;
 	static RotatingBehaviour::Sptr FromJson(const nlohmann::json& data);
+	void ToBinary(cereal::BinaryOutputArchive& archive) const;
+	static RotatingBehaviour::Sptr FromBinary(cereal::BinaryInputArchive& archive);
 
 	MAKE_TYPENAME(RotatingBehaviour);
 };
@@ -46,6 +46,13 @@ ShipMoveBehaviour::Sptr ShipMoveBehaviour::FromJson(const nlohmann::json & blob)
 	return result;
 }
 
+Gameplay::ComponentUpdateTraits ShipMoveBehaviour::GetUpdateTraits() {
+	Gameplay::ComponentUpdateTraits result;
+	result.IsThreadSafe = true;
+	result.WritesTransform = true;
+	return result;
+}
+
 void ShipMoveBehaviour::Update(float deltaTime) {
 
 	glm::vec3 pos = Center + glm::vec3(
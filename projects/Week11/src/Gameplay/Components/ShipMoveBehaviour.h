@@ -21,6 +21,11 @@ public:
 
 	virtual void Update(float deltaTime) override;
 
+	/// <summary>
+	/// Update only sets our gameobject's transform, so it can safely be run in parallel
+	/// </summary>
+	static Gameplay::ComponentUpdateTraits GetUpdateTraits();
+
 public:
 	virtual void RenderImGui() override;
 	MAKE_TYPENAME(ShipMoveBehaviour);
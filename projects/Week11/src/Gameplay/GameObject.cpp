@@ -2,6 +2,11 @@
 
 // Utilities
 #include "Utils/JsonGlmHelpers.h"
+#include "Utils/CerealGlmHelpers.h"
+
+// Cereal
+#include <cereal/archives/binary.hpp>
+#include <cereal/types/string.hpp>
 
 // GLM
 #define GLM_ENABLE_EXPERIMENTAL
@@ -12,75 +17,70 @@
 #include "Utils/ImGuiHelper.h"
 
 #include "Gameplay/Scene.h"
+#include "Gameplay/Prefab.h"
+#include "Gameplay/Physics/RigidBody.h"
+#include "Gameplay/Physics/TriggerVolume.h"
 
 namespace Gameplay {
 	GameObject::GameObject() :
 		IResource(),
 		Name("Unknown"),
 		HideInHierarchy(false),
+		_prefab(nullptr),
+		_prefabIndex(0),
 		_components(std::vector<IComponent::Sptr>()),
+		_componentMask(0),
+		_componentSlots(),
 		_scene(nullptr),
+		_slotIndex(0),
+		_slotGeneration(0),
 		_position(ZERO),
 		_rotation(glm::quat(glm::vec3(0.0f))),
 		_scale(ONE),
-		_localTransform(MAT4_IDENTITY),
-		_inverseLocalTransform(MAT4_IDENTITY),
 		_isLocalTransformDirty(true),
-		_worldTransform(MAT4_IDENTITY),
-		_inverseWorldTransform(MAT4_IDENTITY),
-		_isWorldTransformDirty(true),
+		_transformVersion(0),
 		_parent(WeakRef()),
 		_children(std::vector<WeakRef>())
 	{ }
 
 	void GameObject::_RecalcLocalTransform() const
 	{
-		if (_isLocalTransformDirty) {
-			_localTransform = glm::translate(MAT4_IDENTITY, _position) * glm::mat4_cast(_rotation) * glm::scale(MAT4_IDENTITY, _scale);
-			_inverseLocalTransform = glm::inverse(_localTransform);
-			_isLocalTransformDirty = false;
-			_isWorldTransformDirty = true;
-
-			// Dirty all the child objects world transforms
-			for (const auto& childPtr : _children) {
-				GameObject::Sptr childSptr = childPtr;
-				if (childSptr != nullptr) {
-					childSptr->_isWorldTransformDirty = true;
-				}
-			}
-		}
+		_scene->_transforms.GetLocal(this, _slotIndex);
 	}
 
 	void GameObject::_RecalcWorldTransform() const {
-		// Start by determining our local transform if required
-		_RecalcLocalTransform();
-
-		// If our world transform has been marked as dirty, we need to recalculate it!
-		if (_isWorldTransformDirty) {
-			GameObject::Sptr parent = _parent;
-
-			// If out parent exists, we apply our local transformation relative to the parent's world transformation
-			if (parent != nullptr) {
-				_worldTransform = parent->GetTransform() * _localTransform;
-				_inverseWorldTransform = glm::inverse(_worldTransform);
-			}
-
-			// If our parent is null, we can simply use the local transform as the world transform
-			else {
-				_worldTransform = _localTransform;
-				_inverseWorldTransform = _inverseLocalTransform;
-			}
-			_isWorldTransformDirty = false;
-		}
+		_scene->_transforms.GetWorld(this, _slotIndex);
 	}
 
 	void GameObject::_PurgeDeletedChildren() {
-		auto it = std::remove_if(_children.begin(), _children.end(), [](WeakRef child) { 
-			return child == nullptr; 
+		auto it = std::remove_if(_children.begin(), _children.end(), [](const WeakRef& child) { 
+			return !child.IsAlive(); 
 		});
 		_children.erase(it, _children.end());
 	}
 
+	void GameObject::_AttachComponent(const IComponent::Sptr& component) {
+		uint32_t id = component->_typeId;
+		LOG_ASSERT(id < ComponentManager::MaxComponentTypes, "Component type has not been registered!");
+
+		component->_context = this;
+		_componentSlots[id] = static_cast<uint8_t>(_components.size());
+		_componentMask |= 1ull << id;
+		_components.push_back(component);
+	}
+
+	void GameObject::_RemoveComponentAt(size_t index) {
+		_components.erase(_components.begin() + index);
+
+		// Erasing shifts the components after the index, so we rebuild the slots
+		_componentMask = 0;
+		for (size_t ix = 0; ix < _components.size(); ix++) {
+			uint32_t id = _components[ix]->_typeId;
+			_componentSlots[id] = static_cast<uint8_t>(ix);
+			_componentMask |= 1ull << id;
+		}
+	}
+
 	void GameObject::LookAt(const glm::vec3& point) {
 		glm::mat4 rot = glm::lookAt(_position, point, glm::vec3(0.0f, 0.0f, 1.0f));
 		// Take the conjugate of the quaternion, as lookAt returns the *inverse* rotation
@@ -113,7 +113,19 @@ namespace Gameplay {
 
 	void GameObject::SetPostion(const glm::vec3& position) {
 		_position = position;
+		_OnTransformChanged();
+	}
+
+	void GameObject::_OnTransformChanged() {
 		_isLocalTransformDirty = true;
+		_transformVersion++;
+
+		// Physics bodies are only pre-stepped when something has changed, so they need to know that we've moved
+		for (uint32_t typeId : { ComponentManager::GetTypeId<Physics::RigidBody>(), ComponentManager::GetTypeId<Physics::TriggerVolume>() }) {
+			if (_HasTypeId(typeId)) {
+				static_cast<Physics::PhysicsBase*>(_components[_componentSlots[typeId]].get())->_MarkPhysicsDirty();
+			}
+		}
 	}
 
 	const glm::vec3& GameObject::GetPosition() const {
@@ -126,7 +138,7 @@ namespace Gameplay {
 
 	void GameObject::SetRotation(const glm::quat& value) {
 		_rotation = value;
-		_isLocalTransformDirty = true;
+		_OnTransformChanged();
 	}
 
 	const glm::quat& GameObject::GetRotation() const {
@@ -135,7 +147,7 @@ namespace Gameplay {
 
 	void GameObject::SetRotation(const glm::vec3& eulerAngles) {
 		_rotation = glm::quat(glm::radians(eulerAngles));
-		_isLocalTransformDirty = true;
+		_OnTransformChanged();
 	}
 
 	glm::vec3 GameObject::GetRotationEuler() const {
@@ -144,7 +156,7 @@ namespace Gameplay {
 
 	void GameObject::SetScale(const glm::vec3& value) {
 		_scale = value;
-		_isLocalTransformDirty = true;
+		_OnTransformChanged();
 	}
 
 	const glm::vec3& GameObject::GetScale() const {
@@ -152,24 +164,20 @@ namespace Gameplay {
 	}
 
 	const glm::mat4& GameObject::GetTransform() const {
-		_RecalcWorldTransform();
-		return _worldTransform;
+		return _scene->_transforms.GetWorld(this, _slotIndex);
 	}
 
 	const glm::mat4& GameObject::GetInverseTransform() const {
-		_RecalcWorldTransform();
-		return _inverseWorldTransform;
+		return _scene->_transforms.GetInverseWorld(this, _slotIndex);
 	}
 
 	const glm::mat4& GameObject::GetLocalTransform() const
 	{
-		_RecalcLocalTransform();
-		return _localTransform;
+		return _scene->_transforms.GetLocal(this, _slotIndex);
 	}
 
 	const glm::mat4& GameObject::GetInverseLocalTransform() const {
-		_RecalcLocalTransform();
-		return _inverseLocalTransform;
+		return _scene->_transforms.GetInverseLocal(this, _slotIndex);
 	}
 
 	void GameObject::RenderGUI() {
@@ -190,7 +198,7 @@ namespace Gameplay {
 			}
 		}
 		for (auto& child : _children) {
-			child->RenderGUI();
+			child.Get()->RenderGUI();
 		}
 		for (auto& component : _components) {
 			if (component->IsEnabled) {
@@ -199,6 +207,10 @@ namespace Gameplay {
 		}
 	}
 
+	const std::shared_ptr<const Prefab>& GameObject::GetPrefab() const {
+		return _prefab;
+	}
+
 	Scene* GameObject::GetScene() const {
 		return _scene;
 	}
@@ -211,37 +223,23 @@ namespace Gameplay {
 
 	void GameObject::Update(float dt) {
 		for (auto& component : _components) {
-			if (component->IsEnabled) {
+			// Thread safe components are updated in parallel by the scene
+			if (component->IsEnabled && !ComponentManager::GetUpdateTraits(component->_typeId).IsThreadSafe) {
 				component->Update(dt);
 			}
 		}
 
-		_RecalcLocalTransform();
-		_RecalcWorldTransform();
 		_PurgeDeletedChildren();
 	}
 
 	bool GameObject::Has(const std::type_index& type) {
-		// Iterate over all the pointers in the components list
-		for (const auto& ptr : _components) {
-			// If the pointer type matches T, we return true
-			if (std::type_index(typeid(*ptr.get())) == type) {
-				return true;
-			}
-		}
-		return false;
+		return _HasTypeId(ComponentManager::GetTypeId(type));
 	}
 
 	std::shared_ptr<IComponent> GameObject::Get(const std::type_index& type)
 	{
-		// Iterate over all the pointers in the binding list
-		for (const auto& ptr : _components) {
-			// If the pointer type matches T, we return that behaviour, making sure to cast it back to the requested type
-			if (std::type_index(typeid(*ptr.get())) == type) {
-				return ptr;
-			}
-		}
-		return nullptr;
+		uint32_t id = ComponentManager::GetTypeId(type);
+		return _HasTypeId(id) ? _components[_componentSlots[id]] : nullptr;
 	}
 
 	std::shared_ptr<IComponent> GameObject::Add(const std::type_index& type)
@@ -254,7 +252,7 @@ namespace Gameplay {
 		component->_context = this;
 
 		// Append it to the binding component's storage, and invoke the OnLoad
-		_components.push_back(component);
+		_AttachComponent(component);
 		component->OnLoad();
 
 		if (_scene->GetIsAwake()) {
@@ -266,12 +264,13 @@ namespace Gameplay {
 
 	void GameObject::AddChild(const GameObject::Sptr& child) {
 		// If the object already has a parent, remove it from the other object
-		if (child->_parent != nullptr) {
-			child->_parent->RemoveChild(child);
+		GameObject* oldParent = child->_parent.Get();
+		if (oldParent != nullptr) {
+			oldParent->RemoveChild(child);
 		}
 
 		// Make sure the object isn't already a child of this object
-		auto it = std::find_if(_children.begin(), _children.end(), [child](GameObject::WeakRef wPtr) { return wPtr == child;});
+		auto it = std::find_if(_children.begin(), _children.end(), [&child](GameObject::WeakRef& wPtr) { return wPtr == child;});
 
 		// As long as the child is not already a child of this gameobject, add it
 		if (it == _children.end()) {
@@ -279,7 +278,7 @@ namespace Gameplay {
 			// applies to the child
 			_children.push_back(child);
 			child->_parent = _selfRef.lock();
-			child->_isWorldTransformDirty = true;
+			_scene->_transforms.SetParent(child.get(), child->_slotIndex, _slotIndex);
 		} else {
 			LOG_WARN("Attempting to add same child twice, ignoring: {}", child->Name);
 		}
@@ -287,11 +286,12 @@ namespace Gameplay {
 
 	bool GameObject::RemoveChild(const GameObject::Sptr& child) {
 		// Find the child in our list of children if it exists
-		auto it = std::find_if(_children.begin(), _children.end(), [child](GameObject::WeakRef wPtr) { return wPtr == child; });
+		auto it = std::find_if(_children.begin(), _children.end(), [&child](GameObject::WeakRef& wPtr) { return wPtr == child; });
 		
 		if (it != _children.end()) { 
 			// Clear the object's parent and remove from our list of children
 			child->_parent.Reset();
+			_scene->_transforms.SetParent(child.get(), child->_slotIndex, TransformHierarchy::NoParent);
 			_children.erase(it);
 			return true;
 		} else {
@@ -354,7 +354,9 @@ namespace Gameplay {
 			}
 
 			// Render position label
-			_isLocalTransformDirty |= LABEL_LEFT(ImGui::DragFloat3, "Position", &_position.x, 0.01f);
+			if (LABEL_LEFT(ImGui::DragFloat3, "Position", &_position.x, 0.01f)) {
+				_OnTransformChanged();
+			}
 			
 			// Get the ImGui storage state so we can avoid gimbal locking issues by storing euler angles in the editor
 			glm::vec3 euler = GetRotationEuler();
@@ -380,7 +382,9 @@ namespace Gameplay {
 			}
 			
 			// Draw the scale
-			_isLocalTransformDirty |= LABEL_LEFT(ImGui::DragFloat3, "Scale   ", &_scale.x, 0.01f, 0.0f);
+			if (LABEL_LEFT(ImGui::DragFloat3, "Scale   ", &_scale.x, 0.01f, 0.0f)) {
+				_OnTransformChanged();
+			}
 
 			ImGui::Separator();
 			ImGui::TextUnformatted("Components");
@@ -394,7 +398,7 @@ namespace Gameplay {
 					component->RenderImGui();
 					// Render a delete button for the component
 					if (ImGuiHelper::WarningButton("Delete")) {
-						_components.erase(_components.begin() + ix);
+						_RemoveComponentAt(ix);
 						ix--;
 					}
 					ImGui::PopID();
@@ -449,43 +453,61 @@ namespace Gameplay {
 	}
 
 	GameObject::Sptr GameObject::FromJson(Scene* scene, const nlohmann::json& data)
+	{
+		GameObject::Sptr result = ConstructFromJson(scene, data);
+
+		// Register the object and it's components with the scene before OnLoad, so that they can access our transform
+		scene->_RegisterObject(result);
+
+		// Allow components to perform self initialization
+		for (const auto& component : result->_components) {
+			component->OnLoad();
+		}
+
+		return result;
+	}
+
+	GameObject::Sptr GameObject::ConstructFromJson(Scene* scene, const nlohmann::json& data)
 	{
 		// We need to manually construct since the GameObject constructor is
 		// protected. We can call it here since Scene is a friend class of GameObjects
 		GameObject::Sptr result(new GameObject());
 		result->_scene = scene;
+		result->_selfRef = result;
 
 		// Load in basic info
 		result->Name = data["name"];
 		result->_guid = Guid(data["guid"]);
-		result->_parent = WeakRef(Guid(data.contains("parent") ? data["parent"] : "null"), nullptr);
 		result->_position = (data["position"]);
 		result->_rotation = (data["rotation"]);
 		result->_scale    = (data["scale"]);
 		result->HideInHierarchy = JsonGet(data, "hide_in_inspector", false);
 		result->_isLocalTransformDirty = true;
-		result->_isWorldTransformDirty = true;
 
 		// Since our components are stored based on the type name, we iterate
 		// on the keys and values from the components object
-		nlohmann::json components = data["components"];
-		for (auto& [typeName, value] : components.items()) {
+		for (auto& [typeName, value] : data["components"].items()) {
 			// We need to reference the component registry to load our components
 			// based on the type name (note that all component types need to be
 			// registered at the start of the application)
-			IComponent::Sptr component = scene->Components().Load(typeName, value);
-			component->_context = result.get();
-
-			// Add component to object and allow it to perform self initialization
-			result->_components.push_back(component);
-			component->OnLoad();
+			IComponent::Sptr component = ComponentManager::Construct(typeName, value);
+			if (component == nullptr) {
+				LOG_WARN("Unknown component type \"{}\" on object \"{}\"", typeName, result->Name);
+				continue;
+			}
+			result->_AttachComponent(component);
 		}
 
 		return result;
 	}
 
 	nlohmann::json GameObject::ToJson() const {
-		GameObject::Sptr parent = _parent;
+		// The roots of prefab instances only store what differs from their prefab
+		if (_prefab != nullptr && _prefabIndex == 0) {
+			return _prefab->InstanceToJson(*this);
+		}
+
+		GameObject* parent = _parent.Get();
 		nlohmann::json result = {
 			{ "name", Name },
 			{ "guid", _guid.str() },
@@ -510,39 +532,127 @@ namespace Gameplay {
 		return result;
 	}
 
+	GameObject::Sptr GameObject::ConstructFromBinary(Scene* scene, cereal::BinaryInputArchive& archive, const std::vector<uint32_t>& typeIds)
+	{
+		GameObject::Sptr result(new GameObject());
+		result->_scene = scene;
+		result->_selfRef = result;
+
+		archive(result->Name, result->_guid, result->_position, result->_rotation, result->_scale, result->HideInHierarchy);
+		result->_isLocalTransformDirty = true;
+
+		uint8_t componentCount = 0;
+		archive(componentCount);
+		for (uint8_t ix = 0; ix < componentCount; ix++) {
+			uint8_t typeIndex = 0;
+			archive(typeIndex);
+			// Scenes are user files, so a bad type is reported like any other corrupt data rather than asserting
+			if (typeIndex >= typeIds.size()) {
+				throw cereal::Exception("Invalid component type in binary scene");
+			}
+
+			// The rest of the record can't be read if we can't read this component, so the whole scene is rejected
+			IComponent::Sptr component = ComponentManager::ConstructBinary(typeIds[typeIndex], archive);
+			if (component == nullptr) {
+				throw cereal::Exception("Unregistered component type in binary scene");
+			}
+			result->_AttachComponent(component);
+		}
+
+		return result;
+	}
+
+	nlohmann::json GameObject::BinaryToJson(cereal::BinaryInputArchive& archive, const std::vector<uint32_t>& typeIds)
+	{
+		std::string name;
+		Guid guid;
+		glm::vec3 position, scale;
+		glm::quat rotation;
+		bool hideInHierarchy = false;
+		archive(name, guid, position, rotation, scale, hideInHierarchy);
+
+		nlohmann::json result = {
+			{ "name", name },
+			{ "guid", guid.str() },
+			{ "position", position },
+			{ "rotation", rotation },
+			{ "scale",    scale },
+			{ "hide_in_inspector", hideInHierarchy }
+		};
+		result["components"] = nlohmann::json();
+
+		uint8_t componentCount = 0;
+		archive(componentCount);
+		for (uint8_t ix = 0; ix < componentCount; ix++) {
+			uint8_t typeIndex = 0;
+			archive(typeIndex);
+			// Scenes are user files, so a bad type is reported like any other corrupt data rather than asserting
+			if (typeIndex >= typeIds.size()) {
+				throw cereal::Exception("Invalid component type in binary scene");
+			}
+
+			uint32_t typeId = typeIds[typeIndex];
+			result["components"][ComponentManager::GetTypeName(typeId)] = ComponentManager::BinaryToJson(typeId, archive);
+		}
+
+		return result;
+	}
+
+	void GameObject::ToBinary(cereal::BinaryOutputArchive& archive, std::vector<Guid>* dependencies) const {
+		archive(Name, _guid, _position, _rotation, _scale, HideInHierarchy);
+
+		// Component types are stored as their type ID, the scene stores the names for each ID
+		archive(static_cast<uint8_t>(_components.size()));
+		for (const auto& component : _components) {
+			archive(static_cast<uint8_t>(component->_typeId));
+			ComponentManager::SaveBinary(*component, archive, dependencies);
+		}
+	}
+
 	Gameplay::GameObject::WeakRef& GameObject::WeakRef::operator=(const GameObject::Sptr& ptr) {
-		ResourceGUID = ptr->GetGUID();
-		SceneContext = ptr->GetScene();
-		Ptr = ptr;
-		isNull = ptr == nullptr;
+		if (ptr != nullptr) {
+			SceneId = ptr->_scene != nullptr ? ptr->_scene->_sceneId : 0;
+			SlotIndex = ptr->_slotIndex;
+			Generation = ptr->_slotGeneration;
+		} else {
+			Reset();
+		}
 		return *this;
 	}
 
-	GameObject::WeakRef::WeakRef(const GameObject::Sptr& ptr) {
+	GameObject::WeakRef::WeakRef(const GameObject::Sptr& ptr) :
+		WeakRef()
+	{
 		*this = ptr;
-		isNull = ptr == nullptr;
 	}
 
 	GameObject::WeakRef::WeakRef() :
-		ResourceGUID(Guid()),
-		SceneContext(nullptr),
-		Ptr(std::weak_ptr<GameObject>()),
-		isNull(true)
+		SceneId(0),
+		SlotIndex(0),
+		Generation(0)
 	{ }
 
 	GameObject::WeakRef::WeakRef(const Guid& guid, const Scene* scene) :
-		ResourceGUID(guid),
-		SceneContext(scene),
-		Ptr(std::weak_ptr<GameObject>()),
-		isNull(false)
-	{ }
+		WeakRef()
+	{
+		// GUIDs are only used to find the object when creating the reference, after that we use the handle
+		if (scene != nullptr) {
+			*this = scene->FindObjectByGUID(guid);
+		}
+	}
 
 	bool GameObject::WeakRef::operator==(const GameObject::Sptr& other) {
-		return Resolve() == other;
+		// Null comparisons are checking whether the reference is dead
+		if (other == nullptr) {
+			return !IsAlive();
+		}
+		// Otherwise we can just compare handles, no need to resolve
+		uint32_t sceneId = other->_scene != nullptr ? other->_scene->_sceneId : 0;
+		return SceneId == sceneId && SlotIndex == other->_slotIndex && Generation == other->_slotGeneration;
 	}
 
 	bool GameObject::WeakRef::operator!=(const GameObject::Sptr& other) {
-		return Resolve() != other;
+		return !(*this == other);
 	}
 
 	GameObject::Sptr GameObject::WeakRef::operator->() {
@@ -554,43 +664,26 @@ namespace Gameplay {
 	}
 
 	GameObject::Sptr GameObject::WeakRef::Resolve() const {
-		// If we already determined the value is null, return null now
-		if (isNull) { return nullptr; }
-
-		// If the Ptr is uninitialized, try and look up the object in the scene
-		if (GetIsEmpty()) {
-			// We need a reference to the scene in order to search gameobjects :pensive:
-			if (SceneContext != nullptr) {
-				GameObject::Sptr result = SceneContext->FindObjectByGUID(ResourceGUID);
-				Ptr = result;
-				isNull = result == nullptr;
-				return result;
-			}
-			// If there's no scene, return null
-			else {
-				isNull = true;
-				return nullptr;
-			}
-		}
-		// We've looked up the weak ptr, try and lock it
-		else {
-			return Ptr.lock();
-		}
+		GameObject* object = Get();
+		return object != nullptr ? object->_selfRef.lock() : nullptr;
+	}
+
+	GameObject* GameObject::WeakRef::Get() const {
+		return Scene::_ResolveHandle(SceneId, SlotIndex, Generation);
 	}
 
 	bool GameObject::WeakRef::GetIsEmpty() const {
-		return !Ptr.owner_before(std::weak_ptr<GameObject>()) && !std::weak_ptr<GameObject>().owner_before(Ptr);
+		return SceneId == 0;
 	}
 
 	bool GameObject::WeakRef::IsAlive() const {
-		return !GetIsEmpty() && !Ptr.expired();
+		return Get() != nullptr;
 	}
 
 	void GameObject::WeakRef::Reset() {
-		ResourceGUID = Guid();
-		Ptr.reset();
-		SceneContext = nullptr;
-		isNull = true;
+		SceneId = 0;
+		SlotIndex = 0;
+		Generation = 0;
 	}
 
 	GameObject::WeakRef::operator GameObject::Sptr() const {
@@ -598,7 +691,8 @@ namespace Gameplay {
 	}
 
 	GameObject::WeakRef::operator Guid() const {
-		return ResourceGUID;
+		GameObject* object = Get();
+		return object != nullptr ? object->_guid : Guid();
 	}
 
 }
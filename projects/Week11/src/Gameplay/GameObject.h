@@ -1,5 +1,6 @@
 #pragma once
 #include <string>
+#include <array>
 
 // Utils
 #include "Utils/GUID.hpp"
@@ -19,6 +20,7 @@ class HierarchyWindow;
 namespace Gameplay {
 // Predeclaration for Scene
 	class Scene;
+	class Prefab;
 
 	namespace Physics {
 		class TriggerVolume;
@@ -36,14 +38,18 @@ namespace Gameplay {
 
 		/// <summary>
 		/// Structure to assist in wrapping weak references to GameObjects
-		/// Can track the object's GUID before and after creation
+		/// This is a compact handle into the scene's slot table (slot index + generation), so
+		/// checking whether the object is still alive is O(1) and does not need any GUID lookups.
+		/// GUIDs are only used when loading or saving references
+		/// 
+		/// The scene is stored by ID rather than by pointer, so references made in a scene that
+		/// has since been destroyed resolve to null instead of dangling
 		/// </summary>
 		struct WeakRef {
 		protected:
-			Guid ResourceGUID;
-			const Scene* SceneContext;
-			mutable std::weak_ptr<GameObject> Ptr;
-			mutable bool isNull;
+			uint32_t     SceneId;
+			uint32_t     SlotIndex;
+			uint32_t     Generation;
 
 			friend class Scene;
 
@@ -58,7 +64,8 @@ namespace Gameplay {
 			/// <param name="ptr">The shared pointer to create a reference to</param>
 			WeakRef(const GameObject::Sptr& ptr);
 			/// <summary>
-			/// Constructs a weak reference from a GUID
+			/// Constructs a weak reference from a GUID, the object is looked up immediately
+			/// so it must already exist in the scene
 			/// </summary>
 			/// <param name="guid">The ID of the gameobject to point to</param>
 			/// <param name="scene">The scene to use when looking up the referene</param>
@@ -108,7 +115,8 @@ namespace Gameplay {
 			operator GameObject::Sptr() const;
 
 			/// <summary>
-			/// Implicitly converts the reference into a GUID
+			/// Implicitly converts the reference into a GUID, or an empty GUID if the
+			/// reference is not alive
 			/// </summary>
 			operator Guid() const;
 
@@ -117,6 +125,11 @@ namespace Gameplay {
 			/// the pointer to the gameobject, or null if the reference is invalid
 			/// </summary>
 			GameObject::Sptr Resolve() const;
+			/// <summary>
+			/// Returns a raw pointer to the underlying gameobject, or nullptr if the reference is invalid.
+			/// This avoids touching the reference count, so it should be preferred for hierarchy traversal
+			/// </summary>
+			GameObject* Get() const;
 
 			/// <summary>
 			/// Returns true if this reference is uninitialized
@@ -211,6 +224,11 @@ namespace Gameplay {
 		/// Gets the scaling factor for the game object
 		/// </summary>
 		const glm::vec3& GetScale() const;
+		/// <summary>
+		/// Gets a counter that is incremented whenever the position, rotation or scale of this object
+		/// changes. Systems can store this and compare it later to see if the object has moved
+		/// </summary>
+		uint32_t GetTransformVersion() const { return _transformVersion; }
 
 		/// <summary>
 		/// Gets or recalculates and gets the object's world transform
@@ -231,6 +249,11 @@ namespace Gameplay {
 		/// </summary>
 		void RenderGUI(); 
 
+		/// <summary>
+		/// Gets the prefab that this object was instantiated from, or nullptr if it is not part of a prefab instance
+		/// </summary>
+		const std::shared_ptr<const Prefab>& GetPrefab() const;
+
 		/// <summary>
 		/// Returns a pointer to the scene that this GameObject belongs to
 		/// </summary>
@@ -242,7 +265,8 @@ namespace Gameplay {
 		void Awake();
 
 		/// <summary>
-		/// Calls update on all enabled components in this object
+		/// Calls update on all enabled components in this object, except for those with thread safe updates
+		/// (those are updated in parallel by the scene)
 		/// </summary>
 		/// <param name="deltaTime">The time since the last frame, in seconds</param>
 		void Update(float dt);
@@ -253,14 +277,7 @@ namespace Gameplay {
 		/// <typeparam name="T">The type of component to search for</typeparam>
 		template <typename T, typename = typename std::enable_if<std::is_base_of<IComponent, T>::value>::type>
 		bool Has() {
-			// Iterate over all the pointers in the components list
-			for (const auto& ptr : _components) {
-				// If the pointer type matches T, we return true
-				if (std::type_index(typeid(*ptr.get())) == std::type_index(typeid(T))) {
-					return true;
-				}
-			}
-			return false;
+			return _HasTypeId(ComponentManager::GetTypeId<T>());
 		}
 
 		bool Has(const std::type_index& type);
@@ -271,14 +288,10 @@ namespace Gameplay {
 		/// <typeparam name="T">The type of component to search for</typeparam>
 		template <typename T, typename = typename std::enable_if<std::is_base_of<IComponent, T>::value>::type>
 		std::shared_ptr<T> Get() {
-			// Iterate over all the pointers in the binding list
-			for (const auto& ptr : _components) {
-				// If the pointer type matches T, we return that behaviour, making sure to cast it back to the requested type
-				if (std::type_index(typeid(*ptr.get())) == std::type_index(typeid(T))) {
-					return std::dynamic_pointer_cast<T>(ptr);
-				}
-			}
-			return nullptr;
+			uint32_t id = ComponentManager::GetTypeId<T>();
+			// The slot table stores the component's index, and since type IDs map to exactly one
+			// concrete type we know that the static cast is safe
+			return _HasTypeId(id) ? std::static_pointer_cast<T>(_components[_componentSlots[id]]) : nullptr;
 		}
 
 		std::shared_ptr<IComponent> Get(const std::type_index& type);
@@ -300,7 +313,7 @@ namespace Gameplay {
 			component->_context = this;
 
 			// Append it to the binding component's storage, and invoke the OnLoad
-			_components.push_back(component);
+			_AttachComponent(component);
 			component->OnLoad();
 
 			if (_scene->GetIsAwake()) {
@@ -326,16 +339,48 @@ namespace Gameplay {
 		std::shared_ptr<GameObject> SelfRef();
 
 		/// <summary>
-		/// Loads a render object from a JSON blob
+		/// Loads a render object from a JSON blob and adds it to the scene
 		/// </summary>
 		static GameObject::Sptr FromJson(Scene* scene, const nlohmann::json& data);
 		/// <summary>
+		/// Constructs an object and it's components from a JSON blob, without adding them to the scene or
+		/// invoking OnLoad. This does not modify the scene, so objects can be constructed on worker threads
+		/// and then added to the scene together (see Scene::FromJson)
+		/// </summary>
+		static GameObject::Sptr ConstructFromJson(Scene* scene, const nlohmann::json& data);
+		/// <summary>
 		/// Converts this object into it's JSON representation for storage
 		/// </summary>
 		nlohmann::json ToJson() const;
 
+		/// <summary>
+		/// Constructs an object and it's components from a binary scene archive, without adding them to the
+		/// scene or invoking OnLoad (see ConstructFromJson)
+		/// </summary>
+		/// <param name="scene">The scene that the object belongs to</param>
+		/// <param name="archive">The archive to read from</param>
+		/// <param name="typeIds">Maps the component type indices stored in the archive to the registered type IDs</param>
+		static GameObject::Sptr ConstructFromBinary(Scene* scene, cereal::BinaryInputArchive& archive, const std::vector<uint32_t>& typeIds);
+		/// <summary>
+		/// Reads an object from a binary scene archive, as written by ToBinary, and returns it in the form
+		/// that ToJson uses (without the parent or children, which the scene fills in). Nothing is constructed,
+		/// so this is safe to call from worker threads while the scene keeps running
+		/// </summary>
+		/// <param name="archive">The archive to read from</param>
+		/// <param name="typeIds">Maps the component type indices stored in the archive to the registered type IDs</param>
+		static nlohmann::json BinaryToJson(cereal::BinaryInputArchive& archive, const std::vector<uint32_t>& typeIds);
+		/// <summary>
+		/// Writes this object and it's components to a binary scene archive. Unlike ToJson, this 
+		/// does not include the children, since scenes store all objects in a flat list
+		/// </summary>
+		/// <param name="archive">The archive to write to</param>
+		/// <param name="dependencies">If not null, the GUIDs of the resources used by our components are appended to this list</param>
+		void ToBinary(cereal::BinaryOutputArchive& archive, std::vector<Guid>* dependencies = nullptr) const;
+
 	private:
 		friend class Scene;
+		friend class Prefab;
+		friend class TransformHierarchy;
 		friend class InspectorWindow;
 		friend class HierarchyWindow;
 
@@ -346,14 +391,12 @@ namespace Gameplay {
 		// The scale of the object
 		glm::vec3 _scale;
 
-		// The object's world transform
-		mutable glm::mat4 _localTransform;
-		mutable glm::mat4 _inverseLocalTransform;
+		// Set when the position, rotation or scale has changed, the matrices themselves are stored
+		// in the scene's transform hierarchy
 		mutable bool _isLocalTransformDirty;
-
-		mutable glm::mat4 _worldTransform;
-		mutable glm::mat4 _inverseWorldTransform;
-		mutable bool _isWorldTransformDirty;
+		// Incremented whenever the position, rotation or scale is changed, so that other systems (ex: physics)
+		// can cheaply tell if the object has moved since they last looked
+		uint32_t     _transformVersion;
 
 		// For the hierarchy
 		WeakRef _parent;
@@ -361,6 +404,10 @@ namespace Gameplay {
 
 		// The components that this game object has attached to it
 		std::vector<IComponent::Sptr> _components;
+		// Bitmask of the component type IDs attached to this object, and the index into _components
+		// for each type, so that Has and Get don't need to search our components
+		uint64_t _componentMask;
+		std::array<uint8_t, ComponentManager::MaxComponentTypes> _componentSlots;
 		std::weak_ptr<GameObject> _selfRef;
 
 		// Pointer to the scene, we use raw pointers since 
@@ -368,16 +415,43 @@ namespace Gameplay {
 		// or load, we don't need to worry about ref counting
 		Scene* _scene;
 
+		// Our slot in the scene's slot table, used to create weak references to this object
+		uint32_t _slotIndex;
+		uint32_t _slotGeneration;
+
+		// The prefab that this object was instantiated from (if any), and our index in the prefab's hierarchy.
+		// Only the root (index 0) of an instance is saved, the rest of the instance is re-created from the prefab
+		std::shared_ptr<const Prefab> _prefab;
+		uint32_t                      _prefabIndex;
+
 		/// <summary>
 		/// Only scenes will be allowed to create gameobjects
 		/// </summary>
 		GameObject();
 
+		// Flags the local transform for recalculation, bumps the transform version and lets our physics bodies know we've moved
+		void _OnTransformChanged();
+
 		// Recalculates the transform matrix for the object when required
 		void _RecalcLocalTransform() const;
 		void _RecalcWorldTransform() const;
 
 		void _PurgeDeletedChildren();
+
+		/// <summary>
+		/// Returns true if a component with the given type ID is attached to this object
+		/// </summary>
+		bool _HasTypeId(uint32_t typeId) const {
+			return typeId < ComponentManager::MaxComponentTypes && (_componentMask & (1ull << typeId)) != 0;
+		}
+		/// <summary>
+		/// Appends a component to this object's component list and updates the type mask and slots
+		/// </summary>
+		void _AttachComponent(const IComponent::Sptr& component);
+		/// <summary>
+		/// Removes the component at the given index, and rebuilds the type mask and slots
+		/// </summary>
+		void _RemoveComponentAt(size_t index);
 	};
 
 }
\ No newline at end of file
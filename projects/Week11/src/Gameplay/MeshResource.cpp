@@ -2,14 +2,29 @@
 #include <filesystem>
 
 #include "Utils/ObjLoader.h"
+#include "Utils/OptimizedObjLoader.h"
+#include "Utils/VirtualFileSystem.h"
+#include "Gameplay/Physics/ConvexHullCache.h"
 
 namespace Gameplay {
+	/// <summary>
+	/// Copies the vertex positions out of a mesh builder so they can be kept on the CPU
+	/// </summary>
+	template <typename VertType>
+	void CopyPositions(const MeshBuilder<VertType>& mesh, std::vector<glm::vec3>& result) {
+		const VertType* vertices = mesh.GetVertexDataPtr();
+		result.resize(mesh.GetVertexCount());
+		for (size_t ix = 0; ix < mesh.GetVertexCount(); ix++) {
+			result[ix] = vertices[ix].Position;
+		}
+	}
+
 	MeshResource::MeshResource() :
 		IResource(),
 		Filename(""),
 		MeshBuilderParams(std::vector<MeshBuilderParam>()),
 		Mesh(nullptr),
-		BulletTriMesh(nullptr)
+		Positions(std::vector<glm::vec3>())
 	{ }
 
 	MeshResource::MeshResource(const std::string& filename) :
@@ -17,9 +32,9 @@ namespace Gameplay {
 		Filename(filename),
 		MeshBuilderParams(std::vector<MeshBuilderParam>()),
 		Mesh(nullptr),
-		BulletTriMesh(nullptr)
+		Positions(std::vector<glm::vec3>())
 	{
-		Mesh = ObjLoader::LoadFromFile(filename);
+		Mesh = ObjLoader::LoadFromFile(filename, &Positions);
 	}
 
 	MeshResource::~MeshResource() = default;
@@ -52,13 +67,14 @@ namespace Gameplay {
 			}
 			MeshFactory::CalculateTBN(mesh);
 			result->Mesh = mesh.Bake();
+			CopyPositions(mesh, result->Positions);
 		} else {
 			result->Filename = JsonGet<std::string>(blob, "filename", "null");
-			if (result->Filename != "null" && std::filesystem::exists(result->Filename)) {
+			if (result->Filename != "null" && VirtualFileSystem::Exists(result->Filename)) {
 				#ifdef OPTIMIZED_OBJ_LOADER
-				result->Mesh = OptimizedObjLoader::LoadFromFile(result->Filename);
+				result->Mesh = OptimizedObjLoader::LoadFromFile(result->Filename, &result->Positions);
 				#else
-				result->Mesh = ObjLoader::LoadFromFile(result->Filename);
+				result->Mesh = ObjLoader::LoadFromFile(result->Filename, &result->Positions);
 				#endif
 
 			}
@@ -66,6 +82,57 @@ namespace Gameplay {
 		return result;
 	}
 
+	IResource::FinalizeFunc MeshResource::DecodeFromJson(const nlohmann::json& blob)
+	{
+		// Parameterized meshes are built on the CPU here, and only baked into a VAO when finalized
+		if (blob.contains("params") && blob["params"].is_array()) {
+			std::shared_ptr<MeshBuilder<VertexPosNormTexColTangents>> mesh = std::make_shared<MeshBuilder<VertexPosNormTexColTangents>>();
+			std::vector<MeshBuilderParam> params;
+			for (const nlohmann::json& param : blob["params"]) {
+				params.push_back(MeshBuilderParam::FromJson(param));
+				MeshFactory::AddParameterized(*mesh, params.back());
+			}
+			MeshFactory::CalculateTBN(*mesh);
+
+			return [mesh, params]() -> IResource::Sptr {
+				MeshResource::Sptr result = std::make_shared<MeshResource>();
+				result->MeshBuilderParams = params;
+				result->Mesh = mesh->Bake();
+				CopyPositions(*mesh, result->Positions);
+				return result;
+			};
+		}
+
+		std::string filename = JsonGet<std::string>(blob, "filename", "null");
+	#ifndef OPTIMIZED_OBJ_LOADER
+		// OBJ files are parsed here, the VAO is created when finalized
+		std::shared_ptr<std::vector<VertexPosNormTexCol>> vertices = std::make_shared<std::vector<VertexPosNormTexCol>>();
+		std::shared_ptr<std::vector<glm::vec3>> positions = std::make_shared<std::vector<glm::vec3>>();
+		bool isLoaded = filename != "null" && VirtualFileSystem::Exists(filename) && ObjLoader::LoadVertices(filename, *vertices, positions.get());
+
+		return [filename, vertices, positions, isLoaded]() -> IResource::Sptr {
+			MeshResource::Sptr result = std::make_shared<MeshResource>();
+			result->Filename = filename;
+			if (isLoaded) {
+				result->Mesh = ObjLoader::CreateVao(*vertices);
+				result->Positions = std::move(*positions);
+			}
+			return result;
+		};
+	#else
+		// The optimized loader reads straight into GL buffers, so it can only be loaded when finalized
+		return [blob]() -> IResource::Sptr { return FromJson(blob); };
+	#endif
+	}
+
+	size_t MeshResource::GetCpuMemoryUsage() const {
+		return Positions.size() * sizeof(glm::vec3);
+	}
+
+	size_t MeshResource::GetGpuMemoryUsage() const {
+		return Mesh != nullptr ? Mesh->GetBufferMemoryUsage() : 0;
+	}
+
 	void MeshResource::GenerateMesh() {
 		MeshBuilder<VertexPosNormTexColTangents> mesh;
 		for (auto& param : MeshBuilderParams) {
@@ -73,6 +140,10 @@ namespace Gameplay {
 		}
 		MeshFactory::CalculateTBN(mesh);
 		Mesh = mesh.Bake();
+		CopyPositions(mesh, Positions);
+
+		// Our positions have changed, so any hull that was built from the old ones is stale
+		Physics::ConvexHullCache::Invalidate(GetGUID());
 	}
 
 	void MeshResource::AddParam(const MeshBuilderParam & param) {
@@ -3,9 +3,6 @@
 #include "Graphics/VertexArrayObject.h"
 #include "Utils/MeshFactory.h"
 
-// bullet triangle mesh pre-declaration
-class btTriangleMesh;
-
 namespace Gameplay {
 	/// <summary>
 	/// A mesh resource contains information on how to generate a VAO at runtime
@@ -47,9 +44,10 @@ namespace Gameplay {
 		/// </summary>
 		MeshResource::Sptr             ColliderMeshData;
 		/// <summary>
-		/// Allows for bullet to generate a triangle mesh from this mesh and cache it
+		/// A CPU side copy of the vertex positions in the mesh, kept when the mesh is loaded or generated
+		/// so that physics shapes can be built without reading the mesh back from the GPU
 		/// </summary>
-		std::shared_ptr<btTriangleMesh> BulletTriMesh;
+		std::vector<glm::vec3>         Positions;
 
 		/// <summary>
 		/// Generates a new mesh from the mesh builder parameters
@@ -64,6 +62,13 @@ namespace Gameplay {
 		// Inherited from IResource
 
 		virtual nlohmann::json ToJson() const override;
+		virtual size_t GetCpuMemoryUsage() const override;
+		virtual size_t GetGpuMemoryUsage() const override;
 		static MeshResource::Sptr FromJson(const nlohmann::json& blob);
+		/// <summary>
+		/// Parses or generates the mesh's vertices on the calling thread, and returns a function that creates
+		/// the mesh resource and it's VAO (which must be called on the main thread)
+		/// </summary>
+		static IResource::FinalizeFunc DecodeFromJson(const nlohmann::json& blob);
 	};
 }
\ No newline at end of file
@@ -0,0 +1,94 @@
+#include "Gameplay/Physics/BulletTaskScheduler.h"
+
+#include <algorithm>
+#include <vector>
+#include <Logging.h>
+
+#include "Application/JobSystem.h"
+
+// These are defined by bullet's LinearMath library (btThreads.cpp), and are what bullet's own task schedulers use
+// to flag that parallel work is in progress, but they are not exposed in bullet's headers
+void btPushThreadsAreRunning();
+void btPopThreadsAreRunning();
+
+BulletTaskScheduler::BulletTaskScheduler() :
+	btITaskScheduler("JobSystem")
+{ }
+
+void BulletTaskScheduler::Install() {
+	static BulletTaskScheduler scheduler;
+	if (btGetTaskScheduler() != &scheduler) {
+		// Bullet treats whichever thread asks for an index first as it's main thread, so claim index 0 for the
+		// main thread before any workers get a chance to
+		LOG_ASSERT(JobSystem::Get().IsMainThread(), "The bullet task scheduler must be installed from the main thread!");
+		btGetCurrentThreadIndex();
+
+		btSetTaskScheduler(&scheduler);
+		LOG_INFO("Bullet is now using the job system with {} threads", scheduler.getNumThreads());
+	}
+}
+
+int BulletTaskScheduler::getMaxNumThreads() const {
+	return BT_MAX_THREAD_COUNT;
+}
+
+int BulletTaskScheduler::getNumThreads() const {
+	// Bullet sizes it's per-thread storage with this, so it must cover every thread that may run our jobs
+	uint32_t threads = JobSystem::IsInitialized() ? JobSystem::Get().ThreadCount() : 1;
+	return static_cast<int>(std::min<uint32_t>(threads, BT_MAX_THREAD_COUNT));
+}
+
+void BulletTaskScheduler::setNumThreads(int numThreads) {
+	// The job system's thread count is fixed when the application starts, see the worker_threads setting
+	LOG_WARN("Bullet requested {} threads, but the job system's thread count cannot be changed", numThreads);
+}
+
+void BulletTaskScheduler::parallelFor(int iBegin, int iEnd, int grainSize, const btIParallelForBody& body) {
+	int count = iEnd - iBegin;
+	if (count <= 0) return;
+
+	// Without a job system, or with too little work to split, just run the loop here
+	if (!JobSystem::IsInitialized() || count <= grainSize) {
+		body.forLoop(iBegin, iEnd);
+		return;
+	}
+
+	// Let bullet know that it's code is running on multiple threads, so that it takes it's locks
+	btPushThreadsAreRunning();
+	JobSystem::Get().ParallelFor(count, _GetBatchSize(count, grainSize), [&](size_t begin, size_t end) {
+		body.forLoop(iBegin + static_cast<int>(begin), iBegin + static_cast<int>(end));
+	});
+	btPopThreadsAreRunning();
+}
+
+btScalar BulletTaskScheduler::parallelSum(int iBegin, int iEnd, int grainSize, const btIParallelSumBody& body) {
+	int count = iEnd - iBegin;
+	if (count <= 0) return btScalar(0);
+
+	if (!JobSystem::IsInitialized() || count <= grainSize) {
+		return body.sumLoop(iBegin, iEnd);
+	}
+
+	// Each batch writes it's own partial sum, and we add them up in order so that the result does not
+	// depend on which thread finished first
+	size_t batchSize = _GetBatchSize(count, grainSize);
+	std::vector<btScalar> partials((count + batchSize - 1) / batchSize, btScalar(0));
+
+	btPushThreadsAreRunning();
+	JobSystem::Get().ParallelFor(count, batchSize, [&](size_t begin, size_t end) {
+		partials[begin / batchSize] = body.sumLoop(iBegin + static_cast<int>(begin), iBegin + static_cast<int>(end));
+	});
+	btPopThreadsAreRunning();
+
+	btScalar result = btScalar(0);
+	for (btScalar partial : partials) {
+		result += partial;
+	}
+	return result;
+}
+
+size_t BulletTaskScheduler::_GetBatchSize(int count, int grainSize) const {
+	// Aim for a few batches per thread like the job system does, but respect bullet's minimum
+	size_t perThread = static_cast<size_t>(count) / (static_cast<size_t>(getNumThreads()) * 4);
+	return std::max<size_t>({ perThread, static_cast<size_t>(std::max(grainSize, 1)), 1 });
+}
@@ -0,0 +1,35 @@
+#pragma once
+#include "LinearMath/btThreads.h"
+
+/// <summary>
+/// Implements the btITaskScheduler interface on top of our job system, allowing bullet's
+/// multithreaded world (btDiscreteDynamicsWorldMt) to spread it's work across our worker threads
+/// instead of spinning up a thread pool of it's own
+/// 
+/// Bullet indexes it's per-thread storage by the order in which threads first run bullet work, so
+/// parallel bullet work should only ever be run from job system threads
+/// </summary>
+class BulletTaskScheduler : public btITaskScheduler
+{
+public:
+	BulletTaskScheduler();
+
+	/// <summary>
+	/// Creates the scheduler and hands it to bullet, if it has not already been installed. Must be
+	/// called before creating any of bullet's multithreaded classes
+	/// </summary>
+	static void Install();
+
+	// Inherited from btITaskScheduler
+	virtual int getMaxNumThreads() const override;
+	virtual int getNumThreads() const override;
+	virtual void setNumThreads(int numThreads) override;
+	virtual void parallelFor(int iBegin, int iEnd, int grainSize, const btIParallelForBody& body) override;
+	virtual btScalar parallelSum(int iBegin, int iEnd, int grainSize, const btIParallelSumBody& body) override;
+
+private:
+	/// <summary>
+	/// Picks the number of iterations per job, making sure we never go below bullet's grain size
+	/// </summary>
+	size_t _GetBatchSize(int count, int grainSize) const;
+};
@@ -39,6 +39,6 @@ namespace Gameplay::Physics {
 
 	void BoxCollider::SetExtents(const glm::vec3& value) {
 		_extents = value;
-		_isDirty = true;
+		_MarkDirty();
 	}
 }
\ No newline at end of file
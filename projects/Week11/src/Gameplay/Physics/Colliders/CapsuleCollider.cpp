@@ -38,7 +38,7 @@ namespace Gameplay::Physics {
 
 	CapsuleCollider* CapsuleCollider::SetRadius(float value) {
 		_radius = value;
-		_isDirty = true;
+		_MarkDirty();
 		return this;
 	}
 
@@ -48,7 +48,7 @@ namespace Gameplay::Physics {
 
 	CapsuleCollider* CapsuleCollider::SetHeight(float value) {
 		_height = value;
-		_isDirty = true;
+		_MarkDirty();
 		return this;
 	}
 
@@ -38,7 +38,7 @@ namespace Gameplay::Physics {
 
 	ConeCollider* ConeCollider::SetRadius(float value) {
 		_radius = value;
-		_isDirty = true;
+		_MarkDirty();
 		return this;
 	}
 
@@ -48,7 +48,7 @@ namespace Gameplay::Physics {
 
 	ConeCollider* ConeCollider::SetHeight(float value) {
 		_height = value;
-		_isDirty = true;
+		_MarkDirty();
 		return this;
 	}
 
@@ -2,9 +2,12 @@
 
 #include "Gameplay/Physics/ICollider.h"
 
+class btConvexHullShape;
+
 namespace Gameplay::Physics {
 	/// <summary>
-	/// A complex collider type that allows us to construct collision hulls from arbitrary convex meshes
+	/// A complex collider type that allows us to construct collision hulls from arbitrary convex meshes. The
+	/// hull is shared with all other colliders using the same mesh through the ConvexHullCache
 	/// </summary>
 	class ConvexMeshCollider final : public ICollider {
 	public:
@@ -19,7 +22,9 @@ namespace Gameplay::Physics {
 		virtual void FromJson(const nlohmann::json& data) override;
 
 	protected:
-		btTriangleMesh* _triMesh;
+		// The cached hull for our mesh, we copy it's points into our own shape since bullet stores
+		// scaling on the shape itself
+		std::shared_ptr<const btConvexHullShape> _hull;
 		ConvexMeshCollider();
 
 		virtual btCollisionShape* CreateShape() const override;
@@ -35,7 +35,7 @@ namespace Gameplay::Physics {
 
 	CylinderCollider* CylinderCollider::SetHalfExtents(const glm::vec3 & value) {
 		_extents = value;
-		_isDirty = true;
+		_MarkDirty();
 		return this;
 	}
 
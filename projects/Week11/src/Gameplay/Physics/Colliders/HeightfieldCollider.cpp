@@ -0,0 +1,193 @@
+#include "Gameplay/Physics/Colliders/HeightfieldCollider.h"
+#include <algorithm>
+#include <BulletCollision/CollisionShapes/btHeightfieldTerrainShape.h>
+#include <stb_image.h>
+
+// Utils
+#include "Utils/JsonGlmHelpers.h"
+#include "Utils/ImGuiHelper.h"
+#include "Utils/Base64.h"
+#include "Utils/VirtualFileSystem.h"
+#include "Utils/ResourceManager/ResourceManager.h"
+
+#include "Graphics/Textures/Texture2D.h"
+
+namespace Gameplay::Physics {
+	std::mutex HeightfieldCollider::_cacheLock;
+	std::unordered_map<Guid, std::weak_ptr<const HeightfieldCollider::HeightData>> HeightfieldCollider::_textureCache;
+
+	HeightfieldCollider::Sptr HeightfieldCollider::Create() {
+		return std::shared_ptr<HeightfieldCollider>(new HeightfieldCollider());
+	}
+
+	HeightfieldCollider::Sptr HeightfieldCollider::Create(const std::shared_ptr<Texture2D>& texture) {
+		HeightfieldCollider::Sptr result = Create();
+		result->SetTexture(texture);
+		return result;
+	}
+
+	HeightfieldCollider::Sptr HeightfieldCollider::Create(int width, int length, const std::vector<float>& heights) {
+		HeightfieldCollider::Sptr result = Create();
+		result->SetHeights(width, length, heights);
+		return result;
+	}
+
+	HeightfieldCollider::HeightfieldCollider() :
+		ICollider(ColliderType::Terrain),
+		_texture(nullptr),
+		_data(nullptr),
+		_shapeData(nullptr)
+	{ }
+
+	HeightfieldCollider::~HeightfieldCollider() {
+		// Delete the shape before our heights go away, rather than leaving it to ICollider
+		if (_shape != nullptr) {
+			delete _shape;
+			_shape = nullptr;
+		}
+		_shapeData = nullptr;
+	}
+
+	btCollisionShape* HeightfieldCollider::CreateShape() const {
+		// Any previous shape has already been deleted by the time a new one is created, so it's safe to let
+		// go of the heights it was using
+		_shapeData = _data;
+		if (_data == nullptr) {
+			return nullptr;
+		}
+
+		// Bullet references our heights rather than copying them, so the shape is cheap to make, and every
+		// collider using the same data shares it. Setting new heights only swaps _data, the body keeps using
+		// the old shape until it handles our dirty flag, so _shapeData keeps those heights alive until then
+		return new btHeightfieldTerrainShape(_shapeData->Width, _shapeData->Length, _shapeData->Heights.data(), 1.0f,
+			_shapeData->MinHeight, _shapeData->MaxHeight, 2, PHY_FLOAT, false);
+	}
+
+	void HeightfieldCollider::SetTexture(const std::shared_ptr<Texture2D>& texture) {
+		_texture = texture;
+		_data = texture != nullptr ? _GetTextureHeights(*texture) : nullptr;
+		_MarkDirty();
+	}
+
+	const std::shared_ptr<Texture2D>& HeightfieldCollider::GetTexture() const {
+		return _texture;
+	}
+
+	void HeightfieldCollider::SetHeights(int width, int length, const std::vector<float>& heights) {
+		LOG_ASSERT(width > 1 && length > 1, "Heightfields need at least 2 samples along each axis!");
+		LOG_ASSERT(heights.size() == (size_t)width * length, "Expected {} heights, got {}", (size_t)width * length, heights.size());
+
+		_texture = nullptr;
+		_data = _MakeHeightData(width, length, std::vector<float>(heights));
+		_MarkDirty();
+	}
+
+	const HeightfieldCollider::HeightData::Sptr& HeightfieldCollider::GetHeightData() const {
+		return _data;
+	}
+
+	void HeightfieldCollider::DrawImGui() {
+		if (_data != nullptr) {
+			ImGui::Text("Source:  %s", _texture != nullptr ? _texture->GetDescription().Filename.c_str() : "Raw heights");
+			ImGui::Text("Samples: %d x %d", _data->Width, _data->Length);
+			ImGui::Text("Heights: %.3f to %.3f", _data->MinHeight, _data->MaxHeight);
+		} else {
+			ImGui::TextUnformatted("No height data");
+		}
+	}
+
+	void HeightfieldCollider::ToJson(nlohmann::json& blob) const {
+		if (_texture != nullptr) {
+			blob["texture"] = _texture->GetGUID().str();
+		}
+		// Raw heights are embedded in the blob, similar to how textures embed generated data
+		else if (_data != nullptr) {
+			blob["width"]  = _data->Width;
+			blob["length"] = _data->Length;
+			blob["data"]   = Base64::Encode((void*)_data->Heights.data(), _data->Heights.size() * sizeof(float));
+		}
+	}
+
+	void HeightfieldCollider::FromJson(const nlohmann::json& data) {
+		if (data.contains("texture")) {
+			std::shared_ptr<Texture2D> texture = ResourceManager::Get<Texture2D>(Guid(data["texture"].get<std::string>()));
+			if (texture == nullptr) {
+				LOG_WARN("Heightfield collider references a texture that is not loaded!");
+			}
+			SetTexture(texture);
+		}
+		else if (data.contains("data") && data["data"].is_string()) {
+			int width  = JsonGet(data, "width", 0);
+			int length = JsonGet(data, "length", 0);
+			std::string raw = Base64::Decode(data["data"].get<std::string>());
+
+			if (width > 1 && length > 1 && raw.size() == (size_t)width * length * sizeof(float)) {
+				std::vector<float> heights((size_t)width * length);
+				memcpy(heights.data(), raw.data(), raw.size());
+				_texture = nullptr;
+				_data = _MakeHeightData(width, length, std::move(heights));
+				_MarkDirty();
+			} else {
+				LOG_WARN("Heightfield collider has invalid height data, ignoring");
+			}
+		}
+	}
+
+	HeightfieldCollider::HeightData::Sptr HeightfieldCollider::_GetTextureHeights(const Texture2D& texture) {
+		std::lock_guard<std::mutex> lock(_cacheLock);
+
+		// If another collider is already using this texture, share it's heights
+		auto it = _textureCache.find(texture.GetGUID());
+		if (it != _textureCache.end()) {
+			HeightData::Sptr result = it->second.lock();
+			if (result != nullptr) {
+				return result;
+			}
+		}
+
+		// We read the source image on the CPU rather than reading the texture back from the GPU. We load 16 bits
+		// per sample so that 16 bit heightmaps keep their precision, and flip to match how textures are loaded
+		const std::string& filename = texture.GetDescription().Filename;
+		if (filename.empty()) {
+			LOG_WARN("Heightfield textures must be loaded from a file!");
+			return nullptr;
+		}
+
+		int width = 0, length = 0, numChannels = 0;
+		stbi_set_flip_vertically_on_load(true);
+		std::string_view packed = VirtualFileSystem::GetView(filename);
+		uint16_t* pixels = packed.data() != nullptr ?
+			stbi_load_16_from_memory(reinterpret_cast<const stbi_uc*>(packed.data()), static_cast<int>(packed.size()), &width, &length, &numChannels, 1) :
+			stbi_load_16(filename.c_str(), &width, &length, &numChannels, 1);
+		if (pixels == nullptr) {
+			LOG_WARN("Failed to load heightfield from \"{}\"", filename);
+			return nullptr;
+		}
+
+		std::vector<float> heights((size_t)width * length);
+		for (size_t ix = 0; ix < heights.size(); ix++) {
+			heights[ix] = pixels[ix] / 65535.0f;
+		}
+		stbi_image_free(pixels);
+
+		if (width < 2 || length < 2) {
+			LOG_WARN("Heightfield \"{}\" needs at least 2 samples along each axis", filename);
+			return nullptr;
+		}
+
+		HeightData::Sptr result = _MakeHeightData(width, length, std::move(heights));
+		_textureCache[texture.GetGUID()] = result;
+		return result;
+	}
+
+	HeightfieldCollider::HeightData::Sptr HeightfieldCollider::_MakeHeightData(int width, int length, std::vector<float>&& heights) {
+		std::shared_ptr<HeightData> result = std::make_shared<HeightData>();
+		result->Width  = width;
+		result->Length = length;
+		auto [min, max] = std::minmax_element(heights.begin(), heights.end());
+		result->MinHeight = *min;
+		result->MaxHeight = *max;
+		result->Heights = std::move(heights);
+		return result;
+	}
+}
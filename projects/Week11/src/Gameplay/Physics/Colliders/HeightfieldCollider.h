@@ -0,0 +1,105 @@
+#pragma once
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "Gameplay/Physics/ICollider.h"
+
+class Texture2D;
+
+namespace Gameplay::Physics {
+	/// <summary>
+	/// A terrain collider built from a grid of heights, much cheaper than a mesh collider for large ground.
+	/// Heights can either come from the red channel of a Texture2D's source image (read on the CPU, with
+	/// heights from 0 to 1), or from a raw array of floats
+	/// 
+	/// The grid has one unit between samples along the X and Y axes, and heights along Z, so the collider's
+	/// scale is used to set the size of the terrain. Note that bullet centers the terrain on the collider's
+	/// position, including vertically (halfway between the lowest and highest samples)
+	/// 
+	/// Height data is immutable once created, and is shared between all colliders that use the same texture.
+	/// Like other concave shapes, heightfields should only be used on static or kinematic bodies
+	/// </summary>
+	class HeightfieldCollider final : public ICollider {
+	public:
+		typedef std::shared_ptr<HeightfieldCollider> Sptr;
+
+		/// <summary>
+		/// Stores the samples for a heightfield, with rows along the X axis
+		/// </summary>
+		struct HeightData {
+			typedef std::shared_ptr<const HeightData> Sptr;
+
+			int                Width;
+			int                Length;
+			float              MinHeight;
+			float              MaxHeight;
+			std::vector<float> Heights;
+		};
+
+		static HeightfieldCollider::Sptr Create();
+		/// <summary>
+		/// Creates a heightfield collider using the source image of the given texture
+		/// </summary>
+		/// <param name="texture">The texture to read heights from, must have been loaded from a file</param>
+		static HeightfieldCollider::Sptr Create(const std::shared_ptr<Texture2D>& texture);
+		/// <summary>
+		/// Creates a heightfield collider from a raw array of heights
+		/// </summary>
+		/// <param name="width">The number of samples along the X axis</param>
+		/// <param name="length">The number of samples along the Y axis</param>
+		/// <param name="heights">The heights, must have width * length elements, with rows along the X axis</param>
+		static HeightfieldCollider::Sptr Create(int width, int length, const std::vector<float>& heights);
+		virtual ~HeightfieldCollider();
+
+		/// <summary>
+		/// Sets the texture to read heights from, will be shared with any other colliders using the same texture
+		/// </summary>
+		void SetTexture(const std::shared_ptr<Texture2D>& texture);
+		/// <summary>
+		/// Gets the texture that this collider reads heights from, or nullptr if it is using raw heights
+		/// </summary>
+		const std::shared_ptr<Texture2D>& GetTexture() const;
+		/// <summary>
+		/// Replaces the heights in this collider with a raw array of heights
+		/// </summary>
+		/// <param name="width">The number of samples along the X axis</param>
+		/// <param name="length">The number of samples along the Y axis</param>
+		/// <param name="heights">The heights, must have width * length elements, with rows along the X axis</param>
+		void SetHeights(int width, int length, const std::vector<float>& heights);
+		/// <summary>
+		/// Gets the height data for this collider, may be nullptr if no heights have been set
+		/// </summary>
+		const HeightData::Sptr& GetHeightData() const;
+
+		// Inherited from ICollider
+		virtual void DrawImGui() override;
+		virtual void ToJson(nlohmann::json& blob) const override;
+		virtual void FromJson(const nlohmann::json& data) override;
+
+	protected:
+		HeightfieldCollider();
+
+		std::shared_ptr<Texture2D> _texture;
+		HeightData::Sptr           _data;
+		// The data our current shape was built from. Bullet keeps pointing into these heights until the shape is
+		// deleted, which may be a while after _data is replaced, so we hold onto them separately
+		mutable HeightData::Sptr   _shapeData;
+
+		virtual btCollisionShape* CreateShape() const override;
+
+		// Height data loaded from textures, keyed by the texture's GUID. These are weak so that the
+		// heights are freed once no colliders are using them
+		static std::mutex _cacheLock;
+		static std::unordered_map<Guid, std::weak_ptr<const HeightData>> _textureCache;
+
+		/// <summary>
+		/// Gets the heights for a texture from the cache, loading them from the texture's source image if needed
+		/// </summary>
+		static HeightData::Sptr _GetTextureHeights(const Texture2D& texture);
+		/// <summary>
+		/// Creates height data from a raw array, calculating the height range
+		/// </summary>
+		static HeightData::Sptr _MakeHeightData(int width, int length, std::vector<float>&& heights);
+	};
+}
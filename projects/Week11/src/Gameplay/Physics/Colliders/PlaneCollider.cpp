@@ -37,6 +37,6 @@ namespace Gameplay::Physics {
 
 	void PlaneCollider::SetNormal(const glm::vec3& value) {
 		_normal = value;
-		_isDirty = true;
+		_MarkDirty();
 	}
 }
\ No newline at end of file
@@ -20,7 +20,7 @@ namespace Gameplay::Physics {
 
 	SphereCollider* SphereCollider::SetRadius(float value) {
 		_radius = value;
-		_isDirty = true;
+		_MarkDirty();
 		return this;
 	}
 
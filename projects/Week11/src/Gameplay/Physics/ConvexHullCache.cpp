@@ -0,0 +1,93 @@
+#include "Gameplay/Physics/ConvexHullCache.h"
+
+#include <algorithm>
+#include <vector>
+#include <BulletCollision/CollisionShapes/btConvexHullShape.h>
+#include <LinearMath/btConvexHullComputer.h>
+#include <Logging.h>
+
+#include "Gameplay/MeshResource.h"
+
+namespace Gameplay::Physics {
+	int ConvexHullCache::MaxVertices = 64;
+	std::mutex ConvexHullCache::_lock;
+	std::unordered_map<Guid, std::shared_ptr<const btConvexHullShape>> ConvexHullCache::_hulls;
+
+	std::shared_ptr<const btConvexHullShape> ConvexHullCache::Get(const std::shared_ptr<MeshResource>& mesh) {
+		if (mesh == nullptr) {
+			return nullptr;
+		}
+
+		std::lock_guard<std::mutex> lock(_lock);
+
+		auto it = _hulls.find(mesh->GetGUID());
+		if (it != _hulls.end()) {
+			return it->second;
+		}
+
+		std::shared_ptr<const btConvexHullShape> result = _Build(*mesh);
+		// We only cache hulls that were actually built, so a mesh that gets it's data later can try again
+		if (result != nullptr) {
+			_hulls[mesh->GetGUID()] = result;
+		}
+		return result;
+	}
+
+	void ConvexHullCache::Clear() {
+		std::lock_guard<std::mutex> lock(_lock);
+		_hulls.clear();
+	}
+
+	void ConvexHullCache::Invalidate(const Guid& meshId) {
+		std::lock_guard<std::mutex> lock(_lock);
+		_hulls.erase(meshId);
+	}
+
+	std::shared_ptr<const btConvexHullShape> ConvexHullCache::_Build(const MeshResource& mesh) {
+		if (mesh.Positions.size() < 4) {
+			LOG_WARN("Mesh does not have enough CPU side positions to build a convex hull");
+			return nullptr;
+		}
+
+		// Find the points that are actually on the hull, everything inside the hull can be thrown away
+		btConvexHullComputer computer;
+		computer.compute(&mesh.Positions[0].x, sizeof(glm::vec3), static_cast<int>(mesh.Positions.size()), 0.0f, 0.0f);
+		const btAlignedObjectArray<btVector3>& hullPoints = computer.vertices;
+		if (hullPoints.size() == 0) {
+			LOG_WARN("Failed to build convex hull for mesh");
+			return nullptr;
+		}
+
+		std::vector<btVector3> points;
+		if (hullPoints.size() <= MaxVertices) {
+			points.assign(&hullPoints[0], &hullPoints[0] + hullPoints.size());
+		}
+		// If the hull is too detailed, we keep the furthest point along directions spread evenly over a sphere
+		// (a fibonacci sphere), which keeps the overall shape while capping the number of points
+		else {
+			const int directions = std::max(MaxVertices, 4);
+			const float goldenAngle = SIMD_PI * (3.0f - btSqrt(5.0f));
+			std::vector<bool> isUsed(hullPoints.size(), false);
+			points.reserve(directions);
+
+			for (int ix = 0; ix < directions; ix++) {
+				float z = 1.0f - (2.0f * ix + 1.0f) / directions;
+				float radius = btSqrt(1.0f - z * z);
+				float angle = goldenAngle * ix;
+				btVector3 direction = btVector3(btCos(angle) * radius, btSin(angle) * radius, z);
+
+				// maxDot returns the index of the point furthest along the direction
+				btScalar dot;
+				long index = direction.maxDot(&hullPoints[0], hullPoints.size(), dot);
+				if (index >= 0 && !isUsed[index]) {
+					isUsed[index] = true;
+					points.push_back(hullPoints[index]);
+				}
+			}
+		}
+
+		LOG_TRACE("Built convex hull with {} points from {} mesh positions", points.size(), mesh.Positions.size());
+		// Bullet shapes have their own aligned allocators, so we use new rather than make_shared
+		return std::shared_ptr<const btConvexHullShape>(new btConvexHullShape(&points[0].x(), static_cast<int>(points.size()), static_cast<int>(sizeof(btVector3))));
+	}
+}
@@ -0,0 +1,59 @@
+#pragma once
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+#include "Utils/GUID.hpp"
+
+class btConvexHullShape;
+
+namespace Gameplay {
+	class MeshResource;
+}
+
+namespace Gameplay::Physics {
+	/// <summary>
+	/// A process-wide cache of convex hulls built from mesh resources, keyed by the mesh's GUID. Hulls are
+	/// built from the CPU side copy of the mesh's positions, so the GPU never has to be read back, and are
+	/// only built once no matter how many colliders use the mesh
+	/// 
+	/// Hulls with more than MaxVertices points are simplified by keeping only the points that are furthest
+	/// out along a set of evenly spread directions
+	/// </summary>
+	class ConvexHullCache {
+	public:
+		/// <summary>
+		/// The maximum number of points to keep in a hull, hulls built after this is changed will use the new limit
+		/// </summary>
+		static int MaxVertices;
+
+		/// <summary>
+		/// Gets the hull for the given mesh, building it if this is the first time it has been requested
+		/// </summary>
+		/// <param name="mesh">The mesh to get the hull for</param>
+		/// <returns>The hull for the mesh, or nullptr if the mesh has no CPU side positions</returns>
+		static std::shared_ptr<const btConvexHullShape> Get(const std::shared_ptr<MeshResource>& mesh);
+
+		/// <summary>
+		/// Removes all hulls from the cache, hulls that are still in use by colliders will stay alive
+		/// until those colliders are done with them
+		/// </summary>
+		static void Clear();
+
+		/// <summary>
+		/// Removes the hull for a single mesh from the cache, this should be called whenever the mesh's
+		/// positions change so that the next request builds a new hull
+		/// </summary>
+		/// <param name="meshId">The GUID of the mesh that has changed</param>
+		static void Invalidate(const Guid& meshId);
+
+	private:
+		static std::mutex _lock;
+		static std::unordered_map<Guid, std::shared_ptr<const btConvexHullShape>> _hulls;
+
+		/// <summary>
+		/// Builds and simplifies the hull for a mesh
+		/// </summary>
+		static std::shared_ptr<const btConvexHullShape> _Build(const MeshResource& mesh);
+	};
+}
@@ -6,6 +6,8 @@
 // Utils
 #include "Utils/GlmDefines.h"
 
+#include "Gameplay/Physics/PhysicsBase.h"
+
 // Collider Types
 #include "Gameplay/Physics/Colliders/BoxCollider.h"
 #include "Gameplay/Physics/Colliders/PlaneCollider.h"
@@ -14,6 +16,7 @@
 #include "Gameplay/Physics/Colliders/ConeCollider.h"
 #include "Gameplay/Physics/Colliders/CylinderCollider.h"
 #include "Gameplay/Physics/Colliders/ConvexMeshCollider.h"
+#include "Gameplay/Physics/Colliders/HeightfieldCollider.h"
 
 namespace Gameplay::Physics {
 	const char* ColliderTypeComboNames = "Plane\0Box\0Sphere\0Capsule\0Cone\0Cylinder\0Convex Mesh\0\0Concave Mesh\0Terrain\0";
@@ -21,6 +24,8 @@ namespace Gameplay::Physics {
 	ICollider::ICollider(ColliderType type) :
 		_type(type),
 		_shape(nullptr),
+		_isDirty(true),
+		_owner(nullptr),
 		_position(glm::vec3(0.0f)),
 		_rotation(glm::vec3(0.0f)),
 		_scale(glm::vec3(1.0f)),
@@ -34,6 +39,13 @@ namespace Gameplay::Physics {
 		}
 	}
 
+	void ICollider::_MarkDirty() {
+		_isDirty = true;
+		if (_owner != nullptr) {
+			_owner->_MarkPhysicsDirty();
+		}
+	}
+
 	ColliderType ICollider::GetType() const {
 		return _type;
 	}
@@ -47,7 +59,7 @@ namespace Gameplay::Physics {
 
 	ICollider* ICollider::SetPosition(const glm::vec3& value) {
 		_position = value;
-		_isDirty  = true;
+		_MarkDirty();
 		return this;
 	}
 
@@ -57,7 +69,7 @@ namespace Gameplay::Physics {
 
 	ICollider* ICollider::SetRotation(const glm::vec3& value) {
 		_rotation = glm::fmod(value, DEGREE_MAX);
-		_isDirty = true;
+		_MarkDirty();
 		return this;
 	}
 
@@ -67,7 +79,7 @@ namespace Gameplay::Physics {
 
 	ICollider* ICollider::SetScale(const glm::vec3& value) {
 		_scale = value;
-		_isDirty = true;
+		_MarkDirty();
 		return this;
 	}
 
@@ -90,7 +102,7 @@ namespace Gameplay::Physics {
 			case ColliderType::Cylinder:    return CylinderCollider::Create();
 			case ColliderType::ConvexMesh:  return ConvexMeshCollider::Create();
 			case ColliderType::ConcaveMesh: throw std::runtime_error("Collider type not supported!"); return nullptr;
-			case ColliderType::Terrain:     throw std::runtime_error("Collider type not supported!"); return nullptr;
+			case ColliderType::Terrain:     return HeightfieldCollider::Create();
 			case ColliderType::Unknown:
 			default:
 				return nullptr;
@@ -30,8 +30,7 @@ ENUM(ColliderType, int,
 	 ConvexMesh = 7,
 	 // Concave meshes can have inward faces (NOT IMPLEMENTED)
 	 ConcaveMesh = 8,
-	 // Used for creating terrain colliders,
-	 // much more complex than the other colliders (NOT IMPLEMENTED)
+	 // Used for creating terrain colliders from a grid of heights
 	 Terrain   = 9
 );
 
@@ -40,6 +39,8 @@ namespace Gameplay {
 }
 
 namespace Gameplay::Physics {
+	class PhysicsBase;
+
 	// Stores a string that can be fed to ImGui to make a combo box
 	// of all collider types
 	extern const char* ColliderTypeComboNames;
@@ -147,6 +148,8 @@ namespace Gameplay::Physics {
 		// Stores shape, note that mutable lets us modify in const functions
 		mutable btCollisionShape* _shape;
 		mutable bool _isDirty;
+		// The body that this collider is attached to, if any
+		PhysicsBase* _owner;
 
 		ICollider(ColliderType type);
 
@@ -156,6 +159,11 @@ namespace Gameplay::Physics {
 		/// <returns>A btCollisionShape allocated with new</returns>
 		virtual btCollisionShape* CreateShape() const = 0;
 
+		/// <summary>
+		/// Flags the shape to be re-created, and lets the body we're attached to know that it needs to handle it
+		/// </summary>
+		void _MarkDirty();
+
 	private:
 		// Allow RigidBody to access protected and private members
 		friend class PhysicsBase;
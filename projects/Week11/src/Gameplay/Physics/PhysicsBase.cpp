@@ -18,10 +18,19 @@ int PhysicsBase::_editorSelectedColliderType = 0;
 		_isShapeDirty(true),
 		_collisionGroup(0x01),
 		_collisionMask(0xFFFFFFFF),
-		_prevScale(glm::vec3(1.0f))
+		_prevScale(glm::vec3(1.0f)),
+		_syncedTransformVersion(0),
+		_isPhysicsDirty(false),
+		_physicsDirtyIndex(0)
 	{ }
 
 	PhysicsBase::~PhysicsBase() {
+		if (_isPhysicsDirty) {
+			_RemoveFromDirtyList();
+		}
+		for (auto& collider : _colliders) {
+			collider->_owner = nullptr;
+		}
 		if (_scene != nullptr) {
 			delete _shape;
 		}
@@ -108,6 +117,7 @@ int PhysicsBase::_editorSelectedColliderType = 0;
 					collider->FromJson(blob);
 					// Mark dirty and store
 					collider->_isDirty = true;
+					collider->_owner = this;
 					_colliders.push_back(collider);
 				}
 			}
@@ -118,11 +128,13 @@ int PhysicsBase::_editorSelectedColliderType = 0;
 	void PhysicsBase::SetCollisionGroup(int value) {
 		_collisionGroup = 1 << value;
 		_isGroupMaskDirty = true;
+		_MarkPhysicsDirty();
 	}
 
 	void PhysicsBase::SetCollisionGroupMulti(int value) {
 		_collisionGroup   = value;
 		_isGroupMaskDirty = true;
+		_MarkPhysicsDirty();
 	}
 
 	int PhysicsBase::GetCollisionGroup() const {
@@ -132,6 +144,7 @@ int PhysicsBase::_editorSelectedColliderType = 0;
 	void PhysicsBase::SetCollisionMask(int value) {
 		_collisionMask = value;
 		_isGroupMaskDirty = true;
+		_MarkPhysicsDirty();
 	}
 
 	int PhysicsBase::GetCollisionMask() const {
@@ -142,8 +155,10 @@ int PhysicsBase::_editorSelectedColliderType = 0;
 		if (_scene != nullptr) {
 			collider->Awake(GetGameObject());
 		}
+		collider->_owner = this;
 		_colliders.push_back(collider);
 		_isShapeDirty = true;
+		_MarkPhysicsDirty();
 		return collider;
 	}
 
@@ -153,7 +168,9 @@ int PhysicsBase::_editorSelectedColliderType = 0;
 			if (collider->GetShape() != nullptr) {
 				_shape->removeChildShape(collider->GetShape());
 				_isShapeDirty = true;
+				_MarkPhysicsDirty();
 			}
+			collider->_owner = nullptr;
 			_colliders.erase(it);
 		}
 	}
@@ -186,6 +203,28 @@ int PhysicsBase::_editorSelectedColliderType = 0;
 		}
 	}
 
+	void PhysicsBase::_MarkPhysicsDirty() {
+		// Bodies that haven't awoken yet are handled by Awake
+		if (_isPhysicsDirty || _scene == nullptr) return;
+
+		_isPhysicsDirty = true;
+		_physicsDirtyIndex = _scene->_dirtyPhysics.size();
+		_scene->_dirtyPhysics.push_back(this);
+	}
+
+	void PhysicsBase::_RemoveFromDirtyList() {
+		std::vector<PhysicsBase*>& dirty = _scene->_dirtyPhysics;
+		LOG_ASSERT(_physicsDirtyIndex < dirty.size() && dirty[_physicsDirtyIndex] == this, "Dirty body index is out of sync!");
+
+		// Swap the last body into our slot and pop, so removal doesn't need to search the list
+		PhysicsBase* last = dirty.back();
+		dirty[_physicsDirtyIndex] = last;
+		last->_physicsDirtyIndex = _physicsDirtyIndex;
+		dirty.pop_back();
+
+		_isPhysicsDirty = false;
+	}
+
 	bool PhysicsBase::_HandleShapeDirty() {
 		bool wasDirty = false;
 		for (auto& collider : _colliders) {
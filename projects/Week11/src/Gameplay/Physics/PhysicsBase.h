@@ -6,6 +6,7 @@ class btTransform;
 
 namespace Gameplay {
 	class Scene;
+	class GameObject;
 
 	namespace Physics {
 		/// <summary>
@@ -71,8 +72,8 @@ namespace Gameplay {
 
 
 			/// <summary>
-			/// Invoked for each RigidBody before the physics world is stepped forward a frame,
-			/// handles body initialization, shape changes, mass changes, etc...
+			/// Invoked before the physics world is stepped forward a frame, for bodies that have changed since
+			/// the last frame (see _MarkPhysicsDirty). Handles shape changes, mass changes, moving the body, etc...
 			/// </summary>
 			/// <param name="dt">The time in seconds since the last frame</param>
 			virtual void PhysicsPreStep(float dt) = 0;
@@ -87,6 +88,10 @@ namespace Gameplay {
 
 			virtual void Awake() = 0;
 		protected:
+			friend class Gameplay::Scene;
+			friend class Gameplay::GameObject;
+			friend class ICollider;
+
 			Scene*        _scene;
 
 			// Stores the bullet shape associated with the physics object
@@ -102,6 +107,13 @@ namespace Gameplay {
 			mutable bool _isGroupMaskDirty;
 
 			glm::vec3 _prevScale;
+			// The gameobject's transform version when we last synced with it, so that we only need to push
+			// the transform to bullet when the object has actually moved
+			uint32_t  _syncedTransformVersion;
+			// True if we're in the scene's list of bodies to pre-step next frame
+			bool      _isPhysicsDirty;
+			// Our index in the scene's list of bodies to pre-step, only valid while _isPhysicsDirty is set
+			size_t    _physicsDirtyIndex;
 
 			PhysicsBase();
 
@@ -113,6 +125,16 @@ namespace Gameplay {
 			// Handles adding a collider to our compound shape
 			void _AddColliderToShape(ICollider* collider);
 
+			/// <summary>
+			/// Adds this object to the scene's list of bodies to pre-step next frame. Should be called whenever
+			/// something that PhysicsPreStep handles has changed (our gameobject moved, colliders, settings, etc...)
+			/// </summary>
+			void _MarkPhysicsDirty();
+			/// <summary>
+			/// Removes this object from the scene's list of bodies to pre-step
+			/// </summary>
+			void _RemoveFromDirtyList();
+
 			// Handles resolving any dirty state stuff for our object
 			bool _HandleShapeDirty();
 
@@ -0,0 +1,75 @@
+#pragma once
+#include <vector>
+#include <GLM/glm.hpp>
+
+#include "Gameplay/GameObject.h"
+
+namespace Gameplay::Physics {
+	/// <summary>
+	/// A ray to cast through the physics world, the closest hit along the ray is reported
+	/// </summary>
+	struct RayQuery {
+		glm::vec3 From;
+		glm::vec3 To;
+		// Only objects whose collision group overlaps this mask will be hit
+		int       CollisionMask = -1;
+		// If true, trigger volumes will also be hit
+		bool      HitTriggers = false;
+	};
+
+	/// <summary>
+	/// A sphere to sweep through the physics world, the first object the sphere touches is reported
+	/// </summary>
+	struct SphereCastQuery {
+		glm::vec3 From;
+		glm::vec3 To;
+		float     Radius = 0.5f;
+		// Only objects whose collision group overlaps this mask will be hit
+		int       CollisionMask = -1;
+		// If true, trigger volumes will also be hit
+		bool      HitTriggers = false;
+	};
+
+	/// <summary>
+	/// A sphere to test against the physics world, all objects touching the sphere are reported
+	/// </summary>
+	struct OverlapQuery {
+		glm::vec3 Center;
+		float     Radius = 0.5f;
+		// Only objects whose collision group overlaps this mask will be reported
+		int       CollisionMask = -1;
+		// If true, trigger volumes will also be reported
+		bool      HitTriggers = false;
+	};
+
+	/// <summary>
+	/// The result of a ray or sphere cast, one is produced for every query
+	/// </summary>
+	struct QueryHit {
+		// The object that was hit, empty if the query did not hit anything
+		GameObject::WeakRef Object;
+		// The point of contact in world space
+		glm::vec3           Point = glm::vec3(0.0f);
+		// The surface normal at the point of contact
+		glm::vec3           Normal = glm::vec3(0.0f);
+		// How far along the query the hit was, from 0 (at From) to 1 (at To)
+		float               Fraction = 1.0f;
+
+		bool HasHit() const { return !Object.GetIsEmpty(); }
+	};
+
+	/// <summary>
+	/// The results of a batch of overlap queries, stored in a single flat list. The objects touching
+	/// query i are Objects[Offsets[i]] up to (but not including) Objects[Offsets[i + 1]]
+	/// </summary>
+	struct OverlapResults {
+		std::vector<GameObject::WeakRef> Objects;
+		// Has one more element than there were queries
+		std::vector<uint32_t>            Offsets;
+
+		/// <summary>
+		/// Gets the number of objects touching the given query
+		/// </summary>
+		uint32_t Count(size_t query) const { return Offsets[query + 1] - Offsets[query]; }
+	};
+}
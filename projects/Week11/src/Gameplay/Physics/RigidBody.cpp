@@ -27,10 +27,19 @@ namespace Gameplay::Physics {
 		_angularVelocity(btVector3(0, 0, 0)),
 		_angularVelocityDirty(false),
 		_angularFactor(btVector3(1,1,1)),
-		_angularFactorDirty(false)
+		_angularFactorDirty(false),
+		_currentTransform(btTransform::getIdentity()),
+		_previousTransform(btTransform::getIdentity()),
+		_lastMovedStep(0),
+		_isMoving(false),
+		_movingIndex(0)
 	{ }
 
 	RigidBody::~RigidBody() {
+		if (_isMoving) {
+			_RemoveFromMovingList();
+		}
+
 		if (_body != nullptr) {
 			// Remove from the physics world
 			_scene->GetPhysicsWorld()->removeRigidBody(_body);
@@ -46,6 +55,7 @@ namespace Gameplay::Physics {
 		if (_type != RigidBodyType::Static) {
 			_isMassDirty = value != _mass;
 			_mass = value;
+			_MarkPhysicsDirty();
 		}
 	}
 
@@ -56,6 +66,7 @@ namespace Gameplay::Physics {
 	void RigidBody::SetLinearDamping(float value) {
 		_linearDamping = value;
 		_isDampingDirty = true;
+		_MarkPhysicsDirty();
 	}
 
 	float RigidBody::GetLinearDamping() const {
@@ -65,6 +76,7 @@ namespace Gameplay::Physics {
 	void RigidBody::SetAngularDamping(float value) {
 		_angularDamping = value;
 		_isDampingDirty = true;
+		_MarkPhysicsDirty();
 	}
 
 	float RigidBody::GetAngularDamping() const {
@@ -75,6 +87,7 @@ namespace Gameplay::Physics {
 	{
 		_linearVelocity = ToBt(value);
 		_linearVelocityDirty = true;
+		_MarkPhysicsDirty();
 	}
 
 	glm::vec3 RigidBody::GetLinearVelocity() const {
@@ -84,6 +97,7 @@ namespace Gameplay::Physics {
 	void RigidBody::SetAngularVelocity(const glm::vec3& value) {
 		_angularVelocity = ToBt(glm::radians(value));
 		_angularVelocityDirty = true;
+		_MarkPhysicsDirty();
 	}
 
 	glm::vec3 RigidBody::GetAngularVelocity() const
@@ -94,6 +108,7 @@ namespace Gameplay::Physics {
 	void RigidBody::SetAngularFactor(const glm::vec3& value) {
 		_angularFactor = ToBt(value);
 		_angularFactorDirty = true;
+		_MarkPhysicsDirty();
 	}
 
 	const glm::vec3& RigidBody::GetAngularFactor() const {
@@ -126,6 +141,7 @@ namespace Gameplay::Physics {
 
 	void RigidBody::SetType(RigidBodyType type) {
 		_type = type;
+		_MarkPhysicsDirty();
 		if (_body != nullptr) {
 			// Remove any static or kinematic flags for the object
 			int flags = _body->getCollisionFlags() & ~btCollisionObject::CF_STATIC_OBJECT;
@@ -158,29 +174,52 @@ namespace Gameplay::Physics {
 		// Update any dirty state that may have changed
 		_HandleStateDirty();
 
-		if (_type != RigidBodyType::Static) {		
+		// Statics don't move, and we only need to push our transform to bullet if something has moved the object
+		// since we last synced (note that the gameobject holds the interpolated transform that we gave it, which
+		// lags behind the body, so pushing it every frame would also drag the body backwards)
+		GameObject* context = GetGameObject();
+		if (_type != RigidBodyType::Static && context->GetTransformVersion() != _syncedTransformVersion) {
 			btTransform transform;
 			_CopyGameobjectTransformTo(transform);
 
 			// Copy to body and to it's motion state
 			if (_type == RigidBodyType::Dynamic) {
 				_body->setWorldTransform(transform);
+				// Don't blend from where we were before being moved
+				_currentTransform = transform;
+				_previousTransform = transform;
 			} else {
 				// Kinematics prefer to be driven my motion state for some reason :|
-				_body->getMotionState()->setWorldTransform(transform); 
+				_motionState->Transform = transform;
 			}
+			_syncedTransformVersion = context->GetTransformVersion();
 		}
 	}
 
 	void RigidBody::PhysicsPostStep(float dt) {
-		// Kinematics are driven externally and statics don't move, so only need to get data out for dynamics!
-		if (_type == RigidBodyType::Dynamic && _body->isActive()) {
-			btTransform transform = _body->getWorldTransform();
-			_CopyGameobjectTransformFrom(transform);
-
-			// Store a copy of our velocities
-			_linearVelocity = _body->getLinearVelocity();
-			_angularVelocity = _body->getAngularVelocity();
+		// Only dynamic bodies are ever added to the moving list, since kinematics are driven externally and
+		// statics don't move, so only need to get data out for dynamics!
+		btTransform transform;
+		bool movedLastStep = _lastMovedStep == _scene->_physicsStepCount;
+		if (movedLastStep) {
+			// Blend between our last 2 physics states, based on how far we are towards the next step
+			float alpha = _scene->GetPhysicsInterpolation();
+			transform.setOrigin(_previousTransform.getOrigin().lerp(_currentTransform.getOrigin(), alpha));
+			transform.setRotation(_previousTransform.getRotation().slerp(_currentTransform.getRotation(), alpha));
+		} else {
+			// We didn't move in the last step, so we've come to rest and can snap to our final state
+			transform = _currentTransform;
+		}
+		_CopyGameobjectTransformFrom(transform);
+		_syncedTransformVersion = GetGameObject()->GetTransformVersion();
+
+		// Store a copy of our velocities
+		_linearVelocity = _body->getLinearVelocity();
+		_angularVelocity = _body->getAngularVelocity();
+
+		// Once we're at rest, we don't need to do anything until bullet moves us again
+		if (!movedLastStep) {
+			_RemoveFromMovingList();
 		}
 	}
 
@@ -207,15 +246,19 @@ namespace Gameplay::Physics {
 		_shape->calculateLocalInertia(_mass, _inertia);
 		_isMassDirty = false;
 
-		// Create a default motion state instance for tracking the bodies motion
-		_motionState = new btDefaultMotionState();
-
 		// Get the object's starting transform, create a bullet representation for it
 		btTransform transform; 
 		transform.setIdentity();
 		transform.setOrigin(ToBt(context->GetPosition()));
 		transform.setRotation(ToBt(context->GetRotation()));
-		_motionState->setWorldTransform(transform);
+
+		// Create a motion state instance for tracking the bodies motion
+		_motionState = new MotionState(this, transform);
+
+		// We start out at rest, with the gameobject in sync with the body
+		_currentTransform = transform;
+		_previousTransform = transform;
+		_syncedTransformVersion = context->GetTransformVersion();
 
 		// Create the bullet rigidbody and add it to the physics scene
 		_body = new btRigidBody(_mass, _motionState, _shape, _inertia);
@@ -244,6 +287,9 @@ namespace Gameplay::Physics {
 		// Copy over group and mask info
 		_body->getBroadphaseProxy()->m_collisionFilterGroup = _collisionGroup;
 		_body->getBroadphaseProxy()->m_collisionFilterMask  = _collisionMask;
+
+		// Pre-step once, to handle any collider changes made after loading
+		_MarkPhysicsDirty();
 	}
 
 	void RigidBody::RenderImGui()
@@ -266,6 +312,9 @@ namespace Gameplay::Physics {
 			ImGui::EndCombo();
 		}
 		_RenderImGuiBase();
+
+		// The editor changes our settings and colliders directly, so we make sure they get handled
+		_MarkPhysicsDirty();
 	}
 
 	nlohmann::json RigidBody::ToJson() const {
@@ -338,6 +387,48 @@ namespace Gameplay::Physics {
 		}
 	}
 
+	void RigidBody::_OnPhysicsMoved() {
+		// Bullet only calls this once it has finished the step, so the body's transform is final
+		_previousTransform = _currentTransform;
+		_currentTransform = _body->getWorldTransform();
+		_lastMovedStep = _scene->_physicsStepCount;
+
+		if (!_isMoving) {
+			_isMoving = true;
+			_movingIndex = _scene->_movingBodies.size();
+			_scene->_movingBodies.push_back(this);
+		}
+	}
+
+	void RigidBody::_RemoveFromMovingList() {
+		std::vector<RigidBody*>& moving = _scene->_movingBodies;
+		LOG_ASSERT(_movingIndex < moving.size() && moving[_movingIndex] == this, "Moving body index is out of sync!");
+
+		// Swap the last body into our slot and pop, so removal doesn't need to search the list
+		RigidBody* last = moving.back();
+		moving[_movingIndex] = last;
+		last->_movingIndex = _movingIndex;
+		moving.pop_back();
+
+		_isMoving = false;
+	}
+
+	RigidBody::MotionState::MotionState(RigidBody* owner, const btTransform& transform) :
+		btMotionState(),
+		Transform(transform),
+		_owner(owner)
+	{ }
+
+	void RigidBody::MotionState::getWorldTransform(btTransform& worldTrans) const {
+		worldTrans = Transform;
+	}
+
+	void RigidBody::MotionState::setWorldTransform(const btTransform& worldTrans) {
+		// Bullet only calls this for dynamic bodies that are awake, after each step
+		Transform = worldTrans;
+		_owner->_OnPhysicsMoved();
+	}
+
 	btBroadphaseProxy* RigidBody::_GetBroadphaseHandle() {
 		return _body != nullptr ? _body->getBroadphaseProxy() : nullptr;
 	}
@@ -159,8 +159,9 @@ namespace Gameplay::Physics {
 		/// <param name="dt">The time in seconds since the last frame</param>
 		virtual void PhysicsPreStep(float dt) override;
 		/// <summary>
-		/// Invoked for each RigidBody after the physics world is stepped forward a frame,
-		/// handles copying transform to the OpenGL state
+		/// Invoked after the physics world is stepped forward a frame, for dynamic bodies that bullet
+		/// has moved recently. Handles copying transform to the OpenGL state, blending between the
+		/// last 2 physics states using the scene's physics interpolation
 		/// </summary>
 		/// <param name="dt">The time in seconds since the last frame</param>
 		virtual void PhysicsPostStep(float dt) override;
@@ -187,9 +188,27 @@ namespace Gameplay::Physics {
 		float _linearDamping;
 		mutable bool _isDampingDirty;
 
+		/// <summary>
+		/// Stores the transform for kinematic bodies, and lets bullet notify us when it moves dynamic
+		/// bodies, so that we only need to copy back transforms for bodies that are actually moving
+		/// </summary>
+		class MotionState : public btMotionState {
+		public:
+			btTransform Transform;
+
+			MotionState(RigidBody* owner, const btTransform& transform);
+
+			// Inherited from btMotionState
+			virtual void getWorldTransform(btTransform& worldTrans) const override;
+			virtual void setWorldTransform(const btTransform& worldTrans) override;
+
+		private:
+			RigidBody* _owner;
+		};
+
 		// Our bullet state stuff
 		btRigidBody*     _body;
-		btMotionState*   _motionState;
+		MotionState*     _motionState;
 		btVector3        _inertia;
 		btVector3        _linearVelocity;
 		bool             _linearVelocityDirty;
@@ -198,9 +217,28 @@ namespace Gameplay::Physics {
 		btVector3        _angularFactor;
 		bool             _angularFactorDirty;
 
+		// The body's transform after the last step that it moved in, and before that step, used for interpolation
+		btTransform      _currentTransform;
+		btTransform      _previousTransform;
+		// The scene's physics step count the last time bullet moved us
+		uint32_t         _lastMovedStep;
+		// True if we're in the scene's list of moving bodies
+		bool             _isMoving;
+		// Our index in the scene's list of moving bodies, only valid while _isMoving is set
+		size_t           _movingIndex;
+
 		// Handles resolving any dirty state stuff for our object
 		void _HandleStateDirty();
 
+		/// <summary>
+		/// Invoked by our motion state when bullet has moved the body during a physics step
+		/// </summary>
+		void _OnPhysicsMoved();
+		/// <summary>
+		/// Removes this body from the scene's list of moving bodies
+		/// </summary>
+		void _RemoveFromMovingList();
+
 		virtual btBroadphaseProxy* _GetBroadphaseHandle() override;
 	};
 }
\ No newline at end of file
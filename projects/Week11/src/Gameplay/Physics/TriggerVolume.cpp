@@ -1,5 +1,6 @@
 #include "Gameplay/Physics/TriggerVolume.h"
 
+#include <algorithm>
 #include <BulletCollision/CollisionDispatch/btGhostObject.h>
 
 #include "Utils/GlmBulletConversions.h"
@@ -12,7 +13,9 @@ namespace Gameplay::Physics {
 	TriggerVolume::TriggerVolume() :
 		PhysicsBase(),
 		_ghost(nullptr),
-		_typeFlags(TriggerTypeFlags::Dynamics)
+		_typeFlags(TriggerTypeFlags::Dynamics),
+		_currentCollisions(std::vector<Contact>()),
+		_frameCollisions(std::vector<Contact>())
 	{
 	}
 
@@ -28,114 +31,141 @@ namespace Gameplay::Physics {
 		_HandleShapeDirty();
 		_HandleGroupDirty();
 
-		// Copy our transform info from OpenGL
+		// Copy our transform info from OpenGL, if the object has moved since we last did
 		GameObject* context = GetGameObject();
-		btTransform transform;
-		_CopyGameobjectTransformTo(transform);
+		if (context->GetTransformVersion() != _syncedTransformVersion) {
+			btTransform transform;
+			_CopyGameobjectTransformTo(transform);
 
-		_ghost->setWorldTransform(transform);
+			_ghost->setWorldTransform(transform);
+			_syncedTransformVersion = context->GetTransformVersion();
+		}
 	}
 
 	void TriggerVolume::PhysicsPostStep(float dt) {
-		// This will store all the objects inside the trigger this frame
-		std::vector<std::weak_ptr<RigidBody>> thisFrameCollision;
-
-		// Get all our collisions from from the world
-		_scene->GetPhysicsWorld()->getDispatcher()->dispatchAllCollisionPairs(_ghost->getOverlappingPairCache(), _scene->GetPhysicsWorld()->getDispatchInfo(), _scene->GetPhysicsWorld()->getDispatcher());
-		btBroadphasePairArray& collisionPairs = _ghost->getOverlappingPairCache()->getOverlappingPairArray();
+		// Gather the objects that are touching the volume this frame into our scratch list
+		_frameCollisions.clear();
 
-		// Determine how many objects are intersecting the volume
-		const int numObjects=collisionPairs.size();
-		thisFrameCollision.reserve(numObjects);
+		// The ghost tracks which objects overlap our bounds, but the world's dispatcher has already run the
+		// narrowphase for those pairs during the step, so rather than running it again we look up the world's
+		// copy of each pair and check it's contact manifolds
+		btOverlappingPairCache* worldPairs = _scene->GetPhysicsWorld()->getPairCache();
 
 		// Will store our contact manifolds, can be static to be shared between frames and instances
 		static btManifoldArray	m_manifoldArray;
 
 		// Iterate over all the objects that we're colliding with
+		const int numObjects = _ghost->getNumOverlappingObjects();
 		for (int i = 0; i < numObjects; ++i) {
-			// resize the number of manifolds to zero for everything we collide with
-			m_manifoldArray.resize(0);
-
 			// Get the btCollisionObject that we're colliding with
 			btCollisionObject *obj = _ghost->getOverlappingObject(i);
 
-			// Get the contact pair and resolve contact manifolds
-			btBroadphasePair* pair = &collisionPairs[i];
-			if (pair != nullptr && pair->m_algorithm != nullptr) {
-				pair->m_algorithm->getAllContactManifolds(m_manifoldArray);
-			} else {
+			// We only care about rigid bodies (no trigger-trigger interactions), and we need to check the
+			// object's group against our mask since this isn't filtered for us
+			if (obj->getInternalType() != btCollisionObject::CO_RIGID_BODY ||
+				(obj->getBroadphaseHandle()->m_collisionFilterGroup & _collisionMask) == 0) {
 				continue;
 			}
 
+			// Make sure that the object is not a kinematic or static object (note: you may want
+			// to modify this behaviour depending on your game)
+			if (!(((obj->getCollisionFlags() & btCollisionObject::CF_STATIC_OBJECT & btCollisionObject::CF_KINEMATIC_OBJECT) == 0) ||
+				((obj->getCollisionFlags() & btCollisionObject::CF_STATIC_OBJECT) == *(_typeFlags & TriggerTypeFlags::Statics)) ||
+				((obj->getCollisionFlags() & btCollisionObject::CF_KINEMATIC_OBJECT) == *(_typeFlags & TriggerTypeFlags::Kinematics)))) {
+				continue;
+			}
+
+			// Find the world's version of the pair, if the world doesn't have it (or hasn't created an algorithm
+			// for it yet) then the narrowphase hasn't found anything
+			btBroadphasePair* pair = worldPairs->findPair(_ghost->getBroadphaseHandle(), obj->getBroadphaseHandle());
+			if (pair == nullptr || pair->m_algorithm == nullptr) {
+				continue;
+			}
+
+			// resize the number of manifolds to zero for everything we collide with
+			m_manifoldArray.resize(0);
+			pair->m_algorithm->getAllContactManifolds(m_manifoldArray);
+
 			// Iterate over all the contact manifolds and check if any of them have contacts
-			bool hasCollision = false;
-			for (int j=0; j < m_manifoldArray.size(); j++) {
+			for (int j = 0; j < m_manifoldArray.size(); j++) {
 				btPersistentManifold* manifold = m_manifoldArray[j];
 				if (manifold != nullptr && manifold->getNumContacts() > 0) {
-					hasCollision = true;
+					_frameCollisions.push_back({ obj, std::weak_ptr<RigidBody>(), false });
 					break;
 				}
 			}
+		}
 
-			// If we have contacts and the object's group matches our mask (since this isn't filtered for us)
-			if (hasCollision && (obj->getBroadphaseHandle()->m_collisionFilterGroup & _collisionMask)) {
-				// Make sure the internal type is a bullet rigid body (no trigger-trigger interactions)
-				if (obj->getInternalType() == btCollisionObject::CO_RIGID_BODY) {
-					// Get the collision object as a btRigidBody
-					const btRigidBody *body = (const btRigidBody *)obj;
-
-					// Make sure that the object is not a kinematic or static object (note: you may want
-					// to modify this behaviour depending on your game)
-					if (((body->getCollisionFlags() & btCollisionObject::CF_STATIC_OBJECT & btCollisionObject::CF_KINEMATIC_OBJECT) == 0) ||
-						((body->getCollisionFlags() & btCollisionObject::CF_STATIC_OBJECT) == *(_typeFlags & TriggerTypeFlags::Statics)) ||
-						((body->getCollisionFlags() & btCollisionObject::CF_KINEMATIC_OBJECT) == *(_typeFlags & TriggerTypeFlags::Kinematics))) {
-
-						// Extract the weak pointer that we stored in all our rigidbody user pointers
-						std::weak_ptr<IComponent> rawPtr = *reinterpret_cast<std::weak_ptr<IComponent>*>(body->getUserPointer());
-						// Cast lock the raw pointer and cast up to a RigidBody
-						std::shared_ptr<RigidBody> physicsPtr = std::dynamic_pointer_cast<RigidBody>(rawPtr.lock());
-
-						// As long as we got a pointer out, we can proceed to try and invoke
-						if (physicsPtr != nullptr && physicsPtr->GetGameObject() != GetGameObject()) {
-							// Add the object to the known collisions for this frame
-							thisFrameCollision.push_back(physicsPtr);
-
-							// Check to see if the object has been added to our object cache
-							auto& it = std::find_if(_currentCollisions.begin(), _currentCollisions.end(), [&](const std::weak_ptr<RigidBody>& item) {
-								return item.lock() == physicsPtr;
-							});
-
-							// If the object is NOT in the cache, we invoke all the callbacks
-							if (it == _currentCollisions.end()) {
-								physicsPtr->GetGameObject()->OnEnteredTrigger(std::dynamic_pointer_cast<TriggerVolume>(SelfRef().lock()));
-								GetGameObject()->OnTriggerVolumeEntered(physicsPtr);
-							}
-						}
-					}
-				}
+		// Sort this frame's objects so that we can walk it alongside last frame's (which is already sorted)
+		std::sort(_frameCollisions.begin(), _frameCollisions.end(), [](const Contact& a, const Contact& b) {
+			return a.Object < b.Object;
+		});
 
+		TriggerVolume::Sptr self = nullptr;
+		auto getSelf = [&]() -> const TriggerVolume::Sptr& {
+			if (self == nullptr) {
+				self = std::static_pointer_cast<TriggerVolume>(SelfRef().lock());
 			}
-		}
-	
-		// Compare our current frame list to the previous frame to see if anything has left
-		for (auto& weakPtr : _currentCollisions) {
-			// Search the the current list to see if the item still exists
-			auto& it = std::find_if(thisFrameCollision.begin(), thisFrameCollision.end(), [&](const std::weak_ptr<RigidBody>& item) {
-				return item.lock() == weakPtr.lock();
-			});
-
-			// If the item no longer exists in the list, we need to invoke exit callbacks
-			if (it == thisFrameCollision.end()) {
-				RigidBody::Sptr body = weakPtr.lock();
-				if (body != nullptr) {
-					body->GetGameObject()->OnLeavingTrigger(std::dynamic_pointer_cast<TriggerVolume>(SelfRef().lock()));
-					GetGameObject()->OnTriggerVolumeLeaving(body);
-				}
+			return self;
+		};
+
+		// Walk both sorted lists at once, anything only in this frame's list has entered, and anything only in
+		// last frame's list has left. Objects in both carry their state over without needing to be looked up
+		size_t prev = 0;
+		for (Contact& contact : _frameCollisions) {
+			// Anything in last frame's list that comes before this object is no longer touching us
+			while (prev < _currentCollisions.size() && _currentCollisions[prev].Object < contact.Object) {
+				_OnContactLeft(_currentCollisions[prev], getSelf());
+				prev++;
+			}
+
+			// If the object was already touching us, we keep it's state. If the component has since died, this is a
+			// new body that happens to have been given the same address, so we treat it like it just entered
+			if (prev < _currentCollisions.size() && _currentCollisions[prev].Object == contact.Object &&
+				(_currentCollisions[prev].IsSelf || !_currentCollisions[prev].Body.expired())) {
+				contact = _currentCollisions[prev];
+				prev++;
+				continue;
+			}
+			if (prev < _currentCollisions.size() && _currentCollisions[prev].Object == contact.Object) {
+				prev++;
+			}
+
+			// Extract the weak pointer that we stored in all our rigidbody user pointers. Only RigidBody
+			// creates btRigidBody instances, so the static cast is safe
+			std::weak_ptr<IComponent> rawPtr = *reinterpret_cast<std::weak_ptr<IComponent>*>(contact.Object->getUserPointer());
+			std::shared_ptr<RigidBody> physicsPtr = std::static_pointer_cast<RigidBody>(rawPtr.lock());
+			if (physicsPtr == nullptr) {
+				continue;
 			}
+			contact.Body = physicsPtr;
+
+			// We still track bodies attached to our own gameobject so we don't look them up every frame, but they
+			// never trigger events
+			contact.IsSelf = physicsPtr->GetGameObject() == GetGameObject();
+			if (!contact.IsSelf) {
+				physicsPtr->GetGameObject()->OnEnteredTrigger(getSelf());
+				GetGameObject()->OnTriggerVolumeEntered(physicsPtr);
+			}
+		}
+
+		// Anything left over in last frame's list is no longer touching us
+		for (; prev < _currentCollisions.size(); prev++) {
+			_OnContactLeft(_currentCollisions[prev], getSelf());
 		}
 
-		// Load the contents of the current collision items into the cache
-		_currentCollisions.swap(thisFrameCollision);
+		// This frame's list becomes the current list, and we keep the old storage around for next frame
+		_currentCollisions.swap(_frameCollisions);
+	}
+
+	void TriggerVolume::_OnContactLeft(const Contact& contact, const TriggerVolume::Sptr& self) {
+		if (contact.IsSelf) return;
+
+		RigidBody::Sptr body = contact.Body.lock();
+		if (body != nullptr) {
+			body->GetGameObject()->OnLeavingTrigger(self);
+			GetGameObject()->OnTriggerVolumeLeaving(body);
+		}
 	}
 
 	void TriggerVolume::Awake() {
@@ -166,6 +196,7 @@ namespace Gameplay::Physics {
 		btTransform transform;
 		_CopyGameobjectTransformTo(transform);
 		_ghost->setWorldTransform(transform);
+		_syncedTransformVersion = context->GetTransformVersion();
 
 		// Add the object to the scene
 		_scene->GetPhysicsWorld()->addCollisionObject(_ghost);
@@ -173,10 +204,16 @@ namespace Gameplay::Physics {
 		// Copy over group and mask info
 		_ghost->getBroadphaseHandle()->m_collisionFilterGroup = _collisionGroup;
 		_ghost->getBroadphaseHandle()->m_collisionFilterMask  = _collisionMask;
+
+		// Pre-step once, to handle any collider changes made after loading
+		_MarkPhysicsDirty();
 	}
 
 	void TriggerVolume::RenderImGui() {
 		_RenderImGuiBase();
+
+		// The editor changes our colliders directly, so we make sure they get handled
+		_MarkPhysicsDirty();
 	}
 
 	nlohmann::json TriggerVolume::ToJson() const {
@@ -5,6 +5,7 @@
 #include "EnumToString.h"
 
 class btPairCachingGhostObject;
+class btCollisionObject;
 
 namespace Gameplay::Physics {
 
@@ -33,8 +34,8 @@ namespace Gameplay::Physics {
 		/// <param name="dt">The time in seconds since the last frame</param>
 		virtual void PhysicsPreStep(float dt) override;
 		/// <summary>
-		/// Invoked for each RigidBody after the physics world is stepped forward a frame,
-		/// handles copying transform to the OpenGL state
+		/// Invoked for each TriggerVolume after the physics world has taken at least one step, handles
+		/// invoking the enter and leave callbacks for bodies touching the volume
 		/// </summary>
 		/// <param name="dt">The time in seconds since the last frame</param>
 		virtual void PhysicsPostStep(float dt) override;
@@ -54,9 +55,26 @@ namespace Gameplay::Physics {
 		btPairCachingGhostObject*   _ghost;
 		TriggerTypeFlags            _typeFlags;
 
-		std::vector<std::weak_ptr<RigidBody>> _currentCollisions;
+		// An object that is touching the volume
+		struct Contact {
+			const btCollisionObject*  Object;
+			std::weak_ptr<RigidBody>  Body;
+			// True if the body is attached to the same gameobject as the trigger, these never fire events
+			bool                      IsSelf;
+		};
+
+		// The objects touching the volume as of the last step, sorted by their bullet object so that we can
+		// find what entered and left by walking it alongside the next step's list
+		std::vector<Contact> _currentCollisions;
+		// Scratch storage for building the next list, kept around so we don't allocate every frame
+		std::vector<Contact> _frameCollisions;
 
 		virtual btBroadphaseProxy* _GetBroadphaseHandle() override;
 
+		/// <summary>
+		/// Invokes the leaving callbacks for an object that is no longer touching the volume
+		/// </summary>
+		void _OnContactLeft(const Contact& contact, const TriggerVolume::Sptr& self);
+
 	};
 }
\ No newline at end of file
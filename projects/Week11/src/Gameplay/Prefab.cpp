@@ -0,0 +1,403 @@
+#include "Gameplay/Prefab.h"
+
+#include <sstream>
+
+// Cereal
+#include <cereal/archives/binary.hpp>
+#include <cereal/types/string.hpp>
+#include <cereal/types/vector.hpp>
+
+#include "Utils/JsonGlmHelpers.h"
+#include "Utils/CerealGlmHelpers.h"
+#include "Utils/MemoryStream.h"
+#include "Utils/ResourceManager/ResourceManager.h"
+#include "Gameplay/Scene.h"
+
+namespace Gameplay {
+	/// <summary>
+	/// Derives the GUID for an object or component in a prefab instance from the instance's GUID and the
+	/// GUID in the template. This lets instances keep stable IDs without storing them in the scene
+	/// </summary>
+	static Guid MixGuids(const Guid& instanceId, const Guid& templateId) {
+		unsigned char bytes[16];
+		for (int ix = 0; ix < 16; ix++) {
+			bytes[ix] = instanceId.bytes()[ix] ^ templateId.bytes()[ix];
+		}
+		return Guid::FromBytes(bytes);
+	}
+
+	/// <summary>
+	/// Returns the parts of value that differ from base, recursing into objects so that only the
+	/// changed leaves are stored (applying the result with merge_patch gives us value again)
+	/// </summary>
+	static nlohmann::json SparseDiff(const nlohmann::json& base, const nlohmann::json& value) {
+		nlohmann::json result = nlohmann::json::object();
+		for (auto& [key, item] : value.items()) {
+			auto it = base.find(key);
+			if (it == base.end()) {
+				result[key] = item;
+			} else if (*it != item) {
+				result[key] = (it->is_object() && item.is_object()) ? SparseDiff(*it, item) : item;
+			}
+		}
+		return result;
+	}
+
+	Prefab::Prefab() :
+		IResource(),
+		Name("Prefab"),
+		_objects(std::vector<TemplateObject>())
+	{ }
+
+	Prefab::Prefab(const GameObject::Sptr& root) :
+		IResource(),
+		Name(root->Name),
+		_objects(std::vector<TemplateObject>())
+	{
+		// Walk the hierarchy breadth first so that parents always come before their children
+		std::vector<GameObject*> hierarchy = { root.get() };
+		std::vector<int> parents = { -1 };
+		for (size_t ix = 0; ix < hierarchy.size(); ix++) {
+			for (const auto& child : hierarchy[ix]->GetChildren()) {
+				GameObject* childPtr = child.Get();
+				if (childPtr != nullptr) {
+					hierarchy.push_back(childPtr);
+					parents.push_back(static_cast<int>(ix));
+				}
+			}
+		}
+
+		nlohmann::json objects = nlohmann::json::array();
+		for (size_t ix = 0; ix < hierarchy.size(); ix++) {
+			GameObject* object = hierarchy[ix];
+			nlohmann::json blob = {
+				{ "name", object->Name },
+				{ "guid", object->GetGUID().str() },
+				{ "position", object->_position },
+				{ "rotation", object->_rotation },
+				{ "scale",    object->_scale },
+				{ "parent",   parents[ix] },
+				{ "hide_in_inspector", object->HideInHierarchy }
+			};
+			blob["components"] = nlohmann::json::object();
+			for (const auto& component : object->_components) {
+				nlohmann::json data = component->ToJson();
+				data["guid"] = component->GetGUID().str();
+				data["enabled"] = component->IsEnabled;
+				blob["components"][component->ComponentTypeName()] = data;
+			}
+			objects.push_back(blob);
+		}
+
+		_Build(objects);
+	}
+
+	void Prefab::_Build(const nlohmann::json& objects) {
+		_objects.clear();
+		_objects.reserve(objects.size());
+
+		for (const nlohmann::json& blob : objects) {
+			TemplateObject object;
+			object.Name = blob["name"];
+			object.ObjectId = Guid(blob["guid"]);
+			object.Position = blob["position"];
+			object.Rotation = blob["rotation"];
+			object.Scale = blob["scale"];
+			object.HideInHierarchy = JsonGet(blob, "hide_in_inspector", false);
+			object.Parent = JsonGet(blob, "parent", -1);
+			LOG_ASSERT(object.Parent < static_cast<int>(_objects.size()), "Prefab objects must come after their parents!");
+
+			for (auto& [typeName, value] : blob["components"].items()) {
+				// We construct the component once, and store it's output rather than the JSON we were given, so
+				// that values that don't survive a round trip exactly are not saved as overrides later
+				IComponent::Sptr component = ComponentManager::Construct(typeName, value);
+				if (component == nullptr) {
+					LOG_WARN("Unknown component type \"{}\" in prefab \"{}\"", typeName, Name);
+					continue;
+				}
+
+				TemplateComponent templ;
+				templ.TypeId = ComponentManager::GetTypeId(typeName);
+				templ.TypeName = typeName;
+				templ.ComponentId = component->GetGUID();
+				templ.Data = component->ToJson();
+				templ.Data["enabled"] = component->IsEnabled;
+
+				std::ostringstream stream(std::ios::binary);
+				{
+					cereal::BinaryOutputArchive archive(stream);
+					ComponentManager::SaveBinary(*component, archive);
+				}
+				templ.Binary = stream.str();
+
+				object.Components.push_back(std::move(templ));
+			}
+
+			_objects.push_back(std::move(object));
+		}
+	}
+
+	void Prefab::Construct(Scene* scene, Guid instanceId, const nlohmann::json& overrides,
+		std::vector<GameObject::Sptr>& objects, std::vector<Guid>& parents) const
+	{
+		size_t first = objects.size();
+		objects.reserve(first + _objects.size());
+		parents.reserve(first + _objects.size());
+
+		std::shared_ptr<const Prefab> self = shared_from_this();
+		for (size_t ix = 0; ix < _objects.size(); ix++) {
+			const TemplateObject& templ = _objects[ix];
+
+			// Overrides are stored by the object's index in the template
+			const nlohmann::json* objectOverrides = nullptr;
+			if (overrides.is_object()) {
+				auto it = overrides.find(std::to_string(ix));
+				if (it != overrides.end()) {
+					objectOverrides = &(*it);
+				}
+			}
+
+			GameObject::Sptr result(new GameObject());
+			result->_scene = scene;
+			result->_selfRef = result;
+			result->_prefab = self;
+			result->_prefabIndex = static_cast<uint32_t>(ix);
+			result->_guid = ix == 0 ? instanceId : MixGuids(instanceId, templ.ObjectId);
+			result->Name = templ.Name;
+			result->_position = templ.Position;
+			result->_rotation = templ.Rotation;
+			result->_scale = templ.Scale;
+			result->HideInHierarchy = templ.HideInHierarchy;
+			result->_isLocalTransformDirty = true;
+
+			if (objectOverrides != nullptr) {
+				JsonGetInPlace(*objectOverrides, "name", result->Name);
+				JsonGetInPlace(*objectOverrides, "position", result->_position);
+				JsonGetInPlace(*objectOverrides, "rotation", result->_rotation);
+				JsonGetInPlace(*objectOverrides, "scale", result->_scale);
+				JsonGetInPlace(*objectOverrides, "hide_in_inspector", result->HideInHierarchy);
+			}
+
+			for (const TemplateComponent& component : templ.Components) {
+				Guid componentId = MixGuids(instanceId, component.ComponentId);
+
+				const nlohmann::json* componentOverrides = nullptr;
+				if (objectOverrides != nullptr && objectOverrides->contains("components")) {
+					const nlohmann::json& blob = (*objectOverrides)["components"];
+					auto it = blob.find(component.TypeName);
+					if (it != blob.end()) {
+						componentOverrides = &(*it);
+					}
+				}
+
+				IComponent::Sptr instance;
+				// Only overridden components need to go through JSON, everything else is cloned from the binary blob
+				if (componentOverrides != nullptr) {
+					nlohmann::json data = component.Data;
+					data.merge_patch(*componentOverrides);
+					data["guid"] = componentId.str();
+					instance = ComponentManager::Construct(component.TypeName, data);
+				} else {
+					MemoryInputStream stream(component.Binary.data(), component.Binary.data() + component.Binary.size());
+					cereal::BinaryInputArchive archive(stream);
+					instance = ComponentManager::ConstructBinary(component.TypeId, archive);
+					if (instance != nullptr) {
+						instance->OverrideGUID(componentId);
+					}
+				}
+				if (instance == nullptr) {
+					LOG_WARN("Unknown component type \"{}\" in prefab \"{}\", skipping it", component.TypeName, Name);
+					continue;
+				}
+				result->_AttachComponent(instance);
+			}
+
+			objects.push_back(result);
+			parents.push_back(templ.Parent < 0 ? Guid() : objects[first + templ.Parent]->GetGUID());
+		}
+	}
+
+	bool Prefab::ConstructInstance(Scene* scene, const nlohmann::json& data,
+		std::vector<GameObject::Sptr>& objects, std::vector<Guid>& parents)
+	{
+		Prefab::Sptr prefab = ResourceManager::Get<Prefab>(Guid(data["prefab"]));
+		if (prefab == nullptr) {
+			LOG_WARN("Could not find prefab for instance \"{}\"", JsonGet<std::string>(data, "name", "Unknown"));
+			return false;
+		}
+
+		size_t first = objects.size();
+		prefab->Construct(scene, Guid(data["guid"]), JsonGet(data, "overrides", nlohmann::json()), objects, parents);
+
+		// The root's name and transform are always stored with the instance
+		GameObject::Sptr root = objects[first];
+		JsonGetInPlace(data, "name", root->Name);
+		JsonGetInPlace(data, "position", root->_position);
+		JsonGetInPlace(data, "rotation", root->_rotation);
+		JsonGetInPlace(data, "scale", root->_scale);
+		JsonGetInPlace(data, "hide_in_inspector", root->HideInHierarchy);
+		if (data.contains("parent") && data["parent"] != "null") {
+			parents[first] = Guid(data["parent"]);
+		}
+
+		return true;
+	}
+
+	nlohmann::json Prefab::InstanceToJson(const GameObject& root) const {
+		GameObject* parent = root._parent.Get();
+		nlohmann::json result = {
+			{ "name", root.Name },
+			{ "guid", root._guid.str() },
+			{ "prefab", GetGUID().str() },
+			{ "position", root._position },
+			{ "rotation", root._rotation },
+			{ "scale",    root._scale },
+			{ "parent",   parent == nullptr ? "null" : parent->_guid.str() },
+			{ "hide_in_inspector", root.HideInHierarchy }
+		};
+		result["overrides"] = _GetOverrides(root);
+
+		return result;
+	}
+
+	bool Prefab::ConstructInstanceFromBinary(Scene* scene, cereal::BinaryInputArchive& archive,
+		std::vector<GameObject::Sptr>& objects, std::vector<Guid>& parents)
+	{
+		Guid prefabId, instanceId;
+		std::string name;
+		glm::vec3 position, scale;
+		glm::quat rotation;
+		bool hideInHierarchy = false;
+		std::vector<uint8_t> overrides;
+		archive(prefabId, instanceId, name, position, rotation, scale, hideInHierarchy, overrides);
+
+		Prefab::Sptr prefab = ResourceManager::Get<Prefab>(prefabId);
+		if (prefab == nullptr) {
+			LOG_WARN("Could not find prefab for instance \"{}\"", name);
+			return false;
+		}
+
+		size_t first = objects.size();
+		prefab->Construct(scene, instanceId, overrides.empty() ? nlohmann::json() : nlohmann::json::from_msgpack(overrides), objects, parents);
+
+		// The root's name and transform are always stored with the instance
+		GameObject::Sptr root = objects[first];
+		root->Name = name;
+		root->_position = position;
+		root->_rotation = rotation;
+		root->_scale = scale;
+		root->HideInHierarchy = hideInHierarchy;
+
+		return true;
+	}
+
+	nlohmann::json Prefab::InstanceBinaryToJson(cereal::BinaryInputArchive& archive) {
+		Guid prefabId, instanceId;
+		std::string name;
+		glm::vec3 position, scale;
+		glm::quat rotation;
+		bool hideInHierarchy = false;
+		std::vector<uint8_t> overrides;
+		archive(prefabId, instanceId, name, position, rotation, scale, hideInHierarchy, overrides);
+
+		return {
+			{ "name", name },
+			{ "guid", instanceId.str() },
+			{ "prefab", prefabId.str() },
+			{ "position", position },
+			{ "rotation", rotation },
+			{ "scale",    scale },
+			{ "hide_in_inspector", hideInHierarchy },
+			{ "overrides", overrides.empty() ? nlohmann::json::object() : nlohmann::json::from_msgpack(overrides) }
+		};
+	}
+
+	void Prefab::InstanceToBinary(const GameObject& root, cereal::BinaryOutputArchive& archive, std::vector<Guid>* dependencies) const {
+		nlohmann::json overrides = _GetOverrides(root);
+		archive(GetGUID(), root._guid, root.Name, root._position, root._rotation, root._scale, root.HideInHierarchy);
+		// Overrides are sparse JSON patches, so we store them the same way as components without binary serializers
+		archive(overrides.empty() ? std::vector<uint8_t>() : nlohmann::json::to_msgpack(overrides));
+
+		if (dependencies != nullptr) {
+			dependencies->push_back(GetGUID());
+			std::vector<Guid> found = ResourceManager::FindDependencies(overrides);
+			dependencies->insert(dependencies->end(), found.begin(), found.end());
+		}
+	}
+
+	nlohmann::json Prefab::_GetOverrides(const GameObject& root) const {
+		nlohmann::json overrides = nlohmann::json::object();
+		for (size_t ix = 0; ix < _objects.size(); ix++) {
+			const TemplateObject& templ = _objects[ix];
+
+			// Objects that have been removed from the instance can't be represented, they'll come back on load
+			GameObject::Sptr object = ix == 0 ? root._selfRef.lock() : root._scene->FindObjectByGUID(MixGuids(root._guid, templ.ObjectId));
+			if (object == nullptr) continue;
+
+			nlohmann::json diff = nlohmann::json::object();
+			if (ix > 0) {
+				if (object->Name != templ.Name) diff["name"] = object->Name;
+				if (object->_position != templ.Position) diff["position"] = object->_position;
+				if (object->_rotation != templ.Rotation) diff["rotation"] = object->_rotation;
+				if (object->_scale != templ.Scale) diff["scale"] = object->_scale;
+				if (object->HideInHierarchy != templ.HideInHierarchy) diff["hide_in_inspector"] = object->HideInHierarchy;
+			}
+
+			for (const TemplateComponent& component : templ.Components) {
+				if (!object->_HasTypeId(component.TypeId)) continue;
+
+				const IComponent::Sptr& instance = object->_components[object->_componentSlots[component.TypeId]];
+				nlohmann::json data = instance->ToJson();
+				data["enabled"] = instance->IsEnabled;
+
+				nlohmann::json componentDiff = SparseDiff(component.Data, data);
+				if (!componentDiff.empty()) {
+					diff["components"][component.TypeName] = componentDiff;
+				}
+			}
+
+			if (!diff.empty()) {
+				overrides[std::to_string(ix)] = diff;
+			}
+		}
+
+		return overrides;
+	}
+
+	Prefab::Sptr Prefab::FromJson(const nlohmann::json& data) {
+		Prefab::Sptr result = std::make_shared<Prefab>();
+		result->OverrideGUID(Guid(data["guid"]));
+		result->Name = JsonGet<std::string>(data, "name", result->Name);
+		result->_Build(data["objects"]);
+		return result;
+	}
+
+	nlohmann::json Prefab::ToJson() const {
+		nlohmann::json result = {
+			{ "name", Name }
+		};
+
+		nlohmann::json objects = nlohmann::json::array();
+		for (const TemplateObject& templ : _objects) {
+			nlohmann::json blob = {
+				{ "name", templ.Name },
+				{ "guid", templ.ObjectId.str() },
+				{ "position", templ.Position },
+				{ "rotation", templ.Rotation },
+				{ "scale",    templ.Scale },
+				{ "parent",   templ.Parent },
+				{ "hide_in_inspector", templ.HideInHierarchy }
+			};
+			blob["components"] = nlohmann::json::object();
+			for (const TemplateComponent& component : templ.Components) {
+				nlohmann::json data = component.Data;
+				data["guid"] = component.ComponentId.str();
+				blob["components"][component.TypeName] = data;
+			}
+			objects.push_back(blob);
+		}
+		result["objects"] = objects;
+
+		return result;
+	}
+}
@@ -0,0 +1,148 @@
+#pragma once
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "Utils/ResourceManager/IResource.h"
+#include "Gameplay/GameObject.h"
+
+namespace Gameplay {
+	class Scene;
+
+	/// <summary>
+	/// A reusable hierarchy of game objects that can be instantiated into scenes. The prefab stores a
+	/// single template of the hierarchy, and scenes only store the prefab's GUID, the instance's transform
+	/// and a sparse set of overrides for whatever differs from the template.
+	///
+	/// Components are pre-serialized into binary blobs when the prefab is loaded, so that instances can
+	/// be cloned from memory without re-parsing any JSON. Only components with overrides are built from JSON
+	///
+	/// Instances may change the values of template components, but can not add or remove components
+	/// or objects (those changes are not saved)
+	/// </summary>
+	class Prefab : public IResource, public std::enable_shared_from_this<Prefab> {
+	public:
+		typedef std::shared_ptr<Prefab> Sptr;
+		typedef std::weak_ptr<Prefab>   Wptr;
+
+		/// <summary>
+		/// A human readable name for the prefab
+		/// </summary>
+		std::string Name;
+
+		/// <summary>
+		/// Default constructor, to be used by Resource manager and smart pointers only
+		/// </summary>
+		Prefab();
+		/// <summary>
+		/// Creates a prefab from an existing object, capturing the object and all of it's descendants
+		/// </summary>
+		/// <param name="root">The root of the hierarchy to store in the prefab</param>
+		Prefab(const GameObject::Sptr& root);
+
+		/// <summary>
+		/// Gets the number of objects in the prefab's hierarchy, including the root
+		/// </summary>
+		size_t ObjectCount() const { return _objects.size(); }
+
+		/// <summary>
+		/// Constructs a new instance of this prefab, without adding it to the scene or invoking OnLoad (see
+		/// GameObject::ConstructFromJson). The root is appended first, followed by it's descendants, with
+		/// parents always appearing before their children. Safe to call from worker threads
+		/// </summary>
+		/// <param name="scene">The scene that the instance will belong to</param>
+		/// <param name="instanceId">The GUID for the instance's root, the GUIDs of all other objects and components are derived from it</param>
+		/// <param name="overrides">The per-object overrides for the instance, or null for none</param>
+		/// <param name="objects">The list to append the constructed objects to</param>
+		/// <param name="parents">The list to append the GUID of each object's parent to (empty for the root)</param>
+		void Construct(Scene* scene, Guid instanceId, const nlohmann::json& overrides,
+			std::vector<GameObject::Sptr>& objects, std::vector<Guid>& parents) const;
+
+		/// <summary>
+		/// Constructs a prefab instance from a scene's JSON entry for it (see InstanceToJson)
+		/// </summary>
+		/// <param name="scene">The scene that the instance will belong to</param>
+		/// <param name="data">The JSON entry for the instance</param>
+		/// <param name="objects">The list to append the constructed objects to</param>
+		/// <param name="parents">The list to append the GUID of each object's parent to</param>
+		/// <returns>False if the prefab could not be found, in which case nothing is constructed</returns>
+		static bool ConstructInstance(Scene* scene, const nlohmann::json& data,
+			std::vector<GameObject::Sptr>& objects, std::vector<Guid>& parents);
+
+		/// <summary>
+		/// Converts an instance of this prefab into the JSON entry that scenes store for it, which only
+		/// contains the values that differ from the prefab
+		/// </summary>
+		/// <param name="root">The root object of the instance</param>
+		nlohmann::json InstanceToJson(const GameObject& root) const;
+
+		/// <summary>
+		/// Constructs a prefab instance from a binary scene's record for it (see InstanceToBinary). The whole
+		/// record is always read, even if the prefab can not be found
+		/// </summary>
+		/// <param name="scene">The scene that the instance will belong to</param>
+		/// <param name="archive">The archive to read the record from</param>
+		/// <param name="objects">The list to append the constructed objects to</param>
+		/// <param name="parents">The list to append the GUID of each object's parent to (empty for the root)</param>
+		/// <returns>False if the prefab could not be found, in which case nothing is constructed</returns>
+		static bool ConstructInstanceFromBinary(Scene* scene, cereal::BinaryInputArchive& archive,
+			std::vector<GameObject::Sptr>& objects, std::vector<Guid>& parents);
+
+		/// <summary>
+		/// Reads a binary scene's record for a prefab instance and returns it in the form that InstanceToJson
+		/// uses (without the parent, which the scene fills in). The prefab is not needed, so this is safe to
+		/// call from worker threads
+		/// </summary>
+		/// <param name="archive">The archive to read the record from</param>
+		static nlohmann::json InstanceBinaryToJson(cereal::BinaryInputArchive& archive);
+
+		/// <summary>
+		/// Writes the record that binary scenes store for an instance of this prefab, which holds the same
+		/// information as InstanceToJson (the root's parent is stored by the scene)
+		/// </summary>
+		/// <param name="root">The root object of the instance</param>
+		/// <param name="archive">The archive to write the record to</param>
+		/// <param name="dependencies">If not null, the GUIDs of the resources the instance uses are appended to this list</param>
+		void InstanceToBinary(const GameObject& root, cereal::BinaryOutputArchive& archive, std::vector<Guid>* dependencies = nullptr) const;
+
+		static Prefab::Sptr FromJson(const nlohmann::json& data);
+		virtual nlohmann::json ToJson() const override;
+
+	protected:
+		struct TemplateComponent {
+			uint32_t       TypeId;
+			std::string    TypeName;
+			Guid           ComponentId;
+			// The component's JSON (without it's GUID), used as the base for instance overrides
+			nlohmann::json Data;
+			// The component pre-serialized by the component manager, used to clone components without overrides
+			std::string    Binary;
+		};
+
+		struct TemplateObject {
+			std::string    Name;
+			Guid           ObjectId;
+			glm::vec3      Position;
+			glm::quat      Rotation;
+			glm::vec3      Scale;
+			bool           HideInHierarchy;
+			// The index of the parent object in the template, or -1 for the root
+			int            Parent;
+			std::vector<TemplateComponent> Components;
+		};
+
+		// The objects in the hierarchy, with the root first and parents always before their children
+		std::vector<TemplateObject> _objects;
+
+		/// <summary>
+		/// Builds the template from a list of objects in JSON form, where the parent of each object is
+		/// stored as an index into the list
+		/// </summary>
+		void _Build(const nlohmann::json& objects);
+		/// <summary>
+		/// Gets the per-object overrides for an instance of this prefab, keyed by the object's index in the template
+		/// </summary>
+		/// <param name="root">The root object of the instance</param>
+		nlohmann::json _GetOverrides(const GameObject& root) const;
+	};
+}
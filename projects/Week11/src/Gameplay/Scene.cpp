@@ -3,37 +3,459 @@
 #include <GLFW/glfw3.h>
 #include <locale>
 #include <codecvt>
+#include <chrono>
+#include <fstream>
+#include <filesystem>
+#include <cstring>
+#include <atomic>
+#include <mutex>
+#include <shared_mutex>
+#include <sstream>
+#include <algorithm>
+#include <functional>
+#include <unordered_map>
+
+#include <gzip/compress.hpp>
+#include <gzip/decompress.hpp>
+#include <gzip/utils.hpp>
+
+#include <cereal/archives/binary.hpp>
+#include <cereal/types/string.hpp>
+#include <cereal/types/vector.hpp>
+
+#include <BulletCollision/CollisionDispatch/btCollisionDispatcherMt.h>
+#include <BulletDynamics/Dynamics/btDiscreteDynamicsWorldMt.h>
+#include <BulletDynamics/ConstraintSolver/btSequentialImpulseConstraintSolverMt.h>
+#include <BulletCollision/NarrowPhaseCollision/btGjkPairDetector.h>
+#include <BulletCollision/NarrowPhaseCollision/btGjkEpaPenetrationDepthSolver.h>
+#include <BulletCollision/NarrowPhaseCollision/btVoronoiSimplexSolver.h>
+#include <BulletCollision/NarrowPhaseCollision/btPointCollector.h>
 
 #include "Utils/FileHelpers.h"
+#include "Utils/VirtualFileSystem.h"
 #include "Utils/GlmBulletConversions.h"
+#include "Utils/CerealGlmHelpers.h"
+#include "Utils/MemoryStream.h"
 
 #include "Gameplay/Physics/RigidBody.h"
 #include "Gameplay/Physics/TriggerVolume.h"
+#include "Gameplay/Physics/BulletTaskScheduler.h"
 #include "Gameplay/MeshResource.h"
 #include "Gameplay/Material.h"
+#include "Gameplay/Prefab.h"
 
 #include "Graphics/DebugDraw.h"
 #include "Graphics/Textures/TextureCube.h"
 #include "Graphics/VertexArrayObject.h"
 #include "Application/Application.h"
+#include "Application/JobSystem.h"
 
 namespace Gameplay {
+	bool Scene::UseMultithreadedPhysics = false;
+
+	// Identifies binary scene files, stored at the very start of the file
+	static const char BinarySceneMagic[4] = { 'S', 'C', 'N', 'B' };
+
+	// The number of physics queries handled by each job
+	static const size_t QueryBatchSize = 32;
+	// The number of objects constructed by each job when loading a scene
+	static const size_t LoadBatchSize = 64;
+
+	/// <summary>
+	/// Runs work in chunks across the job system, or serially if there is no job system
+	/// </summary>
+	static void RunParallel(size_t count, size_t batchSize, const JobSystem::RangeFunc& func) {
+		if (count == 0) {
+			return;
+		} else if (JobSystem::IsInitialized()) {
+			JobSystem::Get().ParallelFor(count, batchSize, func);
+		} else {
+			func(0, count);
+		}
+	}
+
+	/// <summary>
+	/// Returns the time since the start of a load phase in milliseconds, and restarts the timer for the next phase
+	/// </summary>
+	static double EndLoadPhase(std::chrono::high_resolution_clock::time_point& phaseStart) {
+		auto now = std::chrono::high_resolution_clock::now();
+		double result = std::chrono::duration<double, std::milli>(now - phaseStart).count();
+		phaseStart = now;
+		return result;
+	}
+
+	// The number of scene saves that have been queued on the job system but have not finished yet
+	static std::atomic<uint32_t> PendingSaves(0);
+	// Only one scene file is written at a time, so that two saves to the same path can't race on the temp file
+	static std::mutex SaveFileLock;
+
+	/// <summary>
+	/// Writes the contents of a scene file. The data is written to a temporary file that then replaces the target,
+	/// so that a crash or failure part way through never leaves a half written scene behind
+	/// </summary>
+	/// <returns>True if the file was written</returns>
+	static bool WriteSceneContents(const std::string& path, const std::string& contents) {
+		std::lock_guard<std::mutex> lock(SaveFileLock);
+		std::string tempPath = path + ".tmp";
+		{
+			std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+			if (!file || !file.write(contents.data(), contents.size())) {
+				LOG_WARN("Failed to write scene to \"{}\"", tempPath);
+				return false;
+			}
+		}
+
+		std::error_code error;
+		std::filesystem::rename(tempPath, path, error);
+		if (error) {
+			LOG_WARN("Failed to replace \"{}\": {}", path, error.message());
+			std::filesystem::remove(tempPath, error);
+			return false;
+		}
+		VirtualFileSystem::MarkModified(path);
+		return true;
+	}
+
+	/// <summary>
+	/// Serializes a snapshot of a scene and writes it to a file, compressing it if the path ends in the compressed
+	/// extension (see WriteSceneContents)
+	/// </summary>
+	static void WriteSceneFile(const std::string& path, const nlohmann::json& snapshot, double snapshotMs) {
+		auto phaseStart = std::chrono::high_resolution_clock::now();
+		std::string contents = snapshot.dump(1, '\t');
+		double serializeMs = EndLoadPhase(phaseStart);
+
+		if (std::filesystem::path(path).extension() == Scene::CompressedExtension) {
+			contents = gzip::compress(contents.data(), contents.size());
+		}
+		double compressMs = EndLoadPhase(phaseStart);
+
+		if (!WriteSceneContents(path, contents)) {
+			return;
+		}
+		double writeMs = EndLoadPhase(phaseStart);
+
+		LOG_INFO("Saved scene to \"{}\" ({} bytes): snapshot {:.2f}ms, serialize {:.2f}ms, compress {:.2f}ms, write {:.2f}ms",
+			path, contents.size(), snapshotMs, serializeMs, compressMs, writeMs);
+	}
+
+	/// <summary>
+	/// Everything in a binary scene that comes before the objects, along with the object offset table from the end
+	/// </summary>
+	struct BinarySceneHeader {
+		Guid      DefaultMaterial;
+		glm::vec3 Ambient;
+		float     FixedTimeStep;
+		int       MaxPhysicsSubSteps;
+		Guid      SkyboxMesh;
+		Guid      SkyboxShader;
+		Guid      SkyboxTexture;
+		glm::quat SkyboxRotation;
+		Guid      MainCamera;
+		std::vector<Guid> Dependencies;
+		// Maps the component type indices stored in the file to the types registered in this build
+		std::vector<uint32_t> TypeIds;
+		// Where each object record starts, and where the records end
+		std::vector<uint64_t> Offsets;
+		uint64_t  TableOffset;
+	};
+
+	/// <summary>
+	/// Reads and validates the header of a binary scene, does not modify the component or resource managers
+	/// </summary>
+	/// <param name="data">The contents of the binary scene</param>
+	/// <param name="name">The name of the scene to use in warnings</param>
+	/// <param name="result">The header to read into</param>
+	/// <returns>False if the data is not a valid binary scene for this build</returns>
+	static bool ReadBinarySceneHeader(const std::string& data, const std::string& name, BinarySceneHeader& result) {
+		if (data.size() < sizeof(BinarySceneMagic) + sizeof(uint32_t) + sizeof(uint64_t)) {
+			LOG_WARN("\"{}\" is not a binary scene", name);
+			return false;
+		}
+		try {
+			const char* dataEnd = data.data() + data.size();
+			MemoryInputStream stream(data.data(), dataEnd);
+			cereal::BinaryInputArchive archive(stream);
+
+			char magic[sizeof(BinarySceneMagic)];
+			uint32_t version = 0;
+			archive(cereal::binary_data(magic, sizeof(magic)), version);
+			if (memcmp(magic, BinarySceneMagic, sizeof(magic)) != 0 || version != Scene::BinaryVersion) {
+				LOG_WARN("\"{}\" is not a version {} binary scene, it must be re-converted from JSON", name, Scene::BinaryVersion);
+				return false;
+			}
+
+			archive(result.DefaultMaterial, result.Ambient, result.FixedTimeStep, result.MaxPhysicsSubSteps,
+				result.SkyboxMesh, result.SkyboxShader, result.SkyboxTexture, result.SkyboxRotation, result.MainCamera);
+			archive(result.Dependencies);
+
+			// Map the component types stored in the file to the types registered in this build
+			uint32_t typeCount = 0;
+			archive(typeCount);
+			result.TypeIds.resize(typeCount);
+			for (uint32_t ix = 0; ix < typeCount; ix++) {
+				std::string typeName;
+				archive(typeName);
+				result.TypeIds[ix] = ComponentManager::GetTypeId(typeName);
+				if (result.TypeIds[ix] == ComponentManager::InvalidTypeId) {
+					LOG_WARN("Binary scene \"{}\" uses unregistered component type \"{}\"", name, typeName);
+					return false;
+				}
+			}
+
+			// Grab the object offsets from the end of the file, the table must fill the space before the table's location
+			uint32_t objectCount = 0;
+			archive(objectCount);
+			uint64_t objectsStart = data.size() - static_cast<uint64_t>(stream.rdbuf()->in_avail());
+			uint64_t tableEnd = data.size() - sizeof(uint64_t);
+			memcpy(&result.TableOffset, dataEnd - sizeof(uint64_t), sizeof(uint64_t));
+			if (result.TableOffset < objectsStart || result.TableOffset > tableEnd || tableEnd - result.TableOffset != objectCount * sizeof(uint64_t)) {
+				LOG_ERROR("Binary scene \"{}\" is corrupt, the object table is out of range", name);
+				return false;
+			}
+			result.Offsets.resize(objectCount);
+			memcpy(result.Offsets.data(), data.data() + result.TableOffset, objectCount * sizeof(uint64_t));
+
+			// Records are stored in order between the header and the table, and jobs read from these offsets directly
+			uint64_t previous = objectsStart;
+			for (uint64_t offset : result.Offsets) {
+				if (offset < previous || offset > result.TableOffset) {
+					LOG_ERROR("Binary scene \"{}\" is corrupt, an object offset is out of range", name);
+					return false;
+				}
+				previous = offset;
+			}
+			return true;
+		} catch (const std::exception& e) {
+			LOG_ERROR("Failed to read binary scene \"{}\": {}", name, e.what());
+			return false;
+		}
+	}
+
+	/// <summary>
+	/// Converts the contents of a binary scene into the same JSON that Scene::ToJson produces, without creating
+	/// a scene or touching the resource manager, so that background saves can do it on a worker thread
+	/// </summary>
+	/// <returns>The scene's JSON, or null if the data was not a valid binary scene</returns>
+	static nlohmann::json BinarySceneToJson(const std::string& data) {
+		BinarySceneHeader header;
+		if (!ReadBinarySceneHeader(data, "snapshot", header)) {
+			return nlohmann::json();
+		}
+
+		auto guidToJson = [](const Guid& id) -> std::string {
+			return id.isValid() ? id.str() : "null";
+		};
+
+		nlohmann::json blob;
+		blob["default_material"] = guidToJson(header.DefaultMaterial);
+		blob["ambient"] = header.Ambient;
+		blob["physics"] = nlohmann::json();
+		blob["physics"]["fixed_step"] = header.FixedTimeStep;
+		blob["physics"]["max_substeps"] = header.MaxPhysicsSubSteps;
+		blob["skybox"] = nlohmann::json();
+		blob["skybox"]["mesh"] = guidToJson(header.SkyboxMesh);
+		blob["skybox"]["shader"] = guidToJson(header.SkyboxShader);
+		blob["skybox"]["texture"] = guidToJson(header.SkyboxTexture);
+		blob["skybox"]["orientation"] = header.SkyboxRotation;
+		blob["main_camera"] = guidToJson(header.MainCamera);
+
+		// The binary scene already lists the resources it uses, so there's no need to search the JSON for them
+		nlohmann::json dependencies = nlohmann::json::array();
+		for (const Guid& id : header.Dependencies) {
+			dependencies.push_back(id.str());
+		}
+		blob["dependencies"] = dependencies;
+
+		size_t objectCount = header.Offsets.size();
+		std::vector<nlohmann::json> objects(objectCount);
+		std::vector<bool> isInstance(objectCount);
+		std::unordered_map<Guid, std::vector<size_t>> children;
+		MemoryInputStream stream(data.data() + (objectCount > 0 ? header.Offsets[0] : header.TableOffset), data.data() + header.TableOffset);
+		cereal::BinaryInputArchive archive(stream);
+		try {
+			for (size_t ix = 0; ix < objectCount; ix++) {
+				Guid parent;
+				bool instance = false;
+				archive(parent, instance);
+				isInstance[ix] = instance;
+				objects[ix] = instance ? Prefab::InstanceBinaryToJson(archive) : GameObject::BinaryToJson(archive, header.TypeIds);
+				objects[ix]["parent"] = guidToJson(parent);
+				if (parent.isValid()) {
+					children[parent].push_back(ix);
+				}
+			}
+		} catch (const std::exception& e) {
+			LOG_ERROR("Failed to convert scene snapshot to JSON: {}", e.what());
+			return nlohmann::json();
+		}
+
+		// GameObject::ToJson nests a full copy of each child inside it's parent, so we rebuild those here
+		std::vector<bool> isExpanded(objectCount, false);
+		std::function<const nlohmann::json& (size_t)> expand = [&](size_t ix) -> const nlohmann::json& {
+			nlohmann::json& object = objects[ix];
+			if (!isExpanded[ix] && !isInstance[ix]) {
+				object["children"] = std::vector<nlohmann::json>();
+				auto it = children.find(Guid(object["guid"].get<std::string>()));
+				if (it != children.end()) {
+					for (size_t child : it->second) {
+						object["children"].push_back(expand(child));
+					}
+				}
+			}
+			isExpanded[ix] = true;
+			return object;
+		};
+		for (size_t ix = 0; ix < objectCount; ix++) {
+			expand(ix);
+		}
+		blob["objects"] = std::move(objects);
+
+		return blob;
+	}
+
+	/// <summary>
+	/// Filtering shared by all our queries, bullet only checks the group and mask by default and would
+	/// otherwise hit trigger volumes
+	/// </summary>
+	static bool QueryNeedsCollision(const btBroadphaseProxy* proxy, int mask, bool hitTriggers) {
+		if ((proxy->m_collisionFilterGroup & mask) == 0) {
+			return false;
+		}
+		const btCollisionObject* object = static_cast<const btCollisionObject*>(proxy->m_clientObject);
+		return hitTriggers || object->hasContactResponse();
+	}
+
+	struct RayQueryCallback : public btCollisionWorld::ClosestRayResultCallback {
+		bool HitTriggers;
+
+		RayQueryCallback(const Physics::RayQuery& query) :
+			ClosestRayResultCallback(ToBt(query.From), ToBt(query.To)),
+			HitTriggers(query.HitTriggers)
+		{
+			m_collisionFilterMask = query.CollisionMask;
+		}
+
+		virtual bool needsCollision(btBroadphaseProxy* proxy) const override {
+			return QueryNeedsCollision(proxy, m_collisionFilterMask, HitTriggers);
+		}
+	};
+
+	struct SphereCastQueryCallback : public btCollisionWorld::ClosestConvexResultCallback {
+		bool HitTriggers;
+
+		SphereCastQueryCallback(const Physics::SphereCastQuery& query) :
+			ClosestConvexResultCallback(ToBt(query.From), ToBt(query.To)),
+			HitTriggers(query.HitTriggers)
+		{
+			m_collisionFilterMask = query.CollisionMask;
+		}
+
+		virtual bool needsCollision(btBroadphaseProxy* proxy) const override {
+			return QueryNeedsCollision(proxy, m_collisionFilterMask, HitTriggers);
+		}
+	};
+
+	/// <summary>
+	/// Collects the objects whose bounds overlap an AABB during a broadphase test
+	/// </summary>
+	struct OverlapCandidateCallback : public btBroadphaseAabbCallback {
+		const Physics::OverlapQuery&           Query;
+		std::vector<const btCollisionObject*>& Candidates;
+
+		OverlapCandidateCallback(const Physics::OverlapQuery& query, std::vector<const btCollisionObject*>& candidates) :
+			Query(query), Candidates(candidates) { }
+
+		virtual bool process(const btBroadphaseProxy* proxy) override {
+			if (QueryNeedsCollision(proxy, Query.CollisionMask, Query.HitTriggers)) {
+				Candidates.push_back(static_cast<const btCollisionObject*>(proxy->m_clientObject));
+			}
+			return true;
+		}
+	};
+
+	/// <summary>
+	/// Checks whether a sphere is touching a collision shape, recursing into compound shapes. Everything here
+	/// is allocated on the stack, so unlike the world's contact tests this is safe to run from multiple threads
+	/// </summary>
+	static bool SphereOverlapsShape(const btSphereShape& sphere, const btTransform& sphereTransform, const btCollisionShape* shape, const btTransform& shapeTransform) {
+		if (shape->isCompound()) {
+			const btCompoundShape* compound = static_cast<const btCompoundShape*>(shape);
+			for (int ix = 0; ix < compound->getNumChildShapes(); ix++) {
+				if (SphereOverlapsShape(sphere, sphereTransform, compound->getChildShape(ix), shapeTransform * compound->getChildTransform(ix))) {
+					return true;
+				}
+			}
+			return false;
+		}
+		else if (shape->isConvex()) {
+			btVoronoiSimplexSolver simplexSolver;
+			btGjkEpaPenetrationDepthSolver depthSolver;
+			btGjkPairDetector detector(&sphere, static_cast<const btConvexShape*>(shape), &simplexSolver, &depthSolver);
+
+			btGjkPairDetector::ClosestPointInput input;
+			input.m_transformA = sphereTransform;
+			input.m_transformB = shapeTransform;
+			btPointCollector result;
+			detector.getClosestPoints(input, result, nullptr);
+			return result.m_hasResult && result.m_distance <= 0.0f;
+		}
+		else if (shape->getShapeType() == STATIC_PLANE_PROXYTYPE) {
+			const btStaticPlaneShape* plane = static_cast<const btStaticPlaneShape*>(shape);
+			btVector3 normal = shapeTransform.getBasis() * plane->getPlaneNormal();
+			btVector3 point = shapeTransform * (plane->getPlaneNormal() * plane->getPlaneConstant());
+			return normal.dot(sphereTransform.getOrigin() - point) <= sphere.getRadius();
+		}
+		// For anything else we fall back to the shape's bounds
+		else {
+			btVector3 min, max;
+			shape->getAabb(shapeTransform, min, max);
+			btVector3 closest = sphereTransform.getOrigin();
+			closest.setMax(min);
+			closest.setMin(max);
+			return closest.distance2(sphereTransform.getOrigin()) <= sphere.getRadius() * sphere.getRadius();
+		}
+	}
+
+	std::atomic<uint32_t> Scene::_nextSceneId = 1;
+	std::shared_mutex Scene::_liveScenesLock;
+	std::unordered_map<uint32_t, Scene*> Scene::_liveScenes;
+
 	Scene::Scene() :
 		_objects(std::vector<GameObject::Sptr>()),
 		_deletionQueue(std::vector<std::weak_ptr<GameObject>>()),
+		_objectsByGuid(std::unordered_map<Guid, GameObject::Sptr>()),
+		_objectSlots(std::vector<ObjectSlot>()),
+		_freeObjectSlots(std::vector<uint32_t>()),
+		_sceneId(_nextSceneId++),
 		IsPlaying(false),
 		IsDestroyed(false),
 		MainCamera(nullptr),
 		DefaultMaterial(nullptr),
 		_isAwake(false),
+		_lastUpdateTime(0.0f),
+		_lastPhysicsTime(0.0f),
+		_constraintSolverMt(nullptr),
 		_filePath(""),
 		_skyboxShader(nullptr),
 		_skyboxMesh(nullptr),
 		_skyboxTexture(nullptr),
 		_skyboxRotation(glm::mat3(1.0f)),
 		_ambientLight(glm::vec3(0.1f)),
-		_gravity(glm::vec3(0.0f, 0.42f, -9.81f))
+		_gravity(glm::vec3(0.0f, 0.42f, -9.81f)),
+		_fixedTimeStep(1.0f / 60.0f),
+		_maxPhysicsSubSteps(4),
+		_physicsAccumulator(0.0f),
+		_physicsInterpolation(0.0f),
+		_physicsStepCount(0),
+		_movingBodies(std::vector<Physics::RigidBody*>()),
+		_dirtyPhysics(std::vector<Physics::PhysicsBase*>())
 	{
+		{
+			std::unique_lock<std::shared_mutex> lock(_liveScenesLock);
+			_liveScenes[_sceneId] = this;
+		}
+
 		GameObject::Sptr mainCam = CreateGameObject("Main Camera");		
 		MainCamera = mainCam->Add<Camera>();
 
@@ -42,12 +464,22 @@ namespace Gameplay {
 	}
 
 	Scene::~Scene() {
+		// Unregister first, so that any references resolved while tearing down the scene come back empty
+		{
+			std::unique_lock<std::shared_mutex> lock(_liveScenesLock);
+			_liveScenes.erase(_sceneId);
+		}
+
 		MainCamera = nullptr;
 		DefaultMaterial = nullptr; 
 		_skyboxShader = nullptr;
 		_skyboxMesh = nullptr;
 		_skyboxTexture = nullptr;
 		_objects.clear();
+		_objectsByGuid.clear();
+		_objectSlots.clear();
+		_freeObjectSlots.clear();
+		_transforms.Clear();
 		_components.Clear();
 		_CleanupPhysics();
 		IsDestroyed = true;
@@ -99,10 +531,30 @@ namespace Gameplay {
 		result->Name = name;
 		result->_scene = this;
 		result->_selfRef = result;
-		_objects.push_back(result);
+		_RegisterObject(result);
 		return result;
 	}
 
+	GameObject::Sptr Scene::Instantiate(const Prefab::Sptr& prefab, const glm::vec3& position)
+	{
+		std::vector<GameObject::Sptr> objects;
+		std::vector<Guid> parents;
+		prefab->Construct(this, Guid::New(), nlohmann::json(), objects, parents);
+
+		GameObject::Sptr root = objects[0];
+		root->SetPostion(position);
+
+		_LinkLoadedObjects(objects, parents);
+		_UploadLoadedObjects(objects);
+		if (_isAwake) {
+			for (const auto& object : objects) {
+				object->Awake();
+			}
+		}
+
+		return root;
+	}
+
 	void Scene::RemoveGameObject(const GameObject::Sptr& object) {
 		_deletionQueue.push_back(object);
 		for (const auto& child : object->_children) {
@@ -118,10 +570,8 @@ namespace Gameplay {
 	}
 
 	GameObject::Sptr Scene::FindObjectByGUID(Guid id) const {
-		auto it = std::find_if(_objects.begin(), _objects.end(), [&](const GameObject::Sptr& obj) {
-			return obj->_guid == id;
-		});
-		return it == _objects.end() ? nullptr : *it;
+		auto it = _objectsByGuid.find(id);
+		return it == _objectsByGuid.end() ? nullptr : it->second;
 	}
 
 	void Scene::SetAmbientLight(const glm::vec3& value) {
@@ -132,6 +582,16 @@ namespace Gameplay {
 		return _ambientLight;
 	}
 
+	void Scene::SetFixedTimeStep(float value) {
+		LOG_ASSERT(value > 0.0f, "Physics time step must be greater than zero!");
+		_fixedTimeStep = value;
+	}
+
+	void Scene::SetMaxPhysicsSubSteps(int value) {
+		LOG_ASSERT(value >= 1, "Physics must be able to take at least one step per frame!");
+		_maxPhysicsSubSteps = value;
+	}
+
 	void Scene::Awake() {
 		// Not a huge fan of this, but we need to get window size to notify our camera
 		// of the current screen size
@@ -157,24 +617,52 @@ namespace Gameplay {
 	}
 
 	void Scene::DoPhysics(float dt) {
-		_components.Each<Gameplay::Physics::RigidBody>([=](const std::shared_ptr<Gameplay::Physics::RigidBody>& body) {
-			body->PhysicsPreStep(dt);
-		});
-		_components.Each<Gameplay::Physics::TriggerVolume>([=](const std::shared_ptr<Gameplay::Physics::TriggerVolume>& body) {
-			body->PhysicsPreStep(dt);
-		});
+		auto start = std::chrono::high_resolution_clock::now();
+
+		// Only bodies that have changed since last frame need to push anything to bullet. We walk the list by index,
+		// so that bodies marked dirty while pre-stepping are handled as well
+		for (size_t ix = 0; ix < _dirtyPhysics.size(); ix++) {
+			_dirtyPhysics[ix]->PhysicsPreStep(dt);
+		}
+		for (Physics::PhysicsBase* body : _dirtyPhysics) {
+			body->_isPhysicsDirty = false;
+		}
+		_dirtyPhysics.clear();
 
 		if (IsPlaying) {
+			// Work out how many whole steps we owe, if we've fallen too far behind we drop the extra time rather
+			// than taking even longer next frame trying to catch up
+			_physicsAccumulator += dt;
+			int steps = static_cast<int>(_physicsAccumulator / _fixedTimeStep);
+			if (steps > _maxPhysicsSubSteps) {
+				steps = _maxPhysicsSubSteps;
+				_physicsAccumulator = steps * _fixedTimeStep + std::fmod(_physicsAccumulator, _fixedTimeStep);
+			}
+
+			// Bullet notifies dynamic bodies that moved during each step through their motion states
+			for (int ix = 0; ix < steps; ix++) {
+				_physicsStepCount++;
+				_physicsWorld->stepSimulation(_fixedTimeStep, 0);
+			}
 
-			_physicsWorld->stepSimulation(dt, 1);
+			// The leftover time tells us how far we are towards the next step
+			_physicsAccumulator = std::max(_physicsAccumulator - steps * _fixedTimeStep, 0.0f);
+			_physicsInterpolation = glm::clamp(_physicsAccumulator / _fixedTimeStep, 0.0f, 1.0f);
 
-			_components.Each<Gameplay::Physics::RigidBody>([=](const std::shared_ptr<Gameplay::Physics::RigidBody>& body) {
-				body->PhysicsPostStep(dt);
-			});
-			_components.Each<Gameplay::Physics::TriggerVolume>([=](const std::shared_ptr<Gameplay::Physics::TriggerVolume>& body) {
-				body->PhysicsPostStep(dt);
-			});
+			// Only bodies that have moved recently need to be copied back, bodies remove themselves from
+			// the list once they've come to rest, so we walk it backwards
+			for (size_t ix = _movingBodies.size(); ix-- > 0;) {
+				_movingBodies[ix]->PhysicsPostStep(dt);
+			}
+			// Triggers use the contacts found during the step, so there's nothing new for them if we didn't step
+			if (steps > 0) {
+				_components.ForEach<Gameplay::Physics::TriggerVolume>([=](Gameplay::Physics::TriggerVolume& body) {
+					body.PhysicsPostStep(dt);
+				});
+			}
 		}
+
+		_lastPhysicsTime = std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
 	}
 
 	void Scene::DrawPhysicsDebug() {
@@ -184,14 +672,177 @@ namespace Gameplay {
 		}
 	}
 
+	void Scene::Raycast(const std::vector<Physics::RayQuery>& queries, std::vector<Physics::QueryHit>& results) const {
+		results.resize(queries.size());
+		RunParallel(queries.size(), QueryBatchSize, [&](size_t begin, size_t end) {
+			for (size_t ix = begin; ix < end; ix++) {
+				RayQueryCallback callback(queries[ix]);
+				_physicsWorld->rayTest(callback.m_rayFromWorld, callback.m_rayToWorld, callback);
+
+				Physics::QueryHit& result = results[ix];
+				if (callback.hasHit()) {
+					result.Object   = _GetObjectRef(callback.m_collisionObject);
+					result.Point    = ToGlm(callback.m_hitPointWorld);
+					result.Normal   = ToGlm(callback.m_hitNormalWorld);
+					result.Fraction = callback.m_closestHitFraction;
+				} else {
+					result = Physics::QueryHit();
+				}
+			}
+		});
+	}
+
+	void Scene::SphereCast(const std::vector<Physics::SphereCastQuery>& queries, std::vector<Physics::QueryHit>& results) const {
+		results.resize(queries.size());
+		RunParallel(queries.size(), QueryBatchSize, [&](size_t begin, size_t end) {
+			btTransform from, to;
+			from.setIdentity();
+			to.setIdentity();
+
+			for (size_t ix = begin; ix < end; ix++) {
+				const Physics::SphereCastQuery& query = queries[ix];
+				btSphereShape sphere(query.Radius);
+				from.setOrigin(ToBt(query.From));
+				to.setOrigin(ToBt(query.To));
+
+				SphereCastQueryCallback callback(query);
+				_physicsWorld->convexSweepTest(&sphere, from, to, callback);
+
+				Physics::QueryHit& result = results[ix];
+				if (callback.hasHit()) {
+					result.Object   = _GetObjectRef(callback.m_hitCollisionObject);
+					result.Point    = ToGlm(callback.m_hitPointWorld);
+					result.Normal   = ToGlm(callback.m_hitNormalWorld);
+					result.Fraction = callback.m_closestHitFraction;
+				} else {
+					result = Physics::QueryHit();
+				}
+			}
+		});
+	}
+
+	void Scene::Overlap(const std::vector<Physics::OverlapQuery>& queries, Physics::OverlapResults& results) const {
+		results.Objects.clear();
+		results.Offsets.assign(queries.size() + 1, 0);
+
+		// We don't know how many objects each query will find, so each batch collects it's objects into it's
+		// own list (and the counts into the offsets), and we stitch them together in order afterwards
+		std::vector<std::vector<GameObject::WeakRef>> batches((queries.size() + QueryBatchSize - 1) / QueryBatchSize);
+		RunParallel(queries.size(), QueryBatchSize, [&](size_t begin, size_t end) {
+			std::vector<GameObject::WeakRef>& found = batches[begin / QueryBatchSize];
+			std::vector<const btCollisionObject*> candidates;
+			btTransform sphereTransform;
+			sphereTransform.setIdentity();
+
+			for (size_t ix = begin; ix < end; ix++) {
+				const Physics::OverlapQuery& query = queries[ix];
+				btSphereShape sphere(query.Radius);
+				sphereTransform.setOrigin(ToBt(query.Center));
+
+				// Use the broadphase to find everything with bounds touching the sphere's bounds, then check the actual shapes
+				candidates.clear();
+				OverlapCandidateCallback callback(query, candidates);
+				_broadphaseInterface->aabbTest(ToBt(query.Center - glm::vec3(query.Radius)), ToBt(query.Center + glm::vec3(query.Radius)), callback);
+
+				uint32_t count = 0;
+				for (const btCollisionObject* object : candidates) {
+					if (SphereOverlapsShape(sphere, sphereTransform, object->getCollisionShape(), object->getWorldTransform())) {
+						GameObject::WeakRef ref = _GetObjectRef(object);
+						if (!ref.GetIsEmpty()) {
+							found.push_back(ref);
+							count++;
+						}
+					}
+				}
+				results.Offsets[ix + 1] = count;
+			}
+		});
+
+		// Turn the counts into offsets, and copy each batch's objects into the final list
+		for (size_t ix = 0; ix < queries.size(); ix++) {
+			results.Offsets[ix + 1] += results.Offsets[ix];
+		}
+		results.Objects.reserve(results.Offsets.back());
+		for (const auto& batch : batches) {
+			results.Objects.insert(results.Objects.end(), batch.begin(), batch.end());
+		}
+	}
+
+	GameObject::WeakRef Scene::_GetObjectRef(const btCollisionObject* object) const {
+		GameObject::WeakRef result;
+
+		// All our physics components store a weak pointer to themselves in their bullet object's user pointer
+		const std::weak_ptr<IComponent>* component = reinterpret_cast<const std::weak_ptr<IComponent>*>(object->getUserPointer());
+		if (component == nullptr) {
+			return result;
+		}
+		IComponent::Sptr ptr = component->lock();
+		GameObject* owner = ptr != nullptr ? ptr->GetGameObject() : nullptr;
+
+		// Build the handle directly from the object's slot, so we don't need to touch the object's reference count
+		if (owner != nullptr) {
+			result.SceneId      = _sceneId;
+			result.SlotIndex    = owner->_slotIndex;
+			result.Generation   = owner->_slotGeneration;
+		}
+		return result;
+	}
+
 	void Scene::Update(float dt) {
+		auto start = std::chrono::high_resolution_clock::now();
+
 		_FlushDeleteQueue();
 		if (IsPlaying) {
+			// Components that are not thread safe are updated in scene order, exactly as before
 			for (int i = 0; i < _objects.size(); i++) {
 				_objects[i]->Update(dt);
 			}
+			// Thread safe components are updated afterwards, in parallel
+			_UpdateParallelComponents(dt);
 		}
 		_FlushDeleteQueue();
+
+		// Bring all world transforms up to date in one pass, rather than having each object
+		// lazily walk up it's parents when it's transform is first requested
+		_transforms.Update();
+
+		_lastUpdateTime = std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+	}
+
+	void Scene::_UpdateParallelComponents(float dt) {
+		for (const std::vector<uint32_t>& batch : ComponentManager::GetParallelUpdateBatches()) {
+			// Treat all the pools in the batch as one long range, so that small pools don't each need their own jobs
+			std::vector<std::pair<std::type_index, size_t>> ranges;
+			size_t total = 0;
+			for (uint32_t typeId : batch) {
+				const std::type_index& type = ComponentManager::GetTypeFromId(typeId);
+				size_t count = _components.Count(type);
+				if (count > 0) {
+					ranges.emplace_back(type, count);
+					total += count;
+				}
+			}
+
+			auto updateRange = [&](size_t begin, size_t end) {
+				size_t offset = 0;
+				for (const auto& [type, count] : ranges) {
+					if (begin < offset + count && end > offset) {
+						size_t first = begin > offset ? begin - offset : 0;
+						_components.ForEachInRange(type, first, end - offset, [dt](IComponent& component) {
+							component.Update(dt);
+						});
+					}
+					offset += count;
+				}
+			};
+
+			// Without a job system (ex: tools that load scenes outside of the application) we just update serially
+			if (JobSystem::IsInitialized()) {
+				JobSystem::Get().ParallelFor(total, 0, updateRange);
+			} else {
+				updateRange(0, total);
+			}
+		}
 	}
 
 	void Scene::RenderGUI()
@@ -214,12 +865,28 @@ namespace Gameplay {
 		Scene::Sptr result = std::make_shared<Scene>();
 		result->MainCamera = nullptr;
 		result->_objects.clear();
+		result->_objectsByGuid.clear();
+		result->_objectSlots.clear();
+		result->_freeObjectSlots.clear();
+		result->_transforms.Clear();
+
+		// Make sure all the resources the scene uses are loaded up front, so that components can look them up from worker threads
+		auto phaseStart = std::chrono::high_resolution_clock::now();
+		ResourceManager::PreloadDependencies(ResourceManager::GetDependencies(data));
+		double resourceMs = EndLoadPhase(phaseStart);
+
 		result->DefaultMaterial = ResourceManager::Get<Material>(Guid(data["default_material"]));
 
 		if (data.contains("ambient")) {
 			result->SetAmbientLight((data["ambient"]));
 		}
 
+		if (data.contains("physics") && data["physics"].is_object()) {
+			const nlohmann::json& blob = data["physics"];
+			result->SetFixedTimeStep(JsonGet(blob, "fixed_step", result->_fixedTimeStep));
+			result->SetMaxPhysicsSubSteps(JsonGet(blob, "max_substeps", result->_maxPhysicsSubSteps));
+		}
+
 		if (data.contains("skybox") && data["skybox"].is_object()) {
 			nlohmann::json& blob = data["skybox"].get<nlohmann::json>();
 			result->_skyboxMesh = ResourceManager::Get<MeshResource>(Guid(blob["mesh"]));
@@ -230,24 +897,45 @@ namespace Gameplay {
 
 		// Make sure the scene has objects, then load them all in!
 		LOG_ASSERT(data["objects"].is_array(), "Objects not present in scene!");
-		for (auto& object : data["objects"]) {
-			GameObject::Sptr obj = GameObject::FromJson(result.get(), object);
-			obj->_scene = result.get();
-			obj->_parent.SceneContext = result.get();
-			obj->_selfRef = obj;
-			result->_objects.push_back(obj);
-		}
-
-		// Re-build the parent hierarchy 
-		for (const auto& object : result->_objects) {
-			if (object->GetParent() != nullptr) {
-				object->GetParent()->AddChild(object);
+		const nlohmann::json& objects = data["objects"];
+		phaseStart = std::chrono::high_resolution_clock::now();
+
+		// Objects don't depend on each other until they are linked, so we can construct them in parallel. Prefab
+		// instances expand into multiple objects, so each entry gets it's own group that we flatten afterwards
+		std::vector<std::vector<GameObject::Sptr>> loadedGroups(objects.size());
+		std::vector<std::vector<Guid>> parentGroups(objects.size());
+		RunParallel(objects.size(), LoadBatchSize, [&](size_t begin, size_t end) {
+			for (size_t ix = begin; ix < end; ix++) {
+				const nlohmann::json& object = objects[ix];
+				if (object.contains("prefab")) {
+					Prefab::ConstructInstance(result.get(), object, loadedGroups[ix], parentGroups[ix]);
+				} else {
+					loadedGroups[ix].push_back(GameObject::ConstructFromJson(result.get(), object));
+					parentGroups[ix].push_back(object.contains("parent") && object["parent"] != "null" ? Guid(object["parent"]) : Guid());
+				}
 			}
+		});
+
+		std::vector<GameObject::Sptr> loaded;
+		std::vector<Guid> parents;
+		loaded.reserve(objects.size());
+		parents.reserve(objects.size());
+		for (size_t ix = 0; ix < objects.size(); ix++) {
+			loaded.insert(loaded.end(), loadedGroups[ix].begin(), loadedGroups[ix].end());
+			parents.insert(parents.end(), parentGroups[ix].begin(), parentGroups[ix].end());
 		}
+		double constructMs = EndLoadPhase(phaseStart);
 
+		result->_LinkLoadedObjects(loaded, parents);
 		// Create and load camera config
 		result->MainCamera = result->_components.GetComponentByGUID<Camera>(Guid(data["main_camera"]));
-	
+		double linkMs = EndLoadPhase(phaseStart);
+
+		result->_UploadLoadedObjects(loaded);
+		double uploadMs = EndLoadPhase(phaseStart);
+
+		LOG_INFO("Scene load phases: resources {:.2f}ms, construct {:.2f}ms, link {:.2f}ms, upload {:.2f}ms", 
+			resourceMs, constructMs, linkMs, uploadMs);
 		return result;
 	}
 
@@ -259,43 +947,320 @@ namespace Gameplay {
 
 		blob["ambient"] = GetAmbientLight();
 
+		blob["physics"] = nlohmann::json();
+		blob["physics"]["fixed_step"] = _fixedTimeStep;
+		blob["physics"]["max_substeps"] = _maxPhysicsSubSteps;
+
 		blob["skybox"] = nlohmann::json();
 		blob["skybox"]["mesh"] = _skyboxMesh ? _skyboxMesh->GetGUID().str() : "null";
 		blob["skybox"]["shader"] = _skyboxShader ? _skyboxShader->GetGUID().str() : "null";
 		blob["skybox"]["texture"] = _skyboxTexture ? _skyboxTexture->GetGUID().str() : "null";
 		blob["skybox"]["orientation"] = (glm::quat)_skyboxRotation;
 
-		// Save renderables
+		// Save renderables, objects inside of prefab instances are re-created by the instance's root
 		std::vector<nlohmann::json> objects;
-		objects.resize(_objects.size());
-		for (int ix = 0; ix < _objects.size(); ix++) {
-			objects[ix] = _objects[ix]->ToJson();
+		objects.reserve(_objects.size());
+		for (const auto& object : _objects) {
+			if (object->_prefab == nullptr || object->_prefabIndex == 0) {
+				objects.push_back(object->ToJson());
+			}
 		}
 		blob["objects"] = objects;
 
 		// Save camera info
 		blob["main_camera"] = MainCamera != nullptr ? MainCamera->GetGUID().str() : "null";
 
+		// Store the resources we use, so that they can be preloaded without searching the scene
+		ResourceManager::RecordDependencies(blob);
+
 		return blob;
 	}
 
 	void Scene::Save(const std::string& path) {
+		if (std::filesystem::path(path).extension() == BinaryExtension) {
+			SaveBinary(path);
+			return;
+		}
+
 		_filePath = path;
 		// Save data to file
-		FileHelpers::WriteContentsToFile(path, ToJson().dump(1, '\t'));
-		LOG_INFO("Saved scene to \"{}\"", path);
+		auto start = std::chrono::high_resolution_clock::now();
+		nlohmann::json snapshot = ToJson();
+		WriteSceneFile(path, snapshot, EndLoadPhase(start));
+	}
+
+	void Scene::SaveAsync(const std::string& path, bool updateFilePath) {
+		// We need a worker, since the main thread only runs queued jobs while it's waiting on them
+		if (!JobSystem::IsInitialized() || JobSystem::Get().WorkerCount() == 0) {
+			Save(path);
+			return;
+		}
+
+		if (updateFilePath) {
+			_filePath = path;
+		}
+
+		// The snapshot is the scene in the binary format, written with the same serializers as binary scenes.
+		// It's a compact copy of the scene's state, so once we have it the scene is free to keep changing while
+		// the snapshot is converted to JSON (if needed), compressed and written in the background
+		auto start = std::chrono::high_resolution_clock::now();
+		std::shared_ptr<std::string> snapshot = std::make_shared<std::string>(_ToBinary());
+		double snapshotMs = EndLoadPhase(start);
+
+		bool isBinary = std::filesystem::path(path).extension() == BinaryExtension;
+		PendingSaves.fetch_add(1);
+		JobSystem::Get().Run([path, snapshot, snapshotMs, isBinary]() {
+			if (isBinary) {
+				if (WriteSceneContents(path, *snapshot)) {
+					LOG_INFO("Saved binary scene to \"{}\" ({} bytes): snapshot {:.2f}ms", path, snapshot->size(), snapshotMs);
+				}
+			} else {
+				nlohmann::json blob = BinarySceneToJson(*snapshot);
+				if (!blob.is_null()) {
+					WriteSceneFile(path, blob, snapshotMs);
+				}
+			}
+			PendingSaves.fetch_sub(1);
+		});
+	}
+
+	bool Scene::IsSaveInProgress() {
+		return PendingSaves.load() > 0;
 	}
 
 	Scene::Sptr Scene::Load(const std::string& path)
 	{
+		if (IsBinaryScene(path)) {
+			return LoadBinary(path);
+		}
+
 		LOG_INFO("Loading scene from \"{}\"", path);
+		auto start = std::chrono::high_resolution_clock::now();
+
 		std::string content = FileHelpers::ReadFile(path);
+		// Compressed scenes (like autosaves) are detected from the gzip header, so the extension doesn't matter
+		if (gzip::is_compressed(content.data(), content.size())) {
+			content = gzip::decompress(content.data(), content.size());
+		}
 		nlohmann::json blob = nlohmann::json::parse(content);
+		double readMs = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+		LOG_INFO("Read and parsed scene in {:.2f}ms", readMs);
+
 		Scene::Sptr result = FromJson(blob);
 		result->_filePath = path;
+
+		double elapsedMs = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+		LOG_INFO("Loaded {} objects in {:.2f}ms", result->NumObjects(), elapsedMs);
+		return result;
+	}
+
+	void Scene::SaveBinary(const std::string& path) {
+		_filePath = path;
+		if (WriteSceneContents(path, _ToBinary())) {
+			LOG_INFO("Saved binary scene to \"{}\"", path);
+		}
+	}
+
+	std::string Scene::_ToBinary() const {
+		// The objects are written first, since we find the resources they use while writing
+		// them, and those need to go before the objects so that they can be preloaded
+		std::ostringstream objectStream(std::ios::binary);
+		std::vector<uint64_t> objectOffsets;
+		std::vector<Guid> dependencies;
+		objectOffsets.reserve(_objects.size());
+		{
+			cereal::BinaryOutputArchive objectArchive(objectStream);
+			for (const auto& object : _objects) {
+				// Like JSON scenes, prefab instances are stored as a single record that re-creates the whole instance
+				bool isInstance = object->_prefab != nullptr;
+				if (isInstance && object->_prefabIndex != 0) {
+					continue;
+				}
+
+				objectOffsets.push_back(static_cast<uint64_t>(objectStream.tellp()));
+				GameObject::Sptr parent = object->GetParent();
+				objectArchive(parent != nullptr ? parent->GetGUID() : Guid(), isInstance);
+				if (isInstance) {
+					object->_prefab->InstanceToBinary(*object, objectArchive, &dependencies);
+				} else {
+					object->ToBinary(objectArchive, &dependencies);
+				}
+			}
+		}
+
+		std::ostringstream stream(std::ios::binary);
+		cereal::BinaryOutputArchive archive(stream);
+		archive(cereal::binary_data(BinarySceneMagic, sizeof(BinarySceneMagic)), BinaryVersion);
+
+		// Scene settings, in the same order as FromJson
+		archive(
+			DefaultMaterial ? DefaultMaterial->GetGUID() : Guid(),
+			GetAmbientLight(),
+			_fixedTimeStep,
+			_maxPhysicsSubSteps,
+			_skyboxMesh ? _skyboxMesh->GetGUID() : Guid(),
+			_skyboxShader ? _skyboxShader->GetGUID() : Guid(),
+			_skyboxTexture ? _skyboxTexture->GetGUID() : Guid(),
+			(glm::quat)_skyboxRotation,
+			MainCamera != nullptr ? MainCamera->GetGUID() : Guid()
+		);
+
+		// Components are stored in binary, so we can't search them for resources on load. Instead we store
+		// the resources that the scene and it's components reported while they were written
+		if (DefaultMaterial) dependencies.push_back(DefaultMaterial->GetGUID());
+		if (_skyboxMesh) dependencies.push_back(_skyboxMesh->GetGUID());
+		if (_skyboxShader) dependencies.push_back(_skyboxShader->GetGUID());
+		if (_skyboxTexture) dependencies.push_back(_skyboxTexture->GetGUID());
+		std::sort(dependencies.begin(), dependencies.end());
+		dependencies.erase(std::unique(dependencies.begin(), dependencies.end()), dependencies.end());
+		archive(dependencies);
+
+		// Objects store components by type ID, so we store the names of the types so that we can map them
+		// back to IDs on load (IDs depend on registration order, which may change between builds)
+		uint32_t typeCount = ComponentManager::TypeCount();
+		archive(typeCount);
+		for (uint32_t ix = 0; ix < typeCount; ix++) {
+			archive(ComponentManager::GetTypeName(ix));
+		}
+
+		// Objects are stored in a flat list, each preceded by it's parent's GUID and whether it is a prefab
+		// instance. We remember where each record starts so that ranges of records can be read in parallel
+		archive(static_cast<uint32_t>(objectOffsets.size()));
+		uint64_t objectsStart = static_cast<uint64_t>(stream.tellp());
+		const std::string objectData = objectStream.str();
+		stream.write(objectData.data(), objectData.size());
+		for (uint64_t& offset : objectOffsets) {
+			offset += objectsStart;
+		}
+
+		// The object offsets go at the end, followed by the location of the offset table
+		uint64_t tableOffset = static_cast<uint64_t>(stream.tellp());
+		archive(cereal::binary_data(objectOffsets.data(), objectOffsets.size() * sizeof(uint64_t)), tableOffset);
+		return stream.str();
+	}
+
+	Scene::Sptr Scene::LoadBinary(const std::string& path)
+	{
+		LOG_INFO("Loading binary scene from \"{}\"", path);
+		auto start = std::chrono::high_resolution_clock::now();
+		auto phaseStart = start;
+
+		// We read the whole file up front, so that worker threads can each read their own range of objects
+		std::string data = FileHelpers::ReadFile(path);
+		BinarySceneHeader header;
+		if (!ReadBinarySceneHeader(data, path, header)) {
+			return nullptr;
+		}
+		const std::vector<uint32_t>& typeIds = header.TypeIds;
+		const std::vector<uint64_t>& offsets = header.Offsets;
+		const uint64_t tableOffset = header.TableOffset;
+		const size_t objectCount = offsets.size();
+		double readMs = EndLoadPhase(phaseStart);
+
+		Scene::Sptr result = std::make_shared<Scene>();
+		result->MainCamera = nullptr;
+		result->_objects.clear();
+		result->_objectsByGuid.clear();
+		result->_objectSlots.clear();
+		result->_freeObjectSlots.clear();
+		result->_transforms.Clear();
+
+		// Make sure all the resources the scene uses are loaded up front, so that components can look them up from worker threads
+		ResourceManager::PreloadDependencies(header.Dependencies);
+		result->DefaultMaterial = ResourceManager::Get<Material>(header.DefaultMaterial);
+		result->SetAmbientLight(header.Ambient);
+		result->SetFixedTimeStep(header.FixedTimeStep);
+		result->SetMaxPhysicsSubSteps(header.MaxPhysicsSubSteps);
+		result->_skyboxMesh = ResourceManager::Get<MeshResource>(header.SkyboxMesh);
+		result->SetSkyboxShader(ResourceManager::Get<ShaderProgram>(header.SkyboxShader));
+		result->SetSkyboxTexture(ResourceManager::Get<TextureCube>(header.SkyboxTexture));
+		result->SetSkyboxRotation(glm::mat3_cast(header.SkyboxRotation));
+		double resourceMs = EndLoadPhase(phaseStart);
+
+		// Each job reads a contiguous range of records with it's own stream over the file data. Prefab instances
+		// expand into multiple objects, so each record gets it's own group that we flatten afterwards
+		std::vector<std::vector<GameObject::Sptr>> loadedGroups(objectCount);
+		std::vector<std::vector<Guid>> parentGroups(objectCount);
+		std::atomic<bool> isCorrupt(false);
+		RunParallel(objectCount, LoadBatchSize, [&](size_t begin, size_t end) {
+			// Exceptions can't leave the job, so corrupt records are reported once all the jobs are done
+			try {
+				MemoryInputStream rangeStream(data.data() + offsets[begin], data.data() + tableOffset);
+				cereal::BinaryInputArchive rangeArchive(rangeStream);
+				for (size_t ix = begin; ix < end; ix++) {
+					Guid parent;
+					bool isInstance = false;
+					rangeArchive(parent, isInstance);
+					if (isInstance) {
+						if (Prefab::ConstructInstanceFromBinary(result.get(), rangeArchive, loadedGroups[ix], parentGroups[ix])) {
+							parentGroups[ix][0] = parent;
+						}
+					} else {
+						loadedGroups[ix].push_back(GameObject::ConstructFromBinary(result.get(), rangeArchive, typeIds));
+						parentGroups[ix].push_back(parent);
+					}
+				}
+			} catch (const std::exception& e) {
+				LOG_ERROR("Failed to read objects {} to {} from binary scene \"{}\": {}", begin, end, path, e.what());
+				isCorrupt = true;
+			}
+		});
+		if (isCorrupt) {
+			LOG_ERROR("Binary scene \"{}\" is corrupt, it will not be loaded", path);
+			return nullptr;
+		}
+
+		std::vector<GameObject::Sptr> loaded;
+		std::vector<Guid> parents;
+		loaded.reserve(objectCount);
+		parents.reserve(objectCount);
+		for (size_t ix = 0; ix < objectCount; ix++) {
+			loaded.insert(loaded.end(), loadedGroups[ix].begin(), loadedGroups[ix].end());
+			parents.insert(parents.end(), parentGroups[ix].begin(), parentGroups[ix].end());
+		}
+		double constructMs = EndLoadPhase(phaseStart);
+
+		result->_LinkLoadedObjects(loaded, parents);
+		result->MainCamera = result->_components.GetComponentByGUID<Camera>(header.MainCamera);
+		result->_filePath = path;
+		double linkMs = EndLoadPhase(phaseStart);
+
+		result->_UploadLoadedObjects(loaded);
+		double uploadMs = EndLoadPhase(phaseStart);
+
+		double elapsedMs = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+		LOG_INFO("Scene load phases: read {:.2f}ms, resources {:.2f}ms, construct {:.2f}ms, link {:.2f}ms, upload {:.2f}ms",
+			readMs, resourceMs, constructMs, linkMs, uploadMs);
+		LOG_INFO("Loaded {} objects in {:.2f}ms", result->NumObjects(), elapsedMs);
 		return result;
 	}
 
+	bool Scene::IsBinaryScene(const std::string& path) {
+		// Packed scenes don't exist on disk, so we check the asset archive first
+		std::string_view packed = VirtualFileSystem::GetView(path);
+		if (packed.data() != nullptr) {
+			return packed.size() >= sizeof(BinarySceneMagic) && memcmp(packed.data(), BinarySceneMagic, sizeof(BinarySceneMagic)) == 0;
+		}
+
+		std::ifstream file(path, std::ios::binary);
+		char magic[sizeof(BinarySceneMagic)];
+		return file.read(magic, sizeof(magic)) && memcmp(magic, BinarySceneMagic, sizeof(magic)) == 0;
+	}
+
+	bool Scene::ConvertToBinary(const std::string& inputPath, const std::string& outputPath) {
+		if (!VirtualFileSystem::Exists(inputPath)) {
+			LOG_WARN("Cannot convert \"{}\", file does not exist", inputPath);
+			return false;
+		}
+
+		Scene::Sptr scene = Load(inputPath);
+		if (scene == nullptr) {
+			return false;
+		}
+		scene->SaveBinary(outputPath);
+		return true;
+	}
+
 	int Scene::NumObjects() const {
 		return static_cast<int>(_objects.size());
 	}
@@ -305,18 +1270,54 @@ namespace Gameplay {
 	}
 
 	void Scene::_InitPhysics() {
-		_collisionConfig = new btDefaultCollisionConfiguration();
-		_collisionDispatcher = new btCollisionDispatcher(_collisionConfig);
+		// The multithreaded world needs the job system to run on
+		bool multithreaded = UseMultithreadedPhysics && JobSystem::IsInitialized();
+
+		if (multithreaded) {
+			// Bullet's Mt classes size their per-thread storage from the scheduler, so it must be installed first
+			BulletTaskScheduler::Install();
+
+			// Collision algorithms and manifolds get allocated from multiple threads, so we make sure the pools
+			// are large enough that we don't fall back to the (locking) heap for large scenes
+			btDefaultCollisionConstructionInfo constructionInfo;
+			constructionInfo.m_defaultMaxPersistentManifoldPoolSize = 80000;
+			constructionInfo.m_defaultMaxCollisionAlgorithmPoolSize = 80000;
+			_collisionConfig = new btDefaultCollisionConfiguration(constructionInfo);
+			_collisionDispatcher = new btCollisionDispatcherMt(_collisionConfig, 40);
+		} else {
+			_collisionConfig = new btDefaultCollisionConfiguration();
+			_collisionDispatcher = new btCollisionDispatcher(_collisionConfig);
+		}
+
 		_broadphaseInterface = new btDbvtBroadphase();
 		_ghostCallback = new btGhostPairCallback();
 		_broadphaseInterface->getOverlappingPairCache()->setInternalGhostPairCallback(_ghostCallback);
-		_constraintSolver = new btSequentialImpulseConstraintSolver();
-		_physicsWorld = new btDiscreteDynamicsWorld(
-			_collisionDispatcher,
-			_broadphaseInterface,
-			_constraintSolver,
-			_collisionConfig
-		);
+
+		if (multithreaded) {
+			// Small islands are solved in parallel using a pool of regular solvers, while large islands are
+			// solved by the Mt solver, which splits the island's constraints into batches
+			btConstraintSolverPoolMt* solverPool = new btConstraintSolverPoolMt(btGetTaskScheduler()->getNumThreads());
+			btSequentialImpulseConstraintSolverMt* solverMt = new btSequentialImpulseConstraintSolverMt();
+			_constraintSolver = solverPool;
+			_constraintSolverMt = solverMt;
+			_physicsWorld = new btDiscreteDynamicsWorldMt(
+				_collisionDispatcher,
+				_broadphaseInterface,
+				solverPool,
+				solverMt,
+				_collisionConfig
+			);
+			LOG_INFO("Created multithreaded physics world");
+		} else {
+			_constraintSolver = new btSequentialImpulseConstraintSolver();
+			_constraintSolverMt = nullptr;
+			_physicsWorld = new btDiscreteDynamicsWorld(
+				_collisionDispatcher,
+				_broadphaseInterface,
+				_constraintSolver,
+				_collisionConfig
+			);
+		}
 		_physicsWorld->setGravity(ToBt(_gravity));
 		// TODO bullet debug drawing
 		_bulletDebugDraw = new BulletDebugDraw();
@@ -327,6 +1328,7 @@ namespace Gameplay {
 	void Scene::_CleanupPhysics() {
 		delete _physicsWorld;
 		delete _constraintSolver;
+		delete _constraintSolverMt;
 		delete _broadphaseInterface;
 		delete _ghostCallback;
 		delete _collisionDispatcher;
@@ -337,14 +1339,101 @@ namespace Gameplay {
 	void Scene::_FlushDeleteQueue() {
 		for (auto& weakPtr : _deletionQueue) {
 			if (weakPtr.expired()) continue;
-			auto& it = std::find(_objects.begin(), _objects.end(), weakPtr.lock());
+			GameObject::Sptr object = weakPtr.lock();
+			auto& it = std::find(_objects.begin(), _objects.end(), object);
 			if (it != _objects.end()) {
 				_objects.erase(it);
 			}
+			_objectsByGuid.erase(object->_guid);
+			_ReleaseSlot(object.get());
 		}
 		_deletionQueue.clear();
 	}
 
+	void Scene::_RegisterObject(const GameObject::Sptr& object) {
+		_objects.push_back(object);
+		_objectsByGuid[object->_guid] = object;
+
+		// Re-use a free slot if we have one, otherwise grow the table
+		uint32_t index;
+		if (_freeObjectSlots.size() > 0) {
+			index = _freeObjectSlots.back();
+			_freeObjectSlots.pop_back();
+		} else {
+			index = static_cast<uint32_t>(_objectSlots.size());
+			// Generations start at 1, so that a generation of 0 never refers to a live object
+			_objectSlots.push_back({ nullptr, 1 });
+		}
+
+		_objectSlots[index].Object = object.get();
+		object->_slotIndex = index;
+		object->_slotGeneration = _objectSlots[index].Generation;
+		_transforms.Add(object.get(), index);
+
+		for (const auto& component : object->_components) {
+			_components.Add(component);
+		}
+	}
+
+	void Scene::_LinkLoadedObjects(const std::vector<GameObject::Sptr>& objects, const std::vector<Guid>& parents) {
+		_objects.reserve(_objects.size() + objects.size());
+		_objectsByGuid.reserve(_objectsByGuid.size() + objects.size());
+		for (const auto& object : objects) {
+			_RegisterObject(object);
+		}
+
+		// Re-build the parent hierarchy, now that all objects exist we can resolve parent GUIDs
+		for (size_t ix = 0; ix < objects.size(); ix++) {
+			if (parents[ix].isValid()) {
+				GameObject::Sptr parent = FindObjectByGUID(parents[ix]);
+				if (parent != nullptr) {
+					parent->AddChild(objects[ix]);
+				} else {
+					LOG_WARN("Could not find parent for object \"{}\"", objects[ix]->Name);
+				}
+			}
+		}
+	}
+
+	void Scene::_UploadLoadedObjects(const std::vector<GameObject::Sptr>& objects) {
+		for (const auto& object : objects) {
+			for (const auto& component : object->_components) {
+				component->OnLoad();
+			}
+		}
+	}
+
+	void Scene::_ReleaseSlot(GameObject* object) {
+		uint32_t index = object->_slotIndex;
+		if (index < _objectSlots.size() && _objectSlots[index].Object == object) {
+			// Bumping the generation invalidates any handles to the object
+			_objectSlots[index].Object = nullptr;
+			// Skip 0 when wrapping around, since it is reserved for unregistered objects
+			if (++_objectSlots[index].Generation == 0) {
+				_objectSlots[index].Generation = 1;
+			}
+			_freeObjectSlots.push_back(index);
+			_transforms.Remove(index);
+		}
+	}
+
+	GameObject* Scene::_ResolveSlot(uint32_t index, uint32_t generation) const {
+		if (generation != 0 && index < _objectSlots.size()) {
+			const ObjectSlot& slot = _objectSlots[index];
+			return slot.Generation == generation ? slot.Object : nullptr;
+		}
+		return nullptr;
+	}
+
+	GameObject* Scene::_ResolveHandle(uint32_t sceneId, uint32_t index, uint32_t generation) {
+		if (sceneId == 0) {
+			return nullptr;
+		}
+		std::shared_lock<std::shared_mutex> lock(_liveScenesLock);
+		auto it = _liveScenes.find(sceneId);
+		return it != _liveScenes.end() ? it->second->_ResolveSlot(index, generation) : nullptr;
+	}
+
 	void Scene::DrawAllGameObjectGUIs()
 	{
 		for (auto& object : _objects) {
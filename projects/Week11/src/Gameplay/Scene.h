@@ -1,9 +1,14 @@
 #pragma once
+#include <atomic>
+#include <shared_mutex>
+#include <unordered_map>
 #include <btBulletDynamicsCommon.h>
 #include "BulletCollision/CollisionDispatch/btGhostObject.h"
 
 #include "Gameplay/Components/Camera.h"
 #include "Gameplay/GameObject.h"
+#include "Gameplay/TransformHierarchy.h"
+#include "Gameplay/Physics/PhysicsQueries.h"
 
 #include "Physics/BulletDebugDraw.h"
 
@@ -21,10 +26,12 @@ class HierarchyWindow;
 namespace Gameplay {
 	namespace Physics {
 		class RigidBody;
+		class PhysicsBase;
 	}
 
 	class MeshResource;
 	class Material;
+	class Prefab;
 
 	/// <summary>
 	/// Main class for our game structure
@@ -46,6 +53,12 @@ namespace Gameplay {
 
 		bool IsDestroyed;
 
+		/// <summary>
+		/// When true, scenes will use bullet's multithreaded dynamics world, which runs collision detection
+		/// and constraint solving on the job system. Only affects scenes created after it is set
+		/// </summary>
+		static bool UseMultithreadedPhysics;
+
 		Scene();
 		~Scene();
 
@@ -76,6 +89,14 @@ namespace Gameplay {
 		/// <param name="name">The name of the gameobject to create</param>
 		/// <returns>A new gameobject with the given name</returns>
 		GameObject::Sptr CreateGameObject(const std::string& name);
+		/// <summary>
+		/// Creates a new instance of a prefab in this scene. The instance is cloned from the prefab's template,
+		/// so this is much cheaper than loading the objects from JSON
+		/// </summary>
+		/// <param name="prefab">The prefab to instantiate</param>
+		/// <param name="position">The position for the root of the new instance</param>
+		/// <returns>The root object of the new instance</returns>
+		GameObject::Sptr Instantiate(const std::shared_ptr<Prefab>& prefab, const glm::vec3& position = glm::vec3(0.0f));
 
 		/// <summary>
 		/// Queues a game object for deletion at the call of the next Update function
@@ -108,6 +129,31 @@ namespace Gameplay {
 		/// </summary>
 		const glm::vec3& GetAmbientLight() const;
 
+		/// <summary>
+		/// Sets the fixed amount of time that the physics world advances by in each step
+		/// </summary>
+		/// <param name="value">The step size in seconds, must be greater than zero</param>
+		void SetFixedTimeStep(float value);
+		/// <summary>
+		/// Gets the fixed amount of time that the physics world advances by in each step, in seconds
+		/// </summary>
+		float GetFixedTimeStep() const { return _fixedTimeStep; }
+		/// <summary>
+		/// Sets the maximum number of physics steps that may be taken in a single frame. If a frame takes
+		/// longer than this many steps, the extra time is dropped so that physics can't spiral out of control
+		/// </summary>
+		/// <param name="value">The maximum number of steps per frame, must be at least 1</param>
+		void SetMaxPhysicsSubSteps(int value);
+		/// <summary>
+		/// Gets the maximum number of physics steps that may be taken in a single frame
+		/// </summary>
+		int GetMaxPhysicsSubSteps() const { return _maxPhysicsSubSteps; }
+		/// <summary>
+		/// Gets how far we are between the last physics step and the next one, in the 0-1 range. Rigidbodies
+		/// use this to blend between their last 2 physics states
+		/// </summary>
+		float GetPhysicsInterpolation() const { return _physicsInterpolation; }
+
 		/// <summary>
 		/// Gets the file path that this scene was saved to or loaded from
 		/// </summary>
@@ -172,24 +218,111 @@ namespace Gameplay {
 		const ComponentManager& Components() const { return _components; }
 
 		/// <summary>
-		/// Saves this scene to an output JSON file
+		/// Saves this scene to an output file. Paths ending in BinaryExtension are saved in the binary
+		/// format, all others are saved as JSON (gzipped for paths ending in CompressedExtension)
 		/// </summary>
 		/// <param name="path">The path of the file to write to</param>
 		void Save(const std::string& path);
 		/// <summary>
-		/// Loads a scene from an input JSON file
+		/// Loads a scene from an input file, either JSON or binary (detected from the file contents)
 		/// </summary>
 		/// <param name="path">The path of the file to read from</param>
 		/// <returns>A new scene loaded from the file</returns>
 		static Scene::Sptr Load(const std::string& path);
+		/// <summary>
+		/// Saves this scene without stalling the calling thread. Only a snapshot of the scene's state is taken
+		/// here (in the binary format), the snapshot is converted to JSON, compressed and written on a job system
+		/// thread. Saves without a job system worker fall back to Save
+		/// </summary>
+		/// <param name="path">The path of the file to write to, paths ending in CompressedExtension are gzipped</param>
+		/// <param name="updateFilePath">False to leave the scene's file path alone (ex: for autosaves)</param>
+		void SaveAsync(const std::string& path, bool updateFilePath = true);
+		/// <summary>
+		/// Returns true if any background saves have not finished writing yet
+		/// </summary>
+		static bool IsSaveInProgress();
+
+		// The file extension for gzip compressed JSON scenes, Load detects these automatically
+		inline static const std::string CompressedExtension = ".gz";
+
+		// The file extension used for binary scenes
+		inline static const std::string BinaryExtension = ".bscene";
+		// The version of the binary scene format, binary scenes with a different version must be re-converted
+		// from their JSON source
+		static constexpr uint32_t BinaryVersion = 4;
+
+		/// <summary>
+		/// Saves this scene in the binary scene format. Binary scenes are much faster to load than JSON, but are
+		/// only readable by builds with the same binary version and component types, so JSON should be kept
+		/// as the editable source of the scene
+		/// </summary>
+		/// <param name="path">The path of the file to write to</param>
+		void SaveBinary(const std::string& path);
+		/// <summary>
+		/// Loads a scene from a binary scene file, as written by SaveBinary
+		/// </summary>
+		/// <param name="path">The path of the file to read from</param>
+		/// <returns>A new scene loaded from the file, or nullptr if the file is not a valid binary scene</returns>
+		static Scene::Sptr LoadBinary(const std::string& path);
+		/// <summary>
+		/// Returns true if the file at the given path is a binary scene
+		/// </summary>
+		/// <param name="path">The path of the file to check</param>
+		static bool IsBinaryScene(const std::string& path);
+		/// <summary>
+		/// Converts a JSON scene file into a binary scene file. The scene's resources must already be
+		/// loaded (or in the resource manifest)
+		/// </summary>
+		/// <param name="inputPath">The path of the JSON scene to convert</param>
+		/// <param name="outputPath">The path to write the binary scene to</param>
+		/// <returns>True if the scene was converted</returns>
+		static bool ConvertToBinary(const std::string& inputPath, const std::string& outputPath);
 
 
 		int NumObjects() const;
 		GameObject::Sptr GetObjectByIndex(int index) const;
 
+		/// <summary>
+		/// Gets how long the last call to Update took, in milliseconds
+		/// </summary>
+		float GetLastUpdateTime() const { return _lastUpdateTime; }
+		/// <summary>
+		/// Gets how long the last call to DoPhysics took, in milliseconds
+		/// </summary>
+		float GetLastPhysicsTime() const { return _lastPhysicsTime; }
+		/// <summary>
+		/// Returns true if this scene is using bullet's multithreaded dynamics world
+		/// </summary>
+		bool IsPhysicsMultithreaded() const { return _constraintSolverMt != nullptr; }
+
+		/// <summary>
+		/// Casts a batch of rays through the physics world, spreading them across the job system. Should
+		/// be called between physics steps (ie not from within a component's physics callbacks)
+		/// </summary>
+		/// <param name="queries">The rays to cast</param>
+		/// <param name="results">Will be resized to match queries, and receive the closest hit for each ray</param>
+		void Raycast(const std::vector<Physics::RayQuery>& queries, std::vector<Physics::QueryHit>& results) const;
+		/// <summary>
+		/// Sweeps a batch of spheres through the physics world, spreading them across the job system. Should
+		/// be called between physics steps (ie not from within a component's physics callbacks)
+		/// </summary>
+		/// <param name="queries">The spheres to sweep</param>
+		/// <param name="results">Will be resized to match queries, and receive the first hit for each sphere</param>
+		void SphereCast(const std::vector<Physics::SphereCastQuery>& queries, std::vector<Physics::QueryHit>& results) const;
+		/// <summary>
+		/// Finds all the objects touching each of a batch of spheres, spreading them across the job system.
+		/// Should be called between physics steps (ie not from within a component's physics callbacks)
+		/// </summary>
+		/// <param name="queries">The spheres to test</param>
+		/// <param name="results">Will be cleared and receive the objects touching each sphere</param>
+		void Overlap(const std::vector<Physics::OverlapQuery>& queries, Physics::OverlapResults& results) const;
+
 	protected:
 		friend class HierarchyWindow;
 		friend class GameObject;
+		friend struct GameObject::WeakRef;
+		friend class Physics::RigidBody;
+		friend class Physics::PhysicsBase;
 
 		// The component manager will store all components for objects in this scene
 		ComponentManager _components;
@@ -204,6 +337,8 @@ namespace Gameplay {
 		btBroadphaseInterface*    _broadphaseInterface;
 		// Resolves contraints (ex: hinge constraints, angle axis, etc...)
 		btConstraintSolver*       _constraintSolver;
+		// Solves the islands that are too large to split up between threads, only used by the multithreaded world
+		btConstraintSolver*       _constraintSolverMt;
 		// this is what allows us to get our pairs from the trigger volumes
 		btGhostPairCallback*      _ghostCallback;
 
@@ -215,9 +350,44 @@ namespace Gameplay {
 		// Our physics scene's global gravity, default matches earth's gravity (m/s^2)
 		glm::vec3 _gravity;
 
+		// Physics is stepped in fixed increments, with the leftover time carried over to the next frame
+		float     _fixedTimeStep;
+		int       _maxPhysicsSubSteps;
+		float     _physicsAccumulator;
+		float     _physicsInterpolation;
+		// Counts the physics steps we've taken, so that bodies can tell if they moved in the most recent one
+		uint32_t  _physicsStepCount;
+		// Dynamic bodies that bullet has moved recently, which still need their transforms copied back to their
+		// gameobjects. This lets us skip sleeping bodies entirely after each step
+		std::vector<Physics::RigidBody*> _movingBodies;
+		// Physics bodies that have changed since the last frame (moved, new colliders, etc...), only these need
+		// to be pre-stepped so the cost follows the number of changes rather than the number of bodies
+		std::vector<Physics::PhysicsBase*> _dirtyPhysics;
+
 		// Stores all the objects in our scene
 		std::vector<GameObject::Sptr>  _objects;
 		std::vector<std::weak_ptr<GameObject>>  _deletionQueue;
+		// Maps object GUIDs to objects, kept in sync with _objects so lookups don't need to search
+		std::unordered_map<Guid, GameObject::Sptr> _objectsByGuid;
+
+		// Slot table used to resolve GameObject::WeakRef handles. Each slot stores a live object and a
+		// generation counter that is bumped when the object is removed, invalidating all handles to it
+		struct ObjectSlot {
+			GameObject* Object;
+			uint32_t    Generation;
+		};
+		std::vector<ObjectSlot> _objectSlots;
+		std::vector<uint32_t>   _freeObjectSlots;
+
+		// Unique ID for this scene, weak references store this instead of a scene pointer so that they
+		// expire cleanly when the scene they were made in is destroyed (ex: when switching scenes)
+		uint32_t                _sceneId;
+		static std::atomic<uint32_t>                  _nextSceneId;
+		static std::shared_mutex                      _liveScenesLock;
+		static std::unordered_map<uint32_t, Scene*>   _liveScenes;
+
+		// Stores the transform matrices for all our objects, indexed by their slots
+		TransformHierarchy      _transforms;
 
 		// Info for rendering our skybox will be stored in the scene itself
 		std::shared_ptr<ShaderProgram>       _skyboxShader;
@@ -231,16 +401,75 @@ namespace Gameplay {
 		Texture3D::Sptr               _colorCorrection;
 
 		bool                       _isAwake;
+		// How long the last update took, in milliseconds
+		float                      _lastUpdateTime;
+		// How long the last physics step took, in milliseconds
+		float                      _lastPhysicsTime;
 
 		/// <summary>
 		/// Handles configuring our bullet physics stuff
 		/// </summary>
 		void _InitPhysics();
 		/// <summary>
+		/// Gets a handle to the gameobject that owns a bullet collision object
+		/// </summary>
+		GameObject::WeakRef _GetObjectRef(const btCollisionObject* object) const;
+		/// <summary>
 		/// Handles cleaning up bullet physics for this scene
 		/// </summary>
 		void _CleanupPhysics();
 
 		void _FlushDeleteQueue();
+
+		/// <summary>
+		/// Updates all components with thread safe updates, spreading each batch of component types
+		/// returned by ComponentManager::GetParallelUpdateBatches across the job system
+		/// </summary>
+		/// <param name="dt">The time since the last frame, in seconds</param>
+		void _UpdateParallelComponents(float dt);
+
+		/// <summary>
+		/// Adds an object to the scene's object list, GUID index and slot table, and adds any components
+		/// it already has to the component pools
+		/// </summary>
+		/// <param name="object">The object to add, should already have it's GUID set</param>
+		void _RegisterObject(const GameObject::Sptr& object);
+		/// <summary>
+		/// The link phase of loading, registers objects that were constructed on worker threads with the
+		/// scene in order, then resolves their parents through the GUID index
+		/// </summary>
+		/// <param name="objects">The objects that were loaded, in scene order</param>
+		/// <param name="parents">The GUID of each object's parent, or an invalid GUID for root objects</param>
+		void _LinkLoadedObjects(const std::vector<GameObject::Sptr>& objects, const std::vector<Guid>& parents);
+		/// <summary>
+		/// The upload phase of loading, invokes OnLoad for all components of the loaded objects. This
+		/// must happen on the main thread, since components may create OpenGL resources here
+		/// </summary>
+		/// <param name="objects">The objects that were loaded, in scene order</param>
+		void _UploadLoadedObjects(const std::vector<GameObject::Sptr>& objects);
+		/// <summary>
+		/// Writes this scene in the binary scene format to memory, used by both SaveBinary and SaveAsync
+		/// </summary>
+		/// <returns>The contents of the binary scene file</returns>
+		std::string _ToBinary() const;
+		/// <summary>
+		/// Releases the slot for an object, invalidating all weak references to it
+		/// </summary>
+		/// <param name="object">The object to release</param>
+		void _ReleaseSlot(GameObject* object);
+		/// <summary>
+		/// Gets the object in the given slot, or nullptr if the generation does not match (the object was removed)
+		/// </summary>
+		/// <param name="index">The index of the slot</param>
+		/// <param name="generation">The generation the reference was created with</param>
+		GameObject* _ResolveSlot(uint32_t index, uint32_t generation) const;
+		/// <summary>
+		/// Resolves a weak reference handle into the object it points to, or nullptr if the scene
+		/// has been destroyed or the object has been removed
+		/// </summary>
+		/// <param name="sceneId">The ID of the scene the reference was created in</param>
+		/// <param name="index">The index of the slot</param>
+		/// <param name="generation">The generation the reference was created with</param>
+		static GameObject* _ResolveHandle(uint32_t sceneId, uint32_t index, uint32_t generation);
 	};
 }
\ No newline at end of file
@@ -0,0 +1,243 @@
+#include "Gameplay/TransformHierarchy.h"
+#include <algorithm>
+
+#if defined(_M_X64) || defined(__SSE2__)
+#include <xmmintrin.h>
+#define TRANSFORM_HIERARCHY_SSE
+#endif
+
+#include "GLM/gtc/quaternion.hpp"
+#include "GLM/gtc/matrix_inverse.hpp"
+
+#include "Gameplay/GameObject.h"
+
+namespace Gameplay {
+	/// <summary>
+	/// Multiplies 2 matrices (result = a * b). Each column of the result is a linear combination of the columns
+	/// of a, so with SSE we can do a whole column at a time. Result must not alias either input
+	/// </summary>
+	inline void MultiplyMat4(const glm::mat4& a, const glm::mat4& b, glm::mat4& result) {
+	#ifdef TRANSFORM_HIERARCHY_SSE
+		const __m128 a0 = _mm_loadu_ps(&a[0][0]);
+		const __m128 a1 = _mm_loadu_ps(&a[1][0]);
+		const __m128 a2 = _mm_loadu_ps(&a[2][0]);
+		const __m128 a3 = _mm_loadu_ps(&a[3][0]);
+		for (int col = 0; col < 4; col++) {
+			__m128 r = _mm_mul_ps(a0, _mm_set1_ps(b[col][0]));
+			r = _mm_add_ps(r, _mm_mul_ps(a1, _mm_set1_ps(b[col][1])));
+			r = _mm_add_ps(r, _mm_mul_ps(a2, _mm_set1_ps(b[col][2])));
+			r = _mm_add_ps(r, _mm_mul_ps(a3, _mm_set1_ps(b[col][3])));
+			_mm_storeu_ps(&result[col][0], r);
+		}
+	#else
+		result = a * b;
+	#endif
+	}
+
+	const glm::mat4 TransformHierarchy::Detached = glm::mat4(1.0f);
+
+	TransformHierarchy::TransformHierarchy() :
+		_chunks(std::vector<std::unique_ptr<Chunk>>()),
+		_order(std::vector<uint32_t>()),
+		_isOrderDirty(false),
+		_firstChild(std::vector<uint32_t>()),
+		_nextSibling(std::vector<uint32_t>())
+	{ }
+
+	void TransformHierarchy::Add(GameObject* object, uint32_t slot) {
+		// Make sure we have enough chunks to store the slot
+		while (slot >= _chunks.size() * ChunkSize) {
+			std::unique_ptr<Chunk> chunk = std::make_unique<Chunk>();
+			std::fill(std::begin(chunk->Owner), std::end(chunk->Owner), nullptr);
+			_chunks.push_back(std::move(chunk));
+		}
+
+		Chunk& chunk = _GetChunk(slot);
+		uint32_t ix = slot % ChunkSize;
+		chunk.Local[ix] = glm::mat4(1.0f);
+		chunk.InverseLocal[ix] = glm::mat4(1.0f);
+		chunk.World[ix] = glm::mat4(1.0f);
+		chunk.InverseWorld[ix] = glm::mat4(1.0f);
+		chunk.Parent[ix] = NoParent;
+		chunk.Version[ix] = 0;
+		chunk.ParentVersion[ix] = 0;
+		chunk.Flags[ix] = FlagWorldDirty;
+		chunk.Owner[ix] = object;
+
+		// New objects start with their local transform dirty so that it gets calculated on first use
+		object->_isLocalTransformDirty = true;
+		_isOrderDirty = true;
+	}
+
+	void TransformHierarchy::Remove(uint32_t slot) {
+		if (slot >= _chunks.size() * ChunkSize) return;
+
+		Chunk& chunk = _GetChunk(slot);
+		uint32_t ix = slot % ChunkSize;
+		chunk.Local[ix] = glm::mat4(1.0f);
+		chunk.InverseLocal[ix] = glm::mat4(1.0f);
+		chunk.World[ix] = glm::mat4(1.0f);
+		chunk.InverseWorld[ix] = glm::mat4(1.0f);
+		chunk.Parent[ix] = NoParent;
+		// Bump the version so that anything still parented to this slot gets recalculated
+		chunk.Version[ix]++;
+		chunk.ParentVersion[ix] = 0;
+		chunk.Flags[ix] = 0;
+		chunk.Owner[ix] = nullptr;
+		_isOrderDirty = true;
+	}
+
+	void TransformHierarchy::SetParent(const GameObject* owner, uint32_t slot, uint32_t parentSlot) {
+		if (!IsOwner(owner, slot)) return;
+
+		Chunk& chunk = _GetChunk(slot);
+		uint32_t ix = slot % ChunkSize;
+		chunk.Parent[ix] = parentSlot;
+		// The parent's version means nothing to us anymore, so force a recalculation
+		chunk.Flags[ix] |= FlagWorldDirty;
+		_isOrderDirty = true;
+	}
+
+	void TransformHierarchy::Clear() {
+		_chunks.clear();
+		_order.clear();
+		_firstChild.clear();
+		_nextSibling.clear();
+		_isOrderDirty = false;
+	}
+
+	bool TransformHierarchy::IsOwner(const GameObject* owner, uint32_t slot) const {
+		return owner != nullptr && slot < _chunks.size() * ChunkSize && _GetChunk(slot).Owner[slot % ChunkSize] == owner;
+	}
+
+	const glm::mat4& TransformHierarchy::GetLocal(const GameObject* owner, uint32_t slot) {
+		if (!IsOwner(owner, slot)) return Detached;
+		_UpdateLocal(slot);
+		return _GetChunk(slot).Local[slot % ChunkSize];
+	}
+
+	const glm::mat4& TransformHierarchy::GetInverseLocal(const GameObject* owner, uint32_t slot) {
+		if (!IsOwner(owner, slot)) return Detached;
+		_UpdateLocal(slot);
+		return _GetChunk(slot).InverseLocal[slot % ChunkSize];
+	}
+
+	const glm::mat4& TransformHierarchy::GetWorld(const GameObject* owner, uint32_t slot) {
+		if (!IsOwner(owner, slot)) return Detached;
+		_UpdateWorldRecursive(slot);
+		return _GetChunk(slot).World[slot % ChunkSize];
+	}
+
+	const glm::mat4& TransformHierarchy::GetInverseWorld(const GameObject* owner, uint32_t slot) {
+		if (!IsOwner(owner, slot)) return Detached;
+		_UpdateWorldRecursive(slot);
+		return _GetChunk(slot).InverseWorld[slot % ChunkSize];
+	}
+
+	void TransformHierarchy::Update() {
+		if (_isOrderDirty) {
+			_RebuildOrder();
+		}
+
+		// Since parents always come before their children, each object's parent is already up to date
+		for (uint32_t slot : _order) {
+			_UpdateWorld(slot);
+		}
+	}
+
+	void TransformHierarchy::_UpdateLocal(uint32_t slot) {
+		Chunk& chunk = _GetChunk(slot);
+		uint32_t ix = slot % ChunkSize;
+		GameObject* owner = chunk.Owner[ix];
+
+		if (owner != nullptr && owner->_isLocalTransformDirty) {
+			// Equivalent to translate * rotate * scale, without the extra matrix multiplies
+			glm::mat4& local = chunk.Local[ix];
+			local = glm::mat4_cast(owner->_rotation);
+			local[0] *= owner->_scale.x;
+			local[1] *= owner->_scale.y;
+			local[2] *= owner->_scale.z;
+			local[3] = glm::vec4(owner->_position, 1.0f);
+			chunk.InverseLocal[ix] = glm::affineInverse(local);
+
+			owner->_isLocalTransformDirty = false;
+			chunk.Flags[ix] |= FlagWorldDirty;
+		}
+	}
+
+	void TransformHierarchy::_UpdateWorld(uint32_t slot) {
+		_UpdateLocal(slot);
+
+		Chunk& chunk = _GetChunk(slot);
+		uint32_t ix = slot % ChunkSize;
+		uint32_t parent = chunk.Parent[ix];
+		// Treat objects whose parent has been removed as roots, same as _RebuildOrder
+		if (parent != NoParent && _GetChunk(parent).Owner[parent % ChunkSize] == nullptr) {
+			parent = NoParent;
+		}
+
+		if (parent != NoParent) {
+			Chunk& parentChunk = _GetChunk(parent);
+			uint32_t parentIx = parent % ChunkSize;
+
+			// We need to recalculate if our local transform changed, or our parent's world transform has changed
+			// since we last calculated (this is what lets changes reach grandchildren and beyond)
+			if ((chunk.Flags[ix] & FlagWorldDirty) || chunk.ParentVersion[ix] != parentChunk.Version[parentIx]) {
+				MultiplyMat4(parentChunk.World[parentIx], chunk.Local[ix], chunk.World[ix]);
+				// The inverse of a product is the product of the inverses in reverse, which saves us an inverse
+				MultiplyMat4(chunk.InverseLocal[ix], parentChunk.InverseWorld[parentIx], chunk.InverseWorld[ix]);
+				chunk.ParentVersion[ix] = parentChunk.Version[parentIx];
+				chunk.Version[ix]++;
+				chunk.Flags[ix] &= ~FlagWorldDirty;
+			}
+		}
+		// If our parent is null, we can simply use the local transform as the world transform
+		else if (chunk.Flags[ix] & FlagWorldDirty) {
+			chunk.World[ix] = chunk.Local[ix];
+			chunk.InverseWorld[ix] = chunk.InverseLocal[ix];
+			chunk.Version[ix]++;
+			chunk.Flags[ix] &= ~FlagWorldDirty;
+		}
+	}
+
+	void TransformHierarchy::_UpdateWorldRecursive(uint32_t slot) {
+		uint32_t parent = _GetChunk(slot).Parent[slot % ChunkSize];
+		if (parent != NoParent) {
+			_UpdateWorldRecursive(parent);
+		}
+		_UpdateWorld(slot);
+	}
+
+	void TransformHierarchy::_RebuildOrder() {
+		uint32_t capacity = static_cast<uint32_t>(_chunks.size()) * ChunkSize;
+
+		// Build a linked list of children for each slot so we can walk the hierarchy breadth-first
+		_firstChild.assign(capacity, NoParent);
+		_nextSibling.assign(capacity, NoParent);
+
+		_order.clear();
+		for (uint32_t slot = capacity; slot-- > 0;) {
+			Chunk& chunk = _GetChunk(slot);
+			uint32_t ix = slot % ChunkSize;
+			if (chunk.Owner[ix] == nullptr) continue;
+
+			uint32_t parent = chunk.Parent[ix];
+			if (parent != NoParent && _GetChunk(parent).Owner[parent % ChunkSize] != nullptr) {
+				_nextSibling[slot] = _firstChild[parent];
+				_firstChild[parent] = slot;
+			} else {
+				_order.push_back(slot);
+			}
+		}
+
+		// The roots were collected in reverse, flip them so we keep scene order, then append each level in turn
+		std::reverse(_order.begin(), _order.end());
+		for (size_t head = 0; head < _order.size(); head++) {
+			for (uint32_t child = _firstChild[_order[head]]; child != NoParent; child = _nextSibling[child]) {
+				_order.push_back(child);
+			}
+		}
+
+		_isOrderDirty = false;
+	}
+}
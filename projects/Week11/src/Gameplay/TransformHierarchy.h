@@ -0,0 +1,141 @@
+#pragma once
+#include <vector>
+#include <memory>
+#include <cstdint>
+
+#include "GLM/glm.hpp"
+#include "Utils/Macros.h"
+
+namespace Gameplay {
+	class GameObject;
+
+	/// <summary>
+	/// Stores the transformation matrices for all the objects in a scene in structure-of-arrays form, indexed
+	/// by the object's slot in the scene. Storage is split into fixed size chunks so that references to matrices
+	/// stay valid as objects are added.
+	///
+	/// Objects are updated in breadth-first order (parents always come before their children), so a single pass
+	/// per frame brings every dirty subtree up to date. Each object also tracks the version of it's parent's world
+	/// transform that it was last computed from, so changes propagate correctly to any depth, and lazy queries
+	/// between updates always see up to date results. Note that only the update order is sorted, the matrices
+	/// themselves stay where the object's slot puts them
+	///
+	/// Slots are re-used by the scene, so all queries take the object that is asking. An object that has been
+	/// removed from the scene no longer owns it's slot, and will get an identity matrix instead of the
+	/// transform of whatever object has taken the slot since
+	/// </summary>
+	class TransformHierarchy {
+	public:
+		NO_COPY(TransformHierarchy);
+		NO_MOVE(TransformHierarchy);
+
+		// Used as the parent slot for objects that do not have a parent
+		static constexpr uint32_t NoParent = ~0u;
+
+		TransformHierarchy();
+		~TransformHierarchy() = default;
+
+		/// <summary>
+		/// Adds an object to the hierarchy as a root, should be called when the object is given it's slot
+		/// </summary>
+		/// <param name="object">The object that owns the slot</param>
+		/// <param name="slot">The object's slot in the scene</param>
+		void Add(GameObject* object, uint32_t slot);
+		/// <summary>
+		/// Removes the object in the given slot from the hierarchy, resetting the slot so that no stale
+		/// transforms are left behind for the next object to use it
+		/// </summary>
+		/// <param name="slot">The slot to remove</param>
+		void Remove(uint32_t slot);
+		/// <summary>
+		/// Sets the parent of the object in the given slot, ignored if the object no longer owns the slot
+		/// </summary>
+		/// <param name="owner">The object being re-parented</param>
+		/// <param name="slot">The slot of the object to re-parent</param>
+		/// <param name="parentSlot">The slot of the new parent, or NoParent</param>
+		void SetParent(const GameObject* owner, uint32_t slot, uint32_t parentSlot);
+		/// <summary>
+		/// Removes all objects from the hierarchy
+		/// </summary>
+		void Clear();
+
+		/// <summary>
+		/// Returns true if the given object currently owns the slot
+		/// </summary>
+		bool IsOwner(const GameObject* owner, uint32_t slot) const;
+
+		/// <summary>
+		/// Gets the local transform for the given slot, recalculating it if needed
+		/// </summary>
+		const glm::mat4& GetLocal(const GameObject* owner, uint32_t slot);
+		/// <summary>
+		/// Gets the inverse local transform for the given slot, recalculating it if needed
+		/// </summary>
+		const glm::mat4& GetInverseLocal(const GameObject* owner, uint32_t slot);
+		/// <summary>
+		/// Gets the world transform for the given slot, recalculating it and it's parents if needed
+		/// </summary>
+		const glm::mat4& GetWorld(const GameObject* owner, uint32_t slot);
+		/// <summary>
+		/// Gets the inverse world transform for the given slot, recalculating it and it's parents if needed
+		/// </summary>
+		const glm::mat4& GetInverseWorld(const GameObject* owner, uint32_t slot);
+
+		/// <summary>
+		/// Brings all world transforms up to date in a single breadth-first pass, should be called once per frame
+		/// </summary>
+		void Update();
+
+	private:
+		// Number of slots stored in each chunk
+		static constexpr uint32_t ChunkSize = 256;
+
+		// Set when an object's world transform needs recalculating even if it's parent has not changed
+		static constexpr uint8_t FlagWorldDirty = 1 << 0;
+
+		struct Chunk {
+			glm::mat4   Local[ChunkSize];
+			glm::mat4   InverseLocal[ChunkSize];
+			glm::mat4   World[ChunkSize];
+			glm::mat4   InverseWorld[ChunkSize];
+			uint32_t    Parent[ChunkSize];
+			// Incremented whenever the world transform changes
+			uint32_t    Version[ChunkSize];
+			// The version of the parent's world transform that our world transform was calculated from
+			uint32_t    ParentVersion[ChunkSize];
+			uint8_t     Flags[ChunkSize];
+			GameObject* Owner[ChunkSize];
+		};
+
+		std::vector<std::unique_ptr<Chunk>> _chunks;
+
+		// Slots sorted so that parents come before their children, rebuilt when the hierarchy changes
+		std::vector<uint32_t> _order;
+		bool                  _isOrderDirty;
+		// Scratch child lists used by _RebuildOrder, kept around so we don't allocate on every rebuild
+		std::vector<uint32_t> _firstChild;
+		std::vector<uint32_t> _nextSibling;
+
+		// Returned for objects that no longer own a slot
+		static const glm::mat4 Detached;
+
+		Chunk& _GetChunk(uint32_t slot) const { return *_chunks[slot / ChunkSize]; }
+
+		/// <summary>
+		/// Recalculates the local transform for a slot if the owner's position, rotation or scale has changed
+		/// </summary>
+		void _UpdateLocal(uint32_t slot);
+		/// <summary>
+		/// Recalculates the world transform for a slot if needed, assuming that the parent is already up to date
+		/// </summary>
+		void _UpdateWorld(uint32_t slot);
+		/// <summary>
+		/// Brings the parents of a slot up to date, then the slot itself
+		/// </summary>
+		void _UpdateWorldRecursive(uint32_t slot);
+		/// <summary>
+		/// Rebuilds the breadth-first update order from the parent links
+		/// </summary>
+		void _RebuildOrder();
+	};
+}
@@ -185,6 +185,43 @@ constexpr GLint GetTexelComponentCount(PixelFormat format) {
 	}
 }
 
+/*
+ * Gets the number of bytes used by a single texel of the given internal format on the GPU. This is
+ * an estimate, since drivers are free to pad formats (ex: RGB8 is often stored as RGBA8)
+ * @param format The internal format of the texture
+ * @returns The size of a single texel in bytes, or 0 if the format is unknown
+ */
+constexpr size_t GetInternalFormatSize(InternalFormat format) {
+	switch (format) {
+		case InternalFormat::R8:
+			return 1;
+		case InternalFormat::Depth16:
+		case InternalFormat::R16:
+		case InternalFormat::RG8:
+			return 2;
+		case InternalFormat::RGB8:
+		case InternalFormat::SRGB:
+		case InternalFormat::Depth24:
+			return 3;
+		case InternalFormat::Depth32:
+		case InternalFormat::DepthStencil:
+		case InternalFormat::RGB10:
+		case InternalFormat::RGBA8:
+		case InternalFormat::SRGBA:
+			return 4;
+		case InternalFormat::RGB16:
+			return 6;
+		case InternalFormat::RGBA16:
+			return 8;
+		case InternalFormat::RGB32F:
+			return 12;
+		case InternalFormat::RGB32AF:
+			return 16;
+		default:
+			return 0;
+	}
+}
+
 /*
  * Gets the number of bytes needed to represent a single texel of the given format and type
  * @param format The format of the texel
@@ -1,6 +1,7 @@
 #include "Texture1D.h"
-#include "Utils/Base64.h"
+#include "Utils/ResourceManager/ResourceManager.h"
 #include "Utils/JsonGlmHelpers.h"
+#include "Utils/VirtualFileSystem.h"
 #include <stb_image.h>
 
 inline int CalcRequiredMipLevels(int size) {
@@ -78,14 +79,15 @@ nlohmann::json Texture1D::ToJson() const
 	}
 	else if (_pixelType != PixelType::Unknown) {
 		result["size"] = _description.Size;
+		result["internal_format"] = ~_description.Format;
 		result["format"] = ~_description.FormatHint;
 		result["pixel_type"] = ~_pixelType;
 
 		if (_description.Size > 0 && _description.FormatHint != PixelFormat::Unknown) {
 			size_t dataSize = GetTexelSize(_description.FormatHint, _pixelType) * _description.Size;
-			uint8_t* dataStore = new uint8_t[dataSize];
-			glGetTextureImage(_rendererId, 0, *_description.Format, *_pixelType, dataSize, dataStore);
-			result["data"] = Base64::Encode(dataStore, dataSize);
+			std::vector<uint8_t> dataStore(dataSize);
+			glGetTextureImage(_rendererId, 0, *_description.FormatHint, *_pixelType, dataSize, dataStore.data());
+			result["data"] = ResourceManager::WriteBlob(dataStore.data(), dataSize);
 		}
 	}
 	return result;
@@ -100,18 +102,19 @@ Texture1D::Sptr Texture1D::FromJson(const nlohmann::json& data)
 	description.MinificationFilter = JsonParseEnum(MinFilter, data, "filter_min", MinFilter::NearestMipNearest);
 	description.MagnificationFilter = JsonParseEnum(MagFilter, data, "filter_mag", MagFilter::Linear);
 	description.GenerateMipMaps = JsonGet(data, "generate_mipmaps", false);
+	description.Format = JsonParseEnum(InternalFormat, data, "internal_format", description.Format);
 	description.FormatHint = JsonParseEnum(PixelFormat, data, "format", PixelFormat::Unknown);
 
 	Texture1D::Sptr result = std::make_shared<Texture1D>(description);
 
-	// If we embedded data into the JSON, load it now
-	if (description.Filename.empty() && data.contains("data") && data["data"].is_string()) {
+	// If we stored the texture's data, load it now (straight from the manifest's blob file if it's not compressed)
+	if (description.Filename.empty() && data.contains("data")) {
 		PixelType type = JsonParseEnum(PixelType, data, "pixel_type", PixelType::Unknown);
-		try {
-			std::string rawData = Base64::Decode(data['data'].get<std::string>());
-			result->LoadData(description.Size, description.FormatHint, type, rawData.data());
-		}
-		catch (std::runtime_error()) {
+		std::string storage;
+		std::string_view texels = ResourceManager::ReadBlob(data["data"], storage);
+		if (type != PixelType::Unknown && texels.size() == GetTexelSize(description.FormatHint, type) * description.Size) {
+			result->LoadData(description.Size, description.FormatHint, type, const_cast<char*>(texels.data()));
+		} else {
 			LOG_WARN("JSON blob had data, but failed to load to texture");
 		}
 	}
@@ -128,9 +131,12 @@ void Texture1D::_LoadDataFromFile()
 		int width, height, numChannels;
 		const int targetChannels = GetTexelComponentCount(_description.FormatHint);
 
-		// Use STBI to load the image
+		// Use STBI to load the image, straight from the asset archive if it's packed
 		stbi_set_flip_vertically_on_load(true);
-		uint8_t* data = stbi_load(_description.Filename.c_str(), &width, &height, &numChannels, targetChannels);
+		std::string_view packed = VirtualFileSystem::GetView(_description.Filename);
+		uint8_t* data = packed.data() != nullptr ?
+			stbi_load_from_memory(reinterpret_cast<const stbi_uc*>(packed.data()), static_cast<int>(packed.size()), &width, &height, &numChannels, targetChannels) :
+			stbi_load(_description.Filename.c_str(), &width, &height, &numChannels, targetChannels);
 
 		// If we could not load any data, warn and return null
 		if (data == nullptr) {
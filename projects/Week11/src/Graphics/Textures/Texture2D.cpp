@@ -3,7 +3,8 @@
 #include <Logging.h>
 #include "GLM/glm.hpp"
 #include "Utils/JsonGlmHelpers.h"
-#include "Utils/Base64.h"
+#include "Utils/ResourceManager/ResourceManager.h"
+#include "Utils/VirtualFileSystem.h"
 
 /// <summary>
 /// Get the number of mipmap levels required for a texture of the given size
@@ -30,42 +31,74 @@ nlohmann::json Texture2D::ToJson() const {
 	}
 	else if (_pixelType != PixelType::Unknown) {
 		result["size_x"] = _description.Width;
-		result["size_y"] = _description.Width;
+		result["size_y"] = _description.Height;
 
+		result["internal_format"] = ~_description.Format;
 		result["format"] = ~_description.FormatHint;
 		result["pixel_type"] = ~_pixelType;
 		if (_description.Width * _description.Height > 0 && _description.FormatHint != PixelFormat::Unknown) {
 			size_t dataSize = GetTexelSize(_description.FormatHint, _pixelType) * _description.Width * _description.Height;
-			uint8_t* dataStore = new uint8_t[dataSize];
-			glGetTextureImage(_rendererId, 0, *_description.FormatHint, *_pixelType, dataSize, dataStore);
-			result["data"] = Base64::Encode(dataStore, dataSize);
+			std::vector<uint8_t> dataStore(dataSize);
+			glGetTextureImage(_rendererId, 0, *_description.FormatHint, *_pixelType, dataSize, dataStore.data());
+			result["data"] = ResourceManager::WriteBlob(dataStore.data(), dataSize);
 		}
 	}
 
 	return result;
 }
 
-Texture2D::Sptr Texture2D::FromJson(const nlohmann::json& data)
+Texture2DDescription Texture2D::_ParseDescription(const nlohmann::json& data)
 {
 	Texture2DDescription descr = Texture2DDescription();
-	descr.Filename = data["filename"];
+	descr.Filename = JsonGet<std::string>(data, "filename", "");
+	descr.Width    = JsonGet(data, "size_x", descr.Width);
+	descr.Height   = JsonGet(data, "size_y", descr.Height);
+	descr.Format     = JsonParseEnum(InternalFormat, data, "internal_format", descr.Format);
+	descr.FormatHint = JsonParseEnum(PixelFormat, data, "format", descr.FormatHint);
 	descr.HorizontalWrap = JsonParseEnum(WrapMode, data, "wrap_s", WrapMode::ClampToEdge);
 	descr.VerticalWrap   = JsonParseEnum(WrapMode, data, "wrap_t", WrapMode::ClampToEdge);
 	descr.MinificationFilter  = JsonParseEnum(MinFilter, data, "filter_min", MinFilter::NearestMipNearest);
 	descr.MagnificationFilter = JsonParseEnum(MagFilter, data, "filter_mag", MagFilter::Linear);
 	descr.MaxAnisotropic      = JsonGet(data, "anisotropic", 0.0f);
 	descr.GenerateMipMaps     = JsonGet(data, "generate_mipmaps", false);
+	return descr;
+}
+
+IResource::FinalizeFunc Texture2D::DecodeFromJson(const nlohmann::json& data)
+{
+	Texture2DDescription descr = _ParseDescription(data);
+
+	// Only textures loaded from files have any work that we can do off of the main thread
+	if (descr.Filename.empty()) {
+		return [data]() -> IResource::Sptr { return FromJson(data); };
+	}
+
+	std::shared_ptr<DecodedImage> image = std::make_shared<DecodedImage>(_DecodeImage(descr.Filename, descr.FormatHint));
+	return [descr, image]() -> IResource::Sptr {
+		// We clear the filename so the constructor doesn't load the file again, then upload what we decoded
+		Texture2DDescription textureDescr = descr;
+		textureDescr.Filename = "";
+		Texture2D::Sptr result = std::make_shared<Texture2D>(textureDescr);
+		result->_description.Filename = descr.Filename;
+		result->_UploadImage(*image);
+		return result;
+	};
+}
+
+Texture2D::Sptr Texture2D::FromJson(const nlohmann::json& data)
+{
+	Texture2DDescription descr = _ParseDescription(data);
 
 	Texture2D::Sptr result = std::make_shared<Texture2D>(descr);
 
-	// If we embedded data into the JSON, load it now
-	if (descr.Filename.empty() && data.contains("data") && data["data"].is_string()) {
+	// If we stored the texture's data, load it now (straight from the manifest's blob file if it's not compressed)
+	if (descr.Filename.empty() && data.contains("data")) {
 		PixelType type = JsonParseEnum(PixelType, data, "pixel_type", PixelType::Unknown);
-		try {
-			std::string rawData = Base64::Decode(data['data'].get<std::string>());
-			result->LoadData(descr.Width, descr.Height, descr.FormatHint, type, rawData.data());
-		}
-		catch (std::runtime_error()) {
+		std::string storage;
+		std::string_view texels = ResourceManager::ReadBlob(data["data"], storage);
+		if (type != PixelType::Unknown && texels.size() == GetTexelSize(descr.FormatHint, type) * descr.Width * descr.Height) {
+			result->LoadData(descr.Width, descr.Height, descr.FormatHint, type, const_cast<char*>(texels.data()));
+		} else {
 			LOG_WARN("JSON blob had data, but failed to load to texture");
 		}
 	}
@@ -147,55 +180,65 @@ void Texture2D::LoadData(uint32_t width, uint32_t height, PixelFormat format, Pi
 }
 
 void Texture2D::_LoadDataFromFile() {
-	LOG_ASSERT(_description.Width + _description.Height == 0, "This texture has already been configured with a size! Cannot re-allocate memory!");
-
 	if (!_description.Filename.empty()) {
-		// Variables that will store properties about our image
-		int width, height, numChannels;
-		const int targetChannels = GetTexelComponentCount(_description.FormatHint);
-
-		// Use STBI to load the image
-		stbi_set_flip_vertically_on_load(true);
-		uint8_t* data = stbi_load(_description.Filename.c_str(), &width, &height, &numChannels, targetChannels);
-
-		// If we could not load any data, warn and return null
-		if (data == nullptr) {
-			LOG_WARN("STBI Failed to load image from \"{}\"", _description.Filename);
-			return ;
-		}
+		_UploadImage(_DecodeImage(_description.Filename, _description.FormatHint));
+	}
+}
 
-		// We should estimate a good format for our data
+Texture2D::DecodedImage Texture2D::_DecodeImage(const std::string& filename, PixelFormat formatHint) {
+	DecodedImage result;
+	const int targetChannels = GetTexelComponentCount(formatHint);
+
+	// Use STBI to load the image. The flip flag is global in this version of STBI, but every loader sets it
+	// to true, so it's safe for us to be decoding on multiple threads at once. Packed images are decoded straight
+	// from the archive's memory
+	stbi_set_flip_vertically_on_load(true);
+	std::string_view packed = VirtualFileSystem::GetView(filename);
+	uint8_t* data = packed.data() != nullptr ?
+		stbi_load_from_memory(reinterpret_cast<const stbi_uc*>(packed.data()), static_cast<int>(packed.size()), &result.Width, &result.Height, &result.NumChannels, targetChannels) :
+		stbi_load(filename.c_str(), &result.Width, &result.Height, &result.NumChannels, targetChannels);
+
+	// If we could not load any data, warn and return an empty image
+	if (data == nullptr) {
+		LOG_WARN("STBI Failed to load image from \"{}\"", filename);
+		return result;
+	}
+	result.Pixels = std::shared_ptr<uint8_t>(data, stbi_image_free);
+
+	// numChannels will store the number of channels in the image on disk, if we overrode that we should use the override value
+	if (targetChannels != 0)
+		result.NumChannels = targetChannels;
+
+	return result;
+}
 
-		// numChannels will store the number of channels in the image on disk, if we overrode that we should use the override value
-		if (targetChannels != 0)
-			numChannels = targetChannels;
+void Texture2D::_UploadImage(const DecodedImage& image) {
+	LOG_ASSERT(_description.Width + _description.Height == 0, "This texture has already been configured with a size! Cannot re-allocate memory!");
 
+	if (image.Pixels != nullptr) {
 		// We'll determine a recommended format for the image based on number of channels
 		// We hinted that we wanted a certain number of channels, but we're not guaranteed
 		// that all those channels exist (ex: loading an RGB image but requesting RGBA)
-		InternalFormat internal_format = GetInternalFormatForChannels8(numChannels);
-		PixelFormat    image_format = GetPixelFormatForChannels(numChannels);
+		InternalFormat internal_format = GetInternalFormatForChannels8(image.NumChannels);
+		PixelFormat    image_format = GetPixelFormatForChannels(image.NumChannels);
 
 		// This is one of those poorly documented things in OpenGL
-		if ((numChannels * width) % 4 != 0) {
+		if ((image.NumChannels * image.Width) % 4 != 0) {
 			LOG_WARN("The alignment of a horizontal line is not a multiple of 4, this will require a call to glPixelStorei(GL_PACK_ALIGNMENT)");
 		}
 
 		// Update our description to match what we loaded
 		_description.Format = internal_format;
-		_description.Width = width;
-		_description.Height = height;
+		_description.Width = image.Width;
+		_description.Height = image.Height;
 
 		// Allocates our memory
 		_SetTextureParams();
 
 		// Upload data to our texture
-		LoadData(width, height, image_format, PixelType::UByte, data);
-
-		// We now have data in the image, we can clear the STBI data
-		stbi_image_free(data);
+		LoadData(image.Width, image.Height, image_format, PixelType::UByte, image.Pixels.get());
 	}
-	
+
 	SetDebugName(_description.Filename);
 }
 
@@ -253,4 +296,10 @@ Texture2D::Sptr Texture2D::LoadFromFile(const std::string& path, const Texture2D
 	Texture2D::Sptr result = std::make_shared<Texture2D>(desc);
 
 	return result;
-}
\ No newline at end of file
+}
+
+size_t Texture2D::GetGpuMemoryUsage() const {
+	size_t result = GetInternalFormatSize(_description.Format) * _description.Width * _description.Height * _description.MultisampleCount;
+	// A full mip chain adds another third on top of the base level
+	return _description.GenerateMipMaps ? result + result / 3 : result;
+}
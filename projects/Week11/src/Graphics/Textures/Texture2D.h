@@ -145,12 +145,26 @@ public:
 	const Texture2DDescription& GetDescription() const { return _description; }
 
 	virtual nlohmann::json ToJson() const override;
+	virtual size_t GetGpuMemoryUsage() const override;
 	static Texture2D::Sptr FromJson(const nlohmann::json& data);
+	/// <summary>
+	/// Decodes the texture's image file on the calling thread, and returns a function that creates the
+	/// texture from the decoded image (which must be called on the main thread)
+	/// </summary>
+	static IResource::FinalizeFunc DecodeFromJson(const nlohmann::json& data);
 
 protected:
 	Texture2DDescription _description;
 	PixelType _pixelType;
 
+	// An image that has been decoded on the CPU, but not uploaded to the GPU yet
+	struct DecodedImage {
+		std::shared_ptr<uint8_t> Pixels = nullptr;
+		int Width = 0;
+		int Height = 0;
+		int NumChannels = 0;
+	};
+
 	/// <summary>
 	/// Loads this texture from the file specified in the description
 	/// Will overwrite description size
@@ -160,6 +174,17 @@ protected:
 	/// Allocates our texture's memory and sets sampling / filtering parameters
 	/// </summary>
 	void _SetTextureParams();
+	/// <summary>
+	/// Allocates our texture's memory and uploads an image that has been decoded by _DecodeImage
+	/// Will overwrite description size
+	/// </summary>
+	void _UploadImage(const DecodedImage& image);
+
+	/// <summary>
+	/// Decodes an image file into memory, does not touch OpenGL so this can be done on any thread
+	/// </summary>
+	static DecodedImage _DecodeImage(const std::string& filename, PixelFormat formatHint);
+	static Texture2DDescription _ParseDescription(const nlohmann::json& data);
 
 public:
 	static Texture2D::Sptr LoadFromFile(const std::string& path, const Texture2DDescription& description = Texture2DDescription(), bool forceRgba = true);
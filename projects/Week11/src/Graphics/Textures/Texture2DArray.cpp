@@ -4,6 +4,7 @@
 #include "GLM/glm.hpp"
 #include "Utils/JsonGlmHelpers.h"
 #include "Utils/Base64.h"
+#include "Utils/VirtualFileSystem.h"
 
 /// <summary>
 /// Get the number of mipmap levels required for a texture of the given size
@@ -157,9 +158,12 @@ void Texture2DArray::_LoadDataFromFile() {
 		int width, height, numChannels;
 		const int targetChannels = GetTexelComponentCount(_description.FormatHint);
 
-		// Use STBI to load the image
+		// Use STBI to load the image, straight from the asset archive if it's packed
 		stbi_set_flip_vertically_on_load(true);
-		uint8_t* data = stbi_load(_description.Filename.c_str(), &width, &height, &numChannels, targetChannels);
+		std::string_view packed = VirtualFileSystem::GetView(_description.Filename);
+		uint8_t* data = packed.data() != nullptr ?
+			stbi_load_from_memory(reinterpret_cast<const stbi_uc*>(packed.data()), static_cast<int>(packed.size()), &width, &height, &numChannels, targetChannels) :
+			stbi_load(_description.Filename.c_str(), &width, &height, &numChannels, targetChannels);
 
 		// If we could not load any data, warn and return null
 		if (data == nullptr) {
@@ -1,7 +1,9 @@
 #include "Texture3D.h"
-#include "Utils/Base64.h"
+#include "Utils/ResourceManager/ResourceManager.h"
 #include "Utils/JsonGlmHelpers.h"
 #include "Utils/StringUtils.h"
+#include "Utils/MemoryStream.h"
+#include "Utils/VirtualFileSystem.h"
 #include <Logging.h>
 #include <stb_image.h>
 #include <iostream>
@@ -84,14 +86,15 @@ nlohmann::json Texture3D::ToJson() const
 		result["size_y"] = _description.Height;
 		result["size_z"] = _description.Depth;
 
+		result["internal_format"] = ~_description.Format;
 		result["format"] = ~_description.FormatHint;
 		result["pixel_type"] = ~_pixelType;
 
 		if ((_description.Width * _description.Height * _description.Depth) > 0 && _description.FormatHint != PixelFormat::Unknown) {
 			size_t dataSize = GetTexelSize(_description.FormatHint, _pixelType) * _description.Width * _description.Height * _description.Depth;
-			uint8_t* dataStore = new uint8_t[dataSize];
-			glGetTextureImage(_rendererId, 0, *_description.Format, *_pixelType, dataSize, dataStore);
-			result["data"] = Base64::Encode(dataStore, dataSize);
+			std::vector<uint8_t> dataStore(dataSize);
+			glGetTextureImage(_rendererId, 0, *_description.FormatHint, *_pixelType, dataSize, dataStore.data());
+			result["data"] = ResourceManager::WriteBlob(dataStore.data(), dataSize);
 		}
 	}
 	return result;
@@ -113,18 +116,20 @@ Texture3D::Sptr Texture3D::FromJson(const nlohmann::json& data)
 	description.MinificationFilter = JsonParseEnum(MinFilter, data, "filter_min", MinFilter::NearestMipNearest);
 	description.MagnificationFilter = JsonParseEnum(MagFilter, data, "filter_mag", MagFilter::Linear);
 	description.GenerateMipMaps = JsonGet(data, "generate_mipmaps", false);
+	description.Format = JsonParseEnum(InternalFormat, data, "internal_format", description.Format);
 	description.FormatHint = JsonParseEnum(PixelFormat, data, "format", PixelFormat::Unknown);
 
 	Texture3D::Sptr result = std::make_shared<Texture3D>(description);
 
-	// If we embedded data into the JSON, load it now
-	if (description.Filename.empty() && data.contains("data") && data["data"].is_string()) {
+	// If we stored the texture's data, load it now (straight from the manifest's blob file if it's not compressed)
+	if (description.Filename.empty() && data.contains("data")) {
 		PixelType type = JsonParseEnum(PixelType, data, "pixel_type", PixelType::Unknown);
-		try {
-			std::string rawData = Base64::Decode(data['data'].get<std::string>());
-			result->LoadData(description.Width, description.Height, description.Depth, description.FormatHint, type, rawData.data());
-		}
-		catch (std::runtime_error()) {
+		std::string storage;
+		std::string_view texels = ResourceManager::ReadBlob(data["data"], storage);
+		size_t texelCount = static_cast<size_t>(description.Width) * description.Height * description.Depth;
+		if (type != PixelType::Unknown && texels.size() == GetTexelSize(description.FormatHint, type) * texelCount) {
+			result->LoadData(description.Width, description.Height, description.Depth, description.FormatHint, type, const_cast<char*>(texels.data()));
+		} else {
 			LOG_WARN("JSON blob had data, but failed to load to texture");
 		}
 	}
@@ -149,9 +154,16 @@ void Texture3D::_LoadDataFromFile()
 
 void Texture3D::_LoadCubeFile()
 {
-	std::ifstream inFile(_description.Filename);
+	// Packed LUTs are parsed straight from the asset archive's memory
+	std::string_view packed = VirtualFileSystem::GetView(_description.Filename);
+	MemoryInputStream packedStream(packed.data(), packed.data() + packed.size());
+	std::ifstream diskFile;
+	if (packed.data() == nullptr) {
+		diskFile.open(_description.Filename);
+	}
+	std::istream& inFile = packed.data() != nullptr ? static_cast<std::istream&>(packedStream) : diskFile;
 
-	if (!inFile.is_open()) {
+	if (!inFile) {
 		LOG_WARN("Failed to open file .cube file: {}", _description.Filename);
 		return;
 	}
@@ -291,3 +303,9 @@ Texture3D::Sptr Texture3D::LoadFromFile(const std::string& path, const Texture3D
 
 	return result;
 }
+
+size_t Texture3D::GetGpuMemoryUsage() const {
+	size_t result = GetInternalFormatSize(_description.Format) * _description.Width * _description.Height * _description.Depth;
+	// A full 3D mip chain adds roughly another seventh on top of the base level
+	return _description.GenerateMipMaps ? result + result / 7 : result;
+}
@@ -144,6 +144,7 @@ public:
 	const Texture3DDescription& GetDescription() const { return _description; }
 
 	virtual nlohmann::json ToJson() const override;
+	virtual size_t GetGpuMemoryUsage() const override;
 	static Texture3D::Sptr FromJson(const nlohmann::json& data);
 
 protected:
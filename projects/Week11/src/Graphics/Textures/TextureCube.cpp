@@ -2,6 +2,7 @@
 #include <filesystem>
 #include "stb_image.h"
 #include "Utils/JsonGlmHelpers.h"
+#include "Utils/VirtualFileSystem.h"
 
 TextureCube::TextureCube(const std::string& baseFilename) :
 	ITexture(TextureType::Cubemap),
@@ -82,7 +83,7 @@ void TextureCube::_LoadFromDescription()
 			targetPath += baseName.extension();
 
 			// If the file exists, store it in the description
-			if (std::filesystem::exists(targetPath)) {
+			if (VirtualFileSystem::Exists(targetPath.string())) {
 				_description.FaceFileNames[face] = targetPath.string();
 			}
 		}
@@ -115,9 +116,12 @@ void TextureCube::_LoadImages(const std::unordered_map<CubeMapFace, std::string>
 		const std::string& filename = _description.FaceFileNames[face];
 		int fileWidth, fileHeight, fileNumChannels;
 
-		// Use STBI to load the image
+		// Use STBI to load the image, straight from the asset archive if it's packed
 		stbi_set_flip_vertically_on_load(true);
-		uint8_t* data = stbi_load(filename.c_str(), &fileWidth, &fileHeight, &fileNumChannels, 0);
+		std::string_view packed = VirtualFileSystem::GetView(filename);
+		uint8_t* data = packed.data() != nullptr ?
+			stbi_load_from_memory(reinterpret_cast<const stbi_uc*>(packed.data()), static_cast<int>(packed.size()), &fileWidth, &fileHeight, &fileNumChannels, 0) :
+			stbi_load(filename.c_str(), &fileWidth, &fileHeight, &fileNumChannels, 0);
 
 		// If we could not load any data, warn and return null
 		if (data == nullptr) {
@@ -190,3 +194,8 @@ void TextureCube::_SetTextureParams(){
 		glTextureParameteri(_rendererId, GL_TEXTURE_MAG_FILTER, (GLenum)_description.MagnificationFilter);
 	}
 }
+
+size_t TextureCube::GetGpuMemoryUsage() const {
+	// Cubemaps are stored as 6 square faces
+	return GetInternalFormatSize(_description.Format) * _description.Size * _description.Size * 6;
+}
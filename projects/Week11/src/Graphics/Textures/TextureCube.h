@@ -109,6 +109,7 @@ public:
 	const TextureCubeDescription& GetDescription() const { return _description; }
 
 	virtual nlohmann::json ToJson() const override;
+	virtual size_t GetGpuMemoryUsage() const override;
 	static TextureCube::Sptr FromJson(const nlohmann::json& data);
 
 protected:
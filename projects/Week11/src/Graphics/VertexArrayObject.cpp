@@ -21,6 +21,19 @@ VertexArrayObject::~VertexArrayObject()
 	}
 }
 
+size_t VertexArrayObject::GetBufferMemoryUsage() const {
+	size_t result = 0;
+	for (const VertexBufferBinding* binding : _vertexBuffers) {
+		if (binding->Buffer != nullptr) {
+			result += static_cast<size_t>(binding->Buffer->GetElementCount()) * binding->Buffer->GetElementSize();
+		}
+	}
+	if (_indexBuffer != nullptr) {
+		result += static_cast<size_t>(_indexBuffer->GetElementCount()) * _indexBuffer->GetElementSize();
+	}
+	return result;
+}
+
 void VertexArrayObject::SetIndexBuffer(const IndexBuffer::Sptr& ibo) {
 	// TODO: What if we already have a buffer? should we delete it? who owns the buffer?
 	_indexBuffer = ibo;
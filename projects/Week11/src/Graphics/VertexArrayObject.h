@@ -88,6 +88,10 @@ public:
 	uint32_t GetVertexCount() const { return _vertexCount; }
 	uint32_t GetIndexCount() const { return _indexBuffer != nullptr ? _indexBuffer->GetElementCount() : 0; }
 	uint32_t GetElementCount() const { return _elementCount; }
+	/// <summary>
+	/// Gets the total size of the vertex and index buffers attached to this VAO, in bytes
+	/// </summary>
+	size_t GetBufferMemoryUsage() const;
 
 	/// <summary>
 	/// Creates a copy of this VAO pointing to the same buffers, with the same attributes
@@ -0,0 +1,19 @@
+#pragma once
+#include <GLM/glm.hpp>
+#include "GLM/gtc/quaternion.hpp"
+#include <cereal/cereal.hpp>
+
+// Lets glm vectors and quaternions be written to cereal archives
+namespace glm {
+	template <typename Archive, length_t L, typename T, qualifier Q>
+	void serialize(Archive& ar, vec<L, T, Q>& value) {
+		for (length_t ix = 0; ix < L; ix++) {
+			ar(value[ix]);
+		}
+	}
+
+	template <typename Archive, typename T, qualifier Q>
+	void serialize(Archive& ar, tquat<T, Q>& value) {
+		ar(value.x, value.y, value.z, value.w);
+	}
+}
@@ -4,8 +4,15 @@
 #include <Logging.h>
 
 #include "Utils/StringUtils.h"
+#include "Utils/VirtualFileSystem.h"
 
 std::string FileHelpers::ReadFile(const std::string& filename) {
+	// Files in the asset archive don't need to touch the disk
+	std::string_view packed = VirtualFileSystem::GetView(filename);
+	if (packed.data() != nullptr) {
+		return std::string(packed);
+	}
+
 	std::string result;
 	std::ifstream in(filename, std::ios::in | std::ios::binary); // ifstream closes itself due to RAII
 
@@ -34,8 +41,6 @@ std::string FileHelpers::ReadFile(const std::string& filename) {
 std::string FileHelpers::ReadResolveIncludes(const std::string& filename, std::vector<std::string> resolvedPaths) {
 	// Read the entire file contents for processing
 	std::string result = ReadFile(filename);
-	// Determine where the file we just read resides on the filesystem
-	const std::filesystem::path folder = std::filesystem::path(filename).parent_path();
 
 	// The token we're looking for, and it's length
 	const char* includeToken = "#include";
@@ -60,32 +65,21 @@ std::string FileHelpers::ReadResolveIncludes(const std::string& filename, std::v
 		StringTools::Trim(path, '"');
 
 		// Determine the file path
-		std::filesystem::path target;
-		// If it starts with '/', relative to application directory
-		if (path[0] == '/') {
-			target = path;
-		}
-		// Otherwise relative to the current directory
-		else {
-			target = folder / path;
-		}
-		// Get a lexically normal path (ie with the ../ parts resolved)
-		target = target.lexically_normal();
-		target = std::filesystem::relative(target);
+		std::string target = ResolveIncludePath(filename, path);
 
 		// If we haven't included the file yet, include it now
-		if (std::find(resolvedPaths.begin(), resolvedPaths.end(), target.string()) == resolvedPaths.end()) {
+		if (std::find(resolvedPaths.begin(), resolvedPaths.end(), target) == resolvedPaths.end()) {
 
 			// Make sure file exists, then load and resolve it's includes
-			LOG_ASSERT(std::filesystem::exists(target), "File does not exist");
-			std::string replacement = FileHelpers::ReadResolveIncludes(target.string(), resolvedPaths);
+			LOG_ASSERT(VirtualFileSystem::Exists(target), "File does not exist");
+			std::string replacement = FileHelpers::ReadResolveIncludes(target, resolvedPaths);
 
 			// Inject result into our string
 			result.replace(seek, eol - seek, replacement);
 			// Look for more includes!
 			seek = result.find(includeToken, seek + replacement.length());
 
-			resolvedPaths.push_back(target.string());
+			resolvedPaths.push_back(target);
 		}
 		// File already included, remove the line and continue seeking
 		else {
@@ -97,7 +91,48 @@ std::string FileHelpers::ReadResolveIncludes(const std::string& filename, std::v
 	return result;
 }
 
+std::vector<std::string> FileHelpers::FindIncludes(const std::string& filename) {
+	std::vector<std::string> result;
+	std::string contents = ReadFile(filename);
+
+	const char* includeToken = "#include";
+	const size_t includeTokenLen = const_strlen(includeToken);
+	for (size_t seek = contents.find(includeToken, 0); seek != std::string::npos; seek = contents.find(includeToken, seek + includeTokenLen)) {
+		size_t eol = contents.find_first_of("\r\n", seek);
+		if (eol == std::string::npos) {
+			eol = contents.size();
+		}
+
+		size_t begin = seek + includeTokenLen + 1;
+		std::string path = begin < eol ? contents.substr(begin, eol - begin) : std::string();
+		StringTools::Trim(path);
+		StringTools::Trim(path, '"');
+		if (!path.empty()) {
+			result.push_back(ResolveIncludePath(filename, path));
+		}
+	}
+	return result;
+}
+
+std::string FileHelpers::ResolveIncludePath(const std::string& filename, const std::string& includePath) {
+	std::filesystem::path target;
+	// If it starts with '/', relative to application directory
+	if (includePath[0] == '/') {
+		target = includePath;
+	}
+	// Otherwise relative to the file's directory
+	else {
+		target = std::filesystem::path(filename).parent_path() / includePath;
+	}
+	// Get a lexically normal path (ie with the ../ parts resolved)
+	target = target.lexically_normal();
+	target = std::filesystem::relative(target);
+	return target.string();
+}
+
 void FileHelpers::WriteContentsToFile(const std::string& filename, const std::string& contents, bool append /*= false*/) {
 	std::ofstream output(filename, std::ios::out | (append ? std::ios::app : 0));
 	output << contents;
+	output.close();
+	VirtualFileSystem::MarkModified(filename);
 }
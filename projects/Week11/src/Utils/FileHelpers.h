@@ -7,7 +7,8 @@ class FileHelpers {
 public:
 	FileHelpers() = delete;
 	/// <summary>
-	/// Reads the entire contents of a file into a string
+	/// Reads the entire contents of a file into a string, from the mounted asset archive if the file
+	/// is in it (see VirtualFileSystem)
 	/// </summary>
 	/// <param name="filename">The path of the file to load</param>
 	/// <returns>The entire contents of the file stored in a string</returns>
@@ -21,6 +22,20 @@ public:
 	/// <param name="resolvedPaths">The list of paths that have already been included</param>
 	/// <returns>The entire contents of the file, with includes resolved, stored in a string</returns>
 	static std::string ReadResolveIncludes(const std::string& filename, std::vector<std::string> resolvedPaths = std::vector<std::string>());
+	/// <summary>
+	/// Finds the paths of the files included by a file with #include, without resolving the includes
+	/// of those files
+	/// </summary>
+	/// <param name="filename">The path of the file to search</param>
+	/// <returns>The resolved paths of the included files</returns>
+	static std::vector<std::string> FindIncludes(const std::string& filename);
+	/// <summary>
+	/// Works out the path of a file included by another file. Includes are relative to the including
+	/// file, or relative to the application directory if they start with '/'
+	/// </summary>
+	/// <param name="filename">The path of the file containing the #include</param>
+	/// <param name="includePath">The path given to the #include, with whitespace and quotes trimmed</param>
+	static std::string ResolveIncludePath(const std::string& filename, const std::string& includePath);
 
 	/// <summary>
 	/// Helper for writing the contents of a string into a file
@@ -0,0 +1,46 @@
+#pragma once
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+/// <summary>
+/// A read-only memory mapping of an entire file. The file's contents can be read through View until
+/// the mapping is closed (or the object is destroyed), without ever being copied into memory we own
+/// </summary>
+class MappedFile {
+public:
+	MappedFile();
+	~MappedFile();
+
+	MappedFile(const MappedFile& other) = delete;
+	MappedFile& operator=(const MappedFile& other) = delete;
+
+	/// <summary>
+	/// Maps a file into memory, closing the file that was mapped before
+	/// </summary>
+	/// <param name="path">The path of the file to map</param>
+	/// <returns>True if the file was mapped, false if it could not be opened or is empty</returns>
+	bool Open(const std::string& path);
+	/// <summary>
+	/// Unmaps the file, invalidating any views into it
+	/// </summary>
+	void Close();
+
+	/// <summary>
+	/// Returns true if a file is currently mapped
+	/// </summary>
+	bool IsOpen() const { return _data != nullptr; }
+	/// <summary>
+	/// Gets a view of the mapped file's contents, with a null data pointer if no file is mapped
+	/// </summary>
+	std::string_view View() const { return _data != nullptr ? std::string_view(_data, _size) : std::string_view(); }
+
+private:
+	const char* _data;
+	size_t      _size;
+#ifdef _WIN32
+	// Stored as void* so that we don't need to include Windows.h in the header
+	void*       _file;
+	void*       _mapping;
+#endif
+};
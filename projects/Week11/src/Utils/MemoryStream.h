@@ -0,0 +1,29 @@
+#pragma once
+#include <istream>
+#include <streambuf>
+
+/// <summary>
+/// A read-only stream over a block of memory that the stream does not own, which lets us hand
+/// parts of a file that we've already read to stream based readers (like cereal) without copying.
+/// The memory must outlive the stream
+/// </summary>
+class MemoryInputStream : public std::istream {
+public:
+	MemoryInputStream(const char* begin, const char* end) :
+		std::istream(nullptr),
+		_buffer(begin, end)
+	{
+		rdbuf(&_buffer);
+	}
+
+private:
+	struct Buffer : public std::streambuf {
+		Buffer(const char* begin, const char* end) {
+			// The get area is never written to, so casting away const is safe here
+			char* data = const_cast<char*>(begin);
+			setg(data, data, data + (end - begin));
+		}
+	};
+
+	Buffer _buffer;
+};
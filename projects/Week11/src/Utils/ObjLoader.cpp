@@ -8,17 +8,46 @@
 #include <filesystem>
 
 #include "Utils/StringUtils.h"
+#include "Utils/MemoryStream.h"
+#include "Utils/VirtualFileSystem.h"
 
-VertexArrayObject::Sptr ObjLoader::LoadFromFile(const std::string& filename)
+VertexArrayObject::Sptr ObjLoader::LoadFromFile(const std::string& filename, std::vector<glm::vec3>* positionsOut)
 {
-	if (!std::filesystem::exists(filename)) {
-		LOG_WARN("Failed to find OBJ file: \"{}\"", filename);
+	std::vector<VertexPosNormTexCol> vertexData;
+	if (!LoadVertices(filename, vertexData, positionsOut)) {
 		return nullptr;
 	}
+	return CreateVao(vertexData);
+}
+
+VertexArrayObject::Sptr ObjLoader::CreateVao(const std::vector<VertexPosNormTexCol>& vertexData)
+{
+	// Create a vertex buffer and load all our vertex data
+	VertexBuffer::Sptr vertexBuffer = VertexBuffer::Create();
+	vertexBuffer->LoadData(vertexData.data(), vertexData.size());
+
+	// Create the VAO, and add the vertices
+	VertexArrayObject::Sptr result = VertexArrayObject::Create();
+	result->AddVertexBuffer(vertexBuffer, VertexPosNormTexCol::V_DECL);
+	result->SetVDecl(VertexPosNormTexCol::V_DECL);
+	return result;
+}
+
+bool ObjLoader::LoadVertices(const std::string& filename, std::vector<VertexPosNormTexCol>& vertexData, std::vector<glm::vec3>* positionsOut)
+{
+	if (!VirtualFileSystem::Exists(filename)) {
+		LOG_WARN("Failed to find OBJ file: \"{}\"", filename);
+		return false;
+	}
 
-	// Open our file in binary mode
-	std::ifstream file;
-	file.open(filename, std::ios::binary);
+	// Packed files are parsed straight from the asset archive's memory, otherwise we open our file in binary mode
+	std::string_view packed = VirtualFileSystem::GetView(filename);
+	MemoryInputStream packedStream(packed.data(), packed.data() + packed.size());
+	std::ifstream diskFile;
+	if (packed.data() == nullptr) {
+		diskFile.open(filename, std::ios::binary);
+	}
+	std::istream& file = packed.data() != nullptr ? static_cast<std::istream&>(packedStream) : diskFile;
 
 	// If our file fails to open, we will throw an error
 	if (!file) {
@@ -123,7 +152,8 @@ VertexArrayObject::Sptr ObjLoader::LoadFromFile(const std::string& filename)
 	}
 
 	// TODO: Generate mesh from the data we loaded
-	std::vector<VertexPosNormTexCol> vertexData;
+	vertexData.clear();
+	vertexData.reserve(vertices.size());
 
 	for (int ix = 0; ix < vertices.size(); ix++) {
 		glm::ivec3 attribs = vertices[ix];
@@ -137,21 +167,15 @@ VertexArrayObject::Sptr ObjLoader::LoadFromFile(const std::string& filename)
 		// Add the vertex to the mesh
 		vertexData.push_back(VertexPosNormTexCol(position, normal, uv, color));
 	}
-
-	// Create a vertex buffer and load all our vertex data
-	VertexBuffer::Sptr vertexBuffer = VertexBuffer::Create();
-	vertexBuffer->LoadData(vertexData.data(), vertexData.size());
-
-	// Create the VAO, and add the vertices
-	VertexArrayObject::Sptr result = VertexArrayObject::Create();
-	result->AddVertexBuffer(vertexBuffer, VertexPosNormTexCol::V_DECL);
-
-	result->SetVDecl(VertexPosNormTexCol::V_DECL);
 	
 	// Calculate and trace out how long it took us to load
 	float endTime = glfwGetTime();
 	LOG_TRACE("Loaded OBJ file \"{}\" in {} seconds ({} vertices, {} indices)", filename, endTime - startTime, vertexData.size(), 0);
 
-	return result;
-	//return VertexArrayObject::Create();
+	// Hand the positions back if the caller wants to keep them around on the CPU
+	if (positionsOut != nullptr) {
+		*positionsOut = std::move(positions);
+	}
+
+	return true;
 }
@@ -6,7 +6,25 @@ class ObjLoader
 {
 public:
 	
-	static VertexArrayObject::Sptr LoadFromFile(const std::string& filename);
+	/// <summary>
+	/// Loads a VAO from an OBJ file
+	/// </summary>
+	/// <param name="filename">The path to the OBJ file to load</param>
+	/// <param name="positions">If not null, will receive a CPU side copy of the unique vertex positions in the file</param>
+	static VertexArrayObject::Sptr LoadFromFile(const std::string& filename, std::vector<glm::vec3>* positions = nullptr);
+	/// <summary>
+	/// Parses the vertices from an OBJ file without creating any OpenGL objects, so this can be called
+	/// from any thread. Use CreateVao to upload the result
+	/// </summary>
+	/// <param name="filename">The path to the OBJ file to load</param>
+	/// <param name="vertexData">Receives the vertices in the mesh</param>
+	/// <param name="positions">If not null, will receive a CPU side copy of the unique vertex positions in the file</param>
+	/// <returns>True if the file was loaded</returns>
+	static bool LoadVertices(const std::string& filename, std::vector<VertexPosNormTexCol>& vertexData, std::vector<glm::vec3>* positions = nullptr);
+	/// <summary>
+	/// Creates a VAO from vertices loaded by LoadVertices, must be called from the main thread
+	/// </summary>
+	static VertexArrayObject::Sptr CreateVao(const std::vector<VertexPosNormTexCol>& vertexData);
 
 protected:
 	ObjLoader() = default;
@@ -7,8 +7,13 @@
 #include <fstream>
 #include <iostream>
 #include <filesystem>
+#include <algorithm>
+#include <cstring>
 
 #include "Utils/StringUtils.h"
+#include "Utils/FileHelpers.h"
+#include "Utils/MemoryStream.h"
+#include "Utils/VirtualFileSystem.h"
 #include "GLFW/glfw3.h"
 #include "Logging.h"
 
@@ -17,7 +22,7 @@ const std::string binaryExtension = ".bin";
 
 namespace fs = std::filesystem;
 
-VertexArrayObject::Sptr OptimizedObjLoader::LoadFromFile(const std::string& filename) {
+VertexArrayObject::Sptr OptimizedObjLoader::LoadFromFile(const std::string& filename, std::vector<glm::vec3>* positions) {
 	// Get the file extension and lowercase it
 	fs::path filePath = std::filesystem::path(filename);
 	std::string extension = filePath.extension().string();
@@ -28,15 +33,15 @@ VertexArrayObject::Sptr OptimizedObjLoader::LoadFromFile(const std::string& file
 		// Get the binary path
 		fs::path binPath = filePath.replace_extension(binaryExtension);
 		// If the file does not exist, convert the OBJ file to a binary file
-		if (!fs::exists(binPath)) {
+		if (!VirtualFileSystem::Exists(binPath.string())) {
 			ConvertToBinary(filename, binPath.string());
 		}
 		// Load the corresponding binary file
-		return _LoadFromBinFile(binPath.string());
+		return _LoadFromBinFile(binPath.string(), positions);
 	} 
 	// Load our fancy binary files
 	else if (extension == ".bin") {
-		return _LoadFromBinFile(filename);
+		return _LoadFromBinFile(filename, positions);
 	}
 	// We've never met this extension in our life
 	else {
@@ -73,9 +78,14 @@ void OptimizedObjLoader::ConvertToBinary(const std::string& inFile, const std::s
 }
 
 MeshBuilder<VertexPosNormTexColTangents>* OptimizedObjLoader::_LoadFromObjFile(const std::string& filename) {
-	// Open our file in binary mode
-	std::ifstream file;
-	file.open(filename, std::ios::binary);
+	// Packed files are parsed straight from the asset archive's memory, otherwise we open our file in binary mode
+	std::string_view packed = VirtualFileSystem::GetView(filename);
+	MemoryInputStream packedStream(packed.data(), packed.data() + packed.size());
+	std::ifstream diskFile;
+	if (packed.data() == nullptr) {
+		diskFile.open(filename, std::ios::binary);
+	}
+	std::istream& file = packed.data() != nullptr ? static_cast<std::istream&>(packedStream) : diskFile;
 
 	// If our file fails to open, we will throw an error
 	if (!file) {
@@ -233,24 +243,26 @@ MeshBuilder<VertexPosNormTexColTangents>* OptimizedObjLoader::_LoadFromObjFile(c
 	return mesh;
 }
 
-VertexArrayObject::Sptr OptimizedObjLoader::_LoadFromBinFile(const std::string& filename) {
+VertexArrayObject::Sptr OptimizedObjLoader::_LoadFromBinFile(const std::string& filename, std::vector<glm::vec3>* positions) {
 
-	// Open the output file
-	std::ifstream file(filename, std::ios::binary);
-	// If our file fails to open, we will throw an error
-	if (!file) { throw std::runtime_error("Failed to open file"); }
+	// Packed files are used in place, so the buffers below are uploaded straight from the asset archive's
+	// memory. Loose files are read in a single call, rather than once per section
+	std::string_view packed = VirtualFileSystem::GetView(filename);
+	std::string contents;
+	if (packed.data() == nullptr) {
+		if (!std::filesystem::exists(filename)) { throw std::runtime_error("Failed to open file"); }
+		contents = FileHelpers::ReadFile(filename);
+		packed = contents;
+	}
+	const char* data = packed.data();
+	size_t size = packed.size();
 
 	float startTime = static_cast<float>(glfwGetTime());
 
-	// Get the file size so we can avoid reading past the end
-	file.seekg(0, std::ios::end);
-	size_t size = file.tellg();
-	file.seekg(0, std::ios::beg);
-
 	// Read the header from the file
 	BinaryHeader header = BinaryHeader();
 	if (size >= sizeof(BinaryHeader)) {
-		file.read(reinterpret_cast<char*>(&header), sizeof(BinaryHeader));
+		memcpy(&header, data, sizeof(BinaryHeader));
 	} else {
 		LOG_ERROR("Not enough data in the file!");
 		return nullptr;
@@ -272,42 +284,45 @@ VertexArrayObject::Sptr OptimizedObjLoader::_LoadFromBinFile(const std::string&
 			LOG_ERROR("Not enough data in the file!");
 			return nullptr;
 		}
+		const char* cursor = data + sizeof(BinaryHeader);
 
 		// Read all attributes from the file, this is basically our VDECL
 		std::vector<BufferAttribute> vertexDeclaration;
 		vertexDeclaration.resize(header.NumAttributes);
-		for (int ix = 0; ix < header.NumAttributes; ix++) {
-			file.read(reinterpret_cast<char*>(&vertexDeclaration[ix]), sizeof(BufferAttribute));
-		}
+		memcpy(vertexDeclaration.data(), cursor, header.NumAttributes * sizeof(BufferAttribute));
+		cursor += header.NumAttributes * sizeof(BufferAttribute);
 
 		// These will have the buffer pointers
 		IndexBuffer::Sptr indices = nullptr;
 		VertexBuffer::Sptr vertices = nullptr;
 
-		// If we have index data, load it
+		// If we have index data, load it straight into OpenGL
 		if (header.NumIndices > 0) {
-			// Create index buffer
 			indices = IndexBuffer::Create(BufferUsage::StaticDraw);
-
-			// Create memory to store indices, then read from the file
-			void* dataStore = malloc(header.NumIndices * GetIndexTypeSize(header.IndicesType));
-			file.read(reinterpret_cast<char*>(dataStore), header.NumIndices * GetIndexTypeSize(header.IndicesType));
-			
-			// Load data into OpenGL and free the CPU memory we allocated
-			indices->LoadData(dataStore, GetIndexTypeSize(header.IndicesType), header.NumIndices, header.IndicesType);
-			free(dataStore);
+			indices->LoadData(cursor, GetIndexTypeSize(header.IndicesType), header.NumIndices, header.IndicesType);
+			cursor += header.NumIndices * GetIndexTypeSize(header.IndicesType);
 		}
 
-		// Create a new VBO
+		// Create a new VBO, and load the vertices straight into OpenGL
+		const uint8_t* vertexStore = reinterpret_cast<const uint8_t*>(cursor);
 		vertices = VertexBuffer::Create(BufferUsage::StaticDraw);
-
-		// Create memory to store vertices and load from file
-		void* vertexStore = malloc(header.NumVertices * (size_t)header.VertexStride);
-		file.read(reinterpret_cast<char*>(vertexStore), header.NumVertices * (size_t)header.VertexStride);
-
-		// Load data into OpenGL and free the CPU copy
 		vertices->LoadData(vertexStore, header.VertexStride, header.NumVertices);
-		free(vertexStore);
+
+		// If the caller wants the positions on the CPU, pull them out of the file data
+		if (positions != nullptr) {
+			positions->clear();
+			auto it = std::find_if(vertexDeclaration.begin(), vertexDeclaration.end(), [](const BufferAttribute& attrib) {
+				return attrib.Usage == AttribUsage::Position;
+			});
+			if (it != vertexDeclaration.end() && it->Type == AttributeType::Float && it->Size >= 3) {
+				positions->resize(header.NumVertices);
+				for (uint32_t ix = 0; ix < header.NumVertices; ix++) {
+					memcpy(&(*positions)[ix], vertexStore + (ix * (size_t)header.VertexStride) + it->Offset, sizeof(glm::vec3));
+				}
+			} else {
+				LOG_WARN("Mesh \"{}\" does not have float3 positions, cannot keep them on the CPU", filename);
+			}
+		}
 
 		// Create the VAO and attach our index and vertex buffers
 		VertexArrayObject::Sptr result = VertexArrayObject::Create();
@@ -24,8 +24,9 @@ public:
 	/// to a binary file and load that instead. On subsequent runs, the binary file will be loaded instead
 	/// </summary>
 	/// <param name="filename">The path to the .obj or .bin file to load</param>
+	/// <param name="positions">If not null, will receive a CPU side copy of the vertex positions in the mesh</param>
 	/// <returns>A VAO loaded from disk</returns>
-	static VertexArrayObject::Sptr LoadFromFile(const std::string& filename);
+	static VertexArrayObject::Sptr LoadFromFile(const std::string& filename, std::vector<glm::vec3>* positions = nullptr);
 	/// <summary>
 	/// Manually converts an OBJ file into a binary mesh file
 	/// </summary>
@@ -65,7 +66,7 @@ protected:
 	~OptimizedObjLoader() = default;
 
 	static MeshBuilder<VertexPosNormTexColTangents>* _LoadFromObjFile(const std::string& filename);
-	static VertexArrayObject::Sptr _LoadFromBinFile(const std::string& filename);
+	static VertexArrayObject::Sptr _LoadFromBinFile(const std::string& filename, std::vector<glm::vec3>* positions);
 };
 
 template <typename VertexType>
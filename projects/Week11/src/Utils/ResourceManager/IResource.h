@@ -1,4 +1,5 @@
 #pragma once
+#include <functional>
 #include "Utils/GUID.hpp"
 #include "json.hpp"
 
@@ -12,11 +13,17 @@
 /// Resources must additionally define a static method as such:
 /// static std::shared_ptr<Type> FromJson(const nlohmann::json&);
 /// where Type is the Type of resource
+///
+/// Resources may also define a static method to support background loading:
+/// static IResource::FinalizeFunc DecodeFromJson(const nlohmann::json&);
+/// which does the CPU side of the load (file IO, decoding, parsing) on a worker thread, and returns
+/// a function that will be called on the main thread to create the resource and any OpenGL objects
 /// </summary>
 class IResource {
 public:
 	typedef std::shared_ptr<IResource> Sptr;
 	typedef std::weak_ptr<IResource>   Wptr;
+	typedef std::function<Sptr()>      FinalizeFunc;
 
 	virtual ~IResource() = default;
 
@@ -41,9 +48,23 @@ public:
 	/// <returns>The JSON blob for the resource</returns>
 	virtual nlohmann::json ToJson() const = 0;
 
+	/// <summary>
+	/// Gets an estimate of the CPU memory used by this resource in bytes, the resource manager uses this
+	/// to decide when to evict unused resources
+	/// </summary>
+	virtual size_t GetCpuMemoryUsage() const { return 0; }
+	/// <summary>
+	/// Gets an estimate of the GPU memory used by this resource in bytes
+	/// </summary>
+	virtual size_t GetGpuMemoryUsage() const { return 0; }
+
 protected:
+	friend class ResourceManager;
+
 	Guid _guid;
-	IResource() : _guid(Guid::New()){}
+	// The resource manager frame that this resource was last requested on, used for LRU eviction
+	uint64_t _lastUsedFrame;
+	IResource() : _guid(Guid::New()), _lastUsedFrame(0) {}
 };
 
 /// <summary>
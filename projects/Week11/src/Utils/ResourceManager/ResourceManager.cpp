@@ -3,12 +3,36 @@
 #include "Utils/ObjLoader.h"
 #include "Utils/FileHelpers.h"
 #include "Utils/StringUtils.h"
+#include "Utils/Base64.h"
 
-std::map<std::type_index, std::map<Guid, IResource::Sptr>> ResourceManager::_resources;
-std::map<std::string, std::function<Guid(const nlohmann::json&)>> ResourceManager::_typeLoaders;
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <gzip/compress.hpp>
+#include <gzip/decompress.hpp>
+#include "Logging.h"
+
+ResourceTable ResourceManager::_resources;
+std::vector<ResourceManager::TypeInfo> ResourceManager::_types;
+std::unordered_map<std::string, uint32_t> ResourceManager::_typeNameMap;
 
 nlohmann::ordered_json ResourceManager::_manifest;
 
+std::map<Guid, std::shared_ptr<ResourceManager::LoadRequest>> ResourceManager::_pending;
+std::mutex ResourceManager::_decodedLock;
+std::deque<std::shared_ptr<ResourceManager::LoadRequest>> ResourceManager::_decoded;
+uint64_t ResourceManager::_frameIndex = 0;
+ResourceManager::MemoryStats ResourceManager::_memoryStats;
+
+MappedFile ResourceManager::_blobFile;
+std::string_view ResourceManager::_blobs;
+ResourceManager::BlobWriter* ResourceManager::_blobWriter = nullptr;
+bool ResourceManager::_compressBlobs = false;
+
+// Blobs are aligned within the blob file, so that uploads from the mapped file are never misaligned
+static const size_t BlobAlignment = 16;
+
 void ResourceManager::Init() {
 	// TODO: initialize the resource manager once it's a bit more complex
 	//_manifest["textures"]  = std::vector<nlohmann::json>();
@@ -22,39 +46,594 @@ const nlohmann::ordered_json& ResourceManager::GetManifest() {
 }
 
 void ResourceManager::LoadManifest(const std::string& path, bool preloadAssets) {
+	auto start = std::chrono::high_resolution_clock::now();
+
 	std::string contents = FileHelpers::ReadFile(path);
 	nlohmann::ordered_json blob = nlohmann::ordered_json::parse(contents);
 	_manifest = blob;
+	_MapBlobs(path);
+
+	double parseMs = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+	LOG_INFO("Loaded manifest \"{}\" ({} bytes, {} bytes of blobs) in {:.2f}ms", path, contents.size(), _blobs.size(), parseMs);
+
+	// Rebuild the manifest entries in the resource table, resources that are already loaded are kept
+	_resources.Each([](ResourceTable::Entry& entry) {
+		entry.InManifest = false;
+	});
+	for (uint32_t typeId = 0; typeId < _types.size(); typeId++) {
+		_IndexManifest(typeId);
+	}
 
 	if (preloadAssets) {
-		for (auto& [typeName, items] : blob.items()) {
-			auto& func = _typeLoaders[typeName];
-			if (func) {
-				for (auto& [guid, blob] : items.items()) {
-					func(blob);
-				}
+		PreloadManifest();
+	}
+}
+
+/// <summary>
+/// Invokes a function for every string in a block of JSON that is a valid GUID, skipping the top level "guid" field
+/// (which is a resource's own GUID) and "dependencies" field (which may be out of date)
+/// </summary>
+template <typename JsonType, typename Func>
+static void EachGuidString(const JsonType& data, const Func& func, bool isRoot = true) {
+	if (data.is_string()) {
+		// GUIDs are always stored in their dashed form, so we can skip most strings without parsing them
+		const std::string& value = data.template get_ref<const std::string&>();
+		if (value.size() == 36) {
+			Guid id(value);
+			if (id.isValid()) {
+				func(id);
+			}
+		}
+	} else if (data.is_object()) {
+		for (auto it = data.begin(); it != data.end(); ++it) {
+			if (!isRoot || (it.key() != "guid" && it.key() != "dependencies")) {
+				EachGuidString(it.value(), func, false);
+			}
+		}
+	} else if (data.is_array()) {
+		for (const auto& item : data) {
+			EachGuidString(item, func, false);
+		}
+	}
+}
+
+template <typename JsonType>
+std::vector<Guid> ResourceManager::_GetDependencies(const JsonType& data, bool useRecorded) {
+	std::vector<Guid> result;
+	if (useRecorded && data.is_object() && data.contains("dependencies") && data["dependencies"].is_array()) {
+		for (const auto& item : data["dependencies"]) {
+			result.push_back(Guid(item.template get<std::string>()));
+		}
+		return result;
+	}
+
+	EachGuidString(data, [&](const Guid& id) {
+		if (_FindTypeId(id) != ResourceTable::InvalidTypeId) {
+			result.push_back(id);
+		}
+	});
+	std::sort(result.begin(), result.end());
+	result.erase(std::unique(result.begin(), result.end()), result.end());
+	return result;
+}
+
+std::vector<Guid> ResourceManager::FindDependencies(const nlohmann::json& data) {
+	return _GetDependencies(data, false);
+}
+
+void ResourceManager::RecordDependencies(nlohmann::json& data) {
+	nlohmann::json dependencies = nlohmann::json::array();
+	for (const Guid& id : FindDependencies(data)) {
+		dependencies.push_back(id.str());
+	}
+	data["dependencies"] = dependencies;
+}
+
+std::vector<Guid> ResourceManager::GetDependencies(const nlohmann::json& data) {
+	return _GetDependencies(data, true);
+}
+
+void ResourceManager::PreloadManifest() {
+	std::vector<Guid> resources;
+	_resources.Each([&](ResourceTable::Entry& entry) {
+		if (entry.InManifest) {
+			resources.push_back(entry.Id);
+		}
+	});
+	PreloadDependencies(resources);
+}
+
+void ResourceManager::PreloadDependencies(const std::vector<Guid>& resources) {
+	auto start = std::chrono::high_resolution_clock::now();
+
+	struct Node {
+		uint32_t                     TypeId;
+		Guid                         Id;
+		std::vector<Guid>            DependencyIds;
+		// Indices of the nodes that this node depends on, and of the nodes that depend on it
+		std::vector<size_t>          Dependencies;
+		std::vector<size_t>          Dependents;
+		std::shared_ptr<LoadRequest> Request;
+	};
+
+	// Build the graph by walking out from the requested resources through their dependencies
+	std::vector<Node> nodes;
+	std::unordered_map<Guid, size_t> indices;
+	std::vector<Guid> open(resources.begin(), resources.end());
+	while (!open.empty()) {
+		Guid id = open.back();
+		open.pop_back();
+		if (indices.find(id) != indices.end()) continue;
+
+		uint32_t typeId = _FindTypeId(id);
+		if (typeId == ResourceTable::InvalidTypeId) continue;
+
+		Node node;
+		node.TypeId = typeId;
+		node.Id = id;
+
+		// Resources that are already loaded are holding on to their dependencies, so we don't need to visit them
+		const ResourceTable::Entry* entry = _resources.Find(typeId, id);
+		if (entry->Resource == nullptr) {
+			auto items = _manifest.find(_types[typeId].Name);
+			auto blob = items != _manifest.end() ? items->find(id.str()) : items;
+			if (items != _manifest.end() && blob != items->end()) {
+				node.DependencyIds = _GetDependencies(*blob, true);
+				open.insert(open.end(), node.DependencyIds.begin(), node.DependencyIds.end());
+			}
+		}
+
+		indices[id] = nodes.size();
+		nodes.push_back(std::move(node));
+	}
+
+	// Link up the edges, skipping any dependencies that don't exist
+	std::vector<size_t> remaining(nodes.size(), 0);
+	std::vector<size_t> order;
+	order.reserve(nodes.size());
+	for (size_t ix = 0; ix < nodes.size(); ix++) {
+		for (const Guid& dependency : nodes[ix].DependencyIds) {
+			auto it = indices.find(dependency);
+			if (it != indices.end() && it->second != ix) {
+				nodes[ix].Dependencies.push_back(it->second);
+				nodes[it->second].Dependents.push_back(ix);
 			}
 		}
+		remaining[ix] = nodes[ix].Dependencies.size();
+		if (remaining[ix] == 0) {
+			order.push_back(ix);
+		}
+	}
+
+	// Sort so that every node comes after it's dependencies, starting from the leaves
+	for (size_t ix = 0; ix < order.size(); ix++) {
+		for (size_t dependent : nodes[order[ix]].Dependents) {
+			if (--remaining[dependent] == 0) {
+				order.push_back(dependent);
+			}
+		}
+	}
+	if (order.size() < nodes.size()) {
+		LOG_WARN("Resource dependencies contain a cycle, {} resources will be loaded in the order they were found", nodes.size() - order.size());
+		for (size_t ix = 0; ix < nodes.size(); ix++) {
+			if (remaining[ix] > 0) {
+				order.push_back(ix);
+			}
+		}
+	}
+
+	// Kick off all the decodes so they can run in parallel, leaves first since they'll be finalized first.
+	// _RequestLoad skips anything that's already been loaded, so we don't replace resources that are in use
+	for (size_t ix : order) {
+		nodes[ix].Request = _RequestLoad(nodes[ix].TypeId, nodes[ix].Id);
+	}
+
+	// Finalize in dependency order, and work out the longest chain of dependent loads as we go
+	std::vector<double> pathMs(nodes.size(), 0.0);
+	std::vector<size_t> pathLength(nodes.size(), 0);
+	double workMs = 0.0;
+	size_t critical = 0;
+	for (size_t ix : order) {
+		_Wait(nodes[ix].Request);
+
+		double costMs = nodes[ix].Request->DecodeMs + nodes[ix].Request->FinalizeMs;
+		workMs += costMs;
+		for (size_t dependency : nodes[ix].Dependencies) {
+			if (pathMs[dependency] > pathMs[ix]) {
+				pathMs[ix] = pathMs[dependency];
+				pathLength[ix] = pathLength[dependency];
+			}
+		}
+		pathMs[ix] += costMs;
+		pathLength[ix]++;
+		if (pathMs[ix] > pathMs[critical]) {
+			critical = ix;
+		}
+	}
+
+	double elapsedMs = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+	LOG_INFO("Preloaded {} resources in {:.2f}ms ({:.2f}ms of work, critical path {:.2f}ms over {} resources)",
+		nodes.size(), elapsedMs, workMs, nodes.empty() ? 0.0 : pathMs[critical], nodes.empty() ? 0 : pathLength[critical]);
+}
+
+void ResourceManager::ProcessPendingLoads(double budgetMs) {
+	auto start = std::chrono::high_resolution_clock::now();
+	do {
+		std::shared_ptr<LoadRequest> request;
+		{
+			std::lock_guard<std::mutex> lock(_decodedLock);
+			if (_decoded.empty()) break;
+			request = _decoded.front();
+			_decoded.pop_front();
+		}
+		_Finalize(request);
+	} while (std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count() < budgetMs);
+}
+
+uint32_t ResourceManager::_AddType(const std::string& typeName) {
+	uint32_t typeId = static_cast<uint32_t>(_types.size());
+	_types.push_back({ typeName, nullptr, nullptr });
+	_typeNameMap[typeName] = typeId;
+	return typeId;
+}
+
+uint32_t ResourceManager::_FindTypeId(const Guid& id) {
+	for (uint32_t typeId = 0; typeId < _types.size(); typeId++) {
+		const ResourceTable::Entry* entry = _resources.Find(typeId, id);
+		if (entry != nullptr && (entry->InManifest || entry->Resource != nullptr)) {
+			return typeId;
+		}
+	}
+	return ResourceTable::InvalidTypeId;
+}
+
+void ResourceManager::_IndexManifest(uint32_t typeId) {
+	auto items = _manifest.find(_types[typeId].Name);
+	if (items == _manifest.end() || !items->is_object()) return;
+
+	for (auto& [guid, blob] : items->items()) {
+		_resources.FindOrInsert(typeId, Guid(guid)).InManifest = true;
+	}
+}
+
+std::shared_ptr<ResourceManager::LoadRequest> ResourceManager::_RequestLoad(uint32_t typeId, const Guid& id) {
+	std::shared_ptr<LoadRequest> request = std::make_shared<LoadRequest>(id, typeId);
+
+	// Resources that are already loaded give back a finished request
+	const ResourceTable::Entry* entry = typeId == ResourceTable::InvalidTypeId ? nullptr : _resources.Find(typeId, id);
+	if (entry != nullptr && entry->Resource != nullptr) {
+		request->Result = entry->Resource;
+		request->IsDone = true;
+		return request;
+	}
+
+	// If it's already loading, share the existing request
+	auto pending = _pending.find(id);
+	if (pending != _pending.end()) {
+		return pending->second;
+	}
+
+	// Resources that aren't in the manifest can't be loaded, so these are done as well (with a null result)
+	if (entry == nullptr || !entry->InManifest || !_types[typeId].Decoder) {
+		request->IsDone = true;
+		return request;
+	}
+
+	// We copy the manifest entry, since the manifest may change while the worker is decoding
+	const TypeInfo& type = _types[typeId];
+	request->Data = _manifest[type.Name][id.str()];
+	_pending[id] = request;
+
+	auto decode = [request, func = type.Decoder]() {
+		auto start = std::chrono::high_resolution_clock::now();
+		request->Finalize = func(request->Data);
+		request->DecodeMs = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+		std::lock_guard<std::mutex> lock(_decodedLock);
+		_decoded.push_back(request);
+	};
+	if (JobSystem::IsInitialized()) {
+		JobSystem::Get().Run(decode, &request->DecodeCounter);
+	} else {
+		decode();
+	}
+
+	return request;
+}
+
+IResource::Sptr ResourceManager::_Wait(const std::shared_ptr<LoadRequest>& request) {
+	if (request->IsDone) {
+		return request->Result;
+	}
+
+	// The main thread runs other jobs while it waits, so this can't deadlock on our decode job
+	if (JobSystem::IsInitialized()) {
+		JobSystem::Get().Wait(request->DecodeCounter);
+	}
+
+	// Finalizing can load other resources, which may have finalized this request for us
+	if (!request->IsDone) {
+		{
+			std::lock_guard<std::mutex> lock(_decodedLock);
+			auto it = std::find(_decoded.begin(), _decoded.end(), request);
+			if (it != _decoded.end()) {
+				_decoded.erase(it);
+			}
+		}
+		_Finalize(request);
+	}
+	return request->Result;
+}
+
+void ResourceManager::_Finalize(const std::shared_ptr<LoadRequest>& request) {
+	// A request can only be finalized once, but it may have been waited on while it was still in the decoded queue
+	if (request->IsDone) return;
+
+	// The finalize function may be null if the decode failed
+	auto start = std::chrono::high_resolution_clock::now();
+	IResource::Sptr result = request->Finalize ? request->Finalize() : nullptr;
+	request->FinalizeMs = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+	if (result != nullptr) {
+		result->OverrideGUID(request->Id);
+		_resources.FindOrInsert(request->TypeId, request->Id).Resource = result;
+		_MarkUsed(result);
+	} else {
+		LOG_WARN("Failed to load resource {}", request->Id.str());
+	}
+
+	request->Result = result;
+	request->Finalize = nullptr;
+	request->IsDone = true;
+	_pending.erase(request->Id);
+}
+
+void ResourceManager::SetMemoryBudget(size_t bytes) {
+	_memoryStats.BudgetBytes = bytes;
+}
+
+void ResourceManager::UpdateResidency() {
+	_frameIndex++;
+
+	std::vector<ResourceTable::Entry*> candidates;
+	size_t cpuBytes = 0, gpuBytes = 0;
+	uint32_t residentCount = 0;
+	_resources.Each([&](ResourceTable::Entry& entry) {
+		if (entry.Resource == nullptr) return;
+
+		size_t cpu = entry.Resource->GetCpuMemoryUsage();
+		size_t gpu = entry.Resource->GetGpuMemoryUsage();
+		cpuBytes += cpu;
+		gpuBytes += gpu;
+		residentCount++;
+
+		// We can only evict resources that nothing else is holding on to, and that we can re-load from the manifest
+		if (cpu + gpu > 0 && entry.Resource.use_count() == 1 && entry.InManifest && !entry.KeepResident) {
+			candidates.push_back(&entry);
+		}
+	});
+
+	size_t budget = _memoryStats.BudgetBytes;
+	size_t total = cpuBytes + gpuBytes;
+	if (budget > 0 && total > budget && !candidates.empty()) {
+		// Evict the least recently used resources first, until we are back under budget
+		std::sort(candidates.begin(), candidates.end(), [](const ResourceTable::Entry* a, const ResourceTable::Entry* b) {
+			return a->Resource->_lastUsedFrame < b->Resource->_lastUsedFrame;
+		});
+
+		uint32_t evicted = 0;
+		for (ResourceTable::Entry* entry : candidates) {
+			if (cpuBytes + gpuBytes <= budget) break;
+
+			// The resource may have changed since it's JSON was stored, so we refresh the manifest first so that
+			// the edits are still there when it's re-loaded
+			if (!_RefreshManifestEntry(*entry)) {
+				entry->KeepResident = true;
+				continue;
+			}
+
+			cpuBytes -= entry->Resource->GetCpuMemoryUsage();
+			gpuBytes -= entry->Resource->GetGpuMemoryUsage();
+			// The entry stays in the table, so the next Get will load it from the manifest again
+			entry->Resource = nullptr;
+			evicted++;
+		}
+
+		residentCount -= evicted;
+		_memoryStats.EvictedCount += evicted;
+		LOG_INFO("Resources over budget ({} / {} bytes), evicted {} resources to free {} bytes", total, budget, evicted, total - (cpuBytes + gpuBytes));
+	}
+
+	_memoryStats.CpuBytes = cpuBytes;
+	_memoryStats.GpuBytes = gpuBytes;
+	_memoryStats.ResidentCount = residentCount;
+}
+
+bool ResourceManager::_RefreshManifestEntry(ResourceTable::Entry& entry) {
+	// Blobs are only written to the blob file when the manifest is saved, so we collect them in a scratch writer
+	// to find resources whose data only lives in the resource itself
+	BlobWriter scratch;
+	BlobWriter* saveWriter = _blobWriter;
+	_blobWriter = &scratch;
+	nlohmann::json blob = entry.Resource->ToJson();
+	_blobWriter = saveWriter;
+	if (scratch.Count > 0) {
+		return false;
+	}
+
+	blob["guid"] = entry.Resource->GetGUID().str();
+	RecordDependencies(blob);
+	_manifest[_types[entry.TypeId].Name][entry.Id.str()] = blob;
+	return true;
+}
+
+/// <summary>
+/// Appends a blob to the end of a blob file, and returns the offset that it was stored at
+/// </summary>
+static uint64_t AppendBlob(std::string& blobs, const char* data, size_t size) {
+	blobs.resize((blobs.size() + BlobAlignment - 1) / BlobAlignment * BlobAlignment, '\0');
+	uint64_t offset = blobs.size();
+	blobs.append(data, size);
+	return offset;
+}
+
+/// <summary>
+/// Copies the blobs referenced by a manifest entry from the old blob file into a new one, updating their offsets.
+/// Used for resources that are not loaded when the manifest is saved, since their JSON is not regenerated
+/// </summary>
+static void RelocateBlobs(nlohmann::ordered_json& data, std::string_view source, std::string& blobs, size_t& rawBytes) {
+	if (data.is_object() && data.contains("blob_offset")) {
+		uint64_t offset = data["blob_offset"];
+		uint64_t size = data["blob_size"];
+		if (offset + size > source.size()) {
+			LOG_WARN("Blob at offset {} is outside of the blob file, it will be lost", offset);
+			return;
+		}
+		data["blob_offset"] = AppendBlob(blobs, source.data() + offset, size);
+		rawBytes += data.contains("blob_raw_size") ? data["blob_raw_size"].get<uint64_t>() : size;
+	} else if (data.is_structured()) {
+		for (auto& item : data) {
+			RelocateBlobs(item, source, blobs, rawBytes);
+		}
 	}
 }
 
 void ResourceManager::SaveManifest(const std::string& path) {
+	auto start = std::chrono::high_resolution_clock::now();
+
+	// Resources write their binary data to our blob writer while we save
+	BlobWriter blobs;
+	_blobWriter = &blobs;
+
 	// Update all resources in the manifest so they match their current representation
-	for (auto& [type, map] : _resources) {
-		std::string typeName = StringTools::SanitizeClassName(type.name());
-		for (auto& [guid, res] : map) {
-			if (res != nullptr) {
-				_manifest[typeName][guid.str()] = res->ToJson();
-				_manifest[typeName][guid.str()]["guid"] = res->GetGUID().str();
-			}
+	_resources.Each([&](ResourceTable::Entry& entry) {
+		if (entry.Resource != nullptr) {
+			nlohmann::json blob = entry.Resource->ToJson();
+			blob["guid"] = entry.Resource->GetGUID().str();
+			RecordDependencies(blob);
+			_manifest[_types[entry.TypeId].Name][entry.Id.str()] = blob;
+			entry.InManifest = true;
+		}
+		// Resources that aren't loaded keep their old JSON, so we carry their blobs over to the new file
+		else if (entry.InManifest) {
+			RelocateBlobs(_manifest[_types[entry.TypeId].Name][entry.Id.str()], _blobs, blobs.Data, blobs.RawBytes);
 		}
+	});
+	_blobWriter = nullptr;
+
+	// The path we're given may be absolute (ex: from a file dialog), so the manifest only stores the blob file's
+	// name, which is resolved relative to the manifest when it's loaded
+	std::filesystem::path blobPath = std::filesystem::path(path).replace_extension(".blob");
+	if (!blobs.Data.empty()) {
+		_manifest["blob_file"] = blobPath.filename().generic_string();
+	} else {
+		_manifest.erase("blob_file");
 	}
-	FileHelpers::WriteContentsToFile(path, _manifest.dump(1,'\t'));
+	std::string contents = _manifest.dump(1, '\t');
+	FileHelpers::WriteContentsToFile(path, contents);
+
+	// The old blob file may be the one we're about to replace, so we need to unmap it first
+	_blobFile.Close();
+	_blobs = std::string_view();
+	if (!blobs.Data.empty()) {
+		std::ofstream blobFile(blobPath, std::ios::binary);
+		blobFile.write(blobs.Data.data(), blobs.Data.size());
+		blobFile.close();
+		if (!blobFile) {
+			LOG_WARN("Failed to write blob file \"{}\"", blobPath.string());
+		}
+	}
+	_MapBlobs(path);
+
+	double saveMs = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+	LOG_INFO("Saved manifest \"{}\" ({} bytes) and {} bytes of blobs in {:.2f}ms, embedding the blobs as Base64 would have added {} bytes to the manifest",
+		path, contents.size(), blobs.Data.size(), saveMs, (blobs.RawBytes + 2) / 3 * 4);
 }
 
-void ResourceManager::Cleanup() {
-	for (auto& [type, map] : _resources) {
-		map.clear();
+nlohmann::json ResourceManager::WriteBlob(const void* data, size_t size) {
+	// If we're not saving the manifest, there is no blob file to write to
+	if (_blobWriter == nullptr) {
+		return Base64::Encode(const_cast<void*>(data), size);
+	}
+
+	nlohmann::json result = nlohmann::json::object();
+	std::string compressed;
+	if (_compressBlobs) {
+		compressed = gzip::compress(static_cast<const char*>(data), size);
+	}
+
+	// Data like noise doesn't compress well, in which case we're better off storing it as-is
+	if (!compressed.empty() && compressed.size() < size) {
+		result["blob_offset"] = AppendBlob(_blobWriter->Data, compressed.data(), compressed.size());
+		result["blob_size"] = compressed.size();
+		result["blob_raw_size"] = size;
+		result["blob_compressed"] = true;
+	} else {
+		result["blob_offset"] = AppendBlob(_blobWriter->Data, static_cast<const char*>(data), size);
+		result["blob_size"] = size;
 	}
+	_blobWriter->Count++;
+	_blobWriter->RawBytes += size;
+	return result;
+}
+
+std::string_view ResourceManager::ReadBlob(const nlohmann::json& blob, std::string& storage) {
+	try {
+		// Manifests saved before we had blob files embed the data as Base64
+		if (blob.is_string()) {
+			storage = Base64::Decode(blob.get<std::string>());
+			return storage;
+		}
+
+		if (!blob.is_object() || !blob.contains("blob_offset")) {
+			return std::string_view();
+		}
+		uint64_t offset = blob["blob_offset"];
+		uint64_t size = blob["blob_size"];
+		if (offset + size > _blobs.size()) {
+			LOG_WARN("Blob at offset {} is outside of the blob file", offset);
+			return std::string_view();
+		}
+
+		std::string_view data = _blobs.substr(offset, size);
+		if (blob.contains("blob_compressed") && blob["blob_compressed"].get<bool>()) {
+			storage = gzip::decompress(data.data(), data.size());
+			return storage;
+		}
+		return data;
+	}
+	catch (std::runtime_error& e) {
+		LOG_WARN("Failed to read blob: {}", e.what());
+		return std::string_view();
+	}
+}
+
+void ResourceManager::_MapBlobs(const std::string& manifestPath) {
+	_blobFile.Close();
+	_blobs = std::string_view();
+
+	auto it = _manifest.find("blob_file");
+	if (it == _manifest.end() || !it->is_string()) return;
+
+	// Blob files are stored relative to the manifest (absolute paths are kept as-is by the path join)
+	std::string path = (std::filesystem::path(manifestPath).parent_path() / it->get<std::string>()).string();
+	// Older manifests stored the path relative to the working directory
+	if (!std::filesystem::exists(path) && std::filesystem::exists(it->get<std::string>())) {
+		path = it->get<std::string>();
+	}
+
+	// The blob file is always mapped from disk, never out of the asset archive, since the archive can be
+	// remounted (ex: when it's repacked) while we're still reading blobs from it
+	if (_blobFile.Open(path)) {
+		_blobs = _blobFile.View();
+	} else {
+		LOG_WARN("Failed to map blob file \"{}\", resources that store data in it will be empty", path);
+	}
+}
+
+void ResourceManager::Cleanup() {
+	_resources.Each([](ResourceTable::Entry& entry) {
+		entry.Resource = nullptr;
+	});
+	_blobFile.Close();
+	_blobs = std::string_view();
 }
 
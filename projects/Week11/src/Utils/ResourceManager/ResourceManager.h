@@ -2,18 +2,91 @@
 
 #include <json.hpp>
 #include <unordered_map>
-#include <typeindex>
+#include <atomic>
+#include <deque>
+#include <mutex>
+#include <string_view>
+#include <Logging.h>
 
 #include "Utils/GUID.hpp"
+#include "Utils/MappedFile.h"
 #include "Utils/ResourceManager/IResource.h"
+#include "Utils/ResourceManager/ResourceTable.h"
 #include "Utils/StringUtils.h"
+#include "Application/JobSystem.h"
 
 /// <summary>
 /// Utility class for managing and loading resources from JSON
 /// manifest files
 /// </summary>
 class ResourceManager {
+protected:
+	/// <summary>
+	/// Tracks a resource that is being loaded in the background (see LoadAsync)
+	/// </summary>
+	struct LoadRequest {
+		Guid                     Id;
+		uint32_t                 TypeId;
+		nlohmann::json           Data;
+		// Set by the worker thread once the CPU side of the load is done
+		IResource::FinalizeFunc  Finalize;
+		// Tracks the decode job, so we can wait on it if the resource is needed right away
+		JobSystem::Counter       DecodeCounter;
+		// Set on the main thread once the resource has been finalized
+		IResource::Sptr          Result;
+		std::atomic<bool>        IsDone;
+		// How long the decode and finalize steps took, used to report load times
+		double                   DecodeMs;
+		double                   FinalizeMs;
+
+		LoadRequest(const Guid& id, uint32_t typeId) :
+			Id(id), TypeId(typeId), Data(), Finalize(), DecodeCounter(), Result(nullptr), IsDone(false), DecodeMs(0.0), FinalizeMs(0.0) { }
+	};
+
 public:
+	/// <summary>
+	/// Memory usage of the resources that are currently loaded (see UpdateResidency)
+	/// </summary>
+	struct MemoryStats {
+		size_t   CpuBytes = 0;
+		size_t   GpuBytes = 0;
+		// The budget that we evict resources to stay under, 0 if there is no budget
+		size_t   BudgetBytes = 0;
+		uint32_t ResidentCount = 0;
+		// The total number of resources that have been evicted since startup
+		uint32_t EvictedCount = 0;
+	};
+
+	/// <summary>
+	/// A handle to a resource that is being loaded in the background
+	/// </summary>
+	/// <typeparam name="T">The type of resource being loaded</typeparam>
+	template <typename T>
+	class Future {
+	public:
+		Future() : _request(nullptr) { }
+
+		/// <summary>
+		/// Returns true if the resource has finished loading (or failed to load), and can be retrieved without waiting
+		/// </summary>
+		bool IsReady() const { return _request == nullptr || _request->IsDone.load(); }
+		/// <summary>
+		/// Gets the resource, finishing the load right away if it is not ready yet. Must be called from the main thread
+		/// unless IsReady returns true
+		/// </summary>
+		/// <returns>The loaded resource, or nullptr if it could not be loaded</returns>
+		std::shared_ptr<T> Get() const {
+			if (_request == nullptr) return nullptr;
+			return std::dynamic_pointer_cast<T>(ResourceManager::_Wait(_request));
+		}
+
+	private:
+		friend class ResourceManager;
+		std::shared_ptr<LoadRequest> _request;
+
+		Future(const std::shared_ptr<LoadRequest>& request) : _request(request) { }
+	};
+
 	/// <summary>
 	/// Initializes the resource manager and performs any first-time
 	/// setup required
@@ -30,51 +103,130 @@ public:
 	template <typename T, typename ... TArgs, typename = std::enable_if<is_valid_resource<T>()>::type>
 	static std::shared_ptr<T> CreateAsset(TArgs&&... args) {
 		// Create and store the asset
+		uint32_t typeId = _GetTypeId<T>();
 		std::shared_ptr<T> asset = std::make_shared<T>(std::forward<TArgs>(args)...);
-		_resources[std::type_index(typeid(T))][asset->IResource::GetGUID()] = asset;
+		ResourceTable::Entry& entry = _resources.FindOrInsert(typeId, asset->IResource::GetGUID());
+		entry.Resource = asset;
+		entry.InManifest = true;
 
 		// Get the JSON representation of the asset so we can store it in the manifest
 		nlohmann::json data = asset->ToJson();
 
-		// Make sure the data has the GUID
+		// Make sure the data has the GUID, and the resources it depends on
 		std::string guid = asset->IResource::GetGUID().str();
 		data["guid"] = guid;
+		RecordDependencies(data);
 
 		// Store the JSON data in the resource manifest (based on the type's name)
-		_manifest[StringTools::SanitizeClassName(typeid(T).name())][guid] = data;
+		_manifest[_types[typeId].Name][guid] = data;
 		return asset;
 	}
 
 	/// <summary>
 	/// Gets a shared pointer to the resource with the given type and GUID
+	/// 
+	/// Looking up a resource that has already been loaded does not modify the resource manager or allocate,
+	/// so it is safe to do from multiple threads at once (see PreloadManifest). Resources that still need to be
+	/// loaded must only be requested from the main thread, requesting them from any other thread logs an error
+	/// and returns nullptr rather than loading them (callers should preload their dependencies first)
 	/// </summary>
 	/// <typeparam name="T">The type of resource to retreive</typeparam>
 	/// <param name="id">The ID of the resource to retrieve</param>
 	/// <returns>The resource with the given GUID, or nullptr if none exists</returns>
 	template<typename T, typename = std::enable_if<is_valid_resource<T>()>::type>
 	static std::shared_ptr<T> Get(Guid id) {
-		// Try and grab the asset from the resource pool
-		std::shared_ptr<T> result =  std::dynamic_pointer_cast<T>(_resources[std::type_index(typeid(T))][id]);
+		// If the type has never been registered or created, there can't be any resources of that type
+		uint32_t typeId = _TypeIdOf<T>;
+		if (typeId == ResourceTable::InvalidTypeId) {
+			return nullptr;
+		}
 
-		// If the asset is null, we can try finding it in the manifest to load it
-		if (result == nullptr) {
-			// Get the type name it'll be stored under
-			std::string typeName = StringTools::SanitizeClassName(typeid(T).name());
+		// Every resource that is loaded or in the manifest has an entry, so a miss means it doesn't exist
+		const ResourceTable::Entry* entry = _resources.Find(typeId, id);
+		if (entry == nullptr) {
+			return nullptr;
+		}
 
-			// If the manifest has an entry, we can load it!
-			if (_manifest[typeName].contains(id)) {
-				// Invoke the loader function with the manifest data
-				_typeLoaders[typeName](_manifest[typeName][id]);
+		// The table is keyed by type, so the resource is guaranteed to be a T
+		if (entry->Resource != nullptr) {
+			_MarkUsed(entry->Resource);
+			return std::static_pointer_cast<T>(entry->Resource);
+		}
+
+		// Loading touches GL and modifies the manifest and pending loads, none of which is safe off the main thread
+		if (!_IsMainThread()) {
+			LOG_ERROR("Resource {} was requested from a worker thread before it was loaded, dependencies should be preloaded", id.str());
+			return nullptr;
+		}
 
-				// Search resources again to get the resource
-				return std::dynamic_pointer_cast<T>(_resources[std::type_index(typeid(T))][id]);
+		// If the asset is still loading in the background, we finish loading it now
+		auto pending = _pending.find(id);
+		if (pending != _pending.end()) {
+			return std::static_pointer_cast<T>(_Wait(pending->second));
+		}
+
+		// Otherwise we can load it from the manifest (this may have been evicted, or never loaded)
+		const TypeInfo& type = _types[typeId];
+		if (entry->InManifest && type.Loader) {
+			// Invoke the loader function with the manifest data
+			type.Loader(_manifest[type.Name][id.str()]);
+
+			// Search resources again to get the resource, loading may have moved our entry
+			entry = _resources.Find(typeId, id);
+			if (entry != nullptr && entry->Resource != nullptr) {
+				_MarkUsed(entry->Resource);
+				return std::static_pointer_cast<T>(entry->Resource);
 			}
 		}
 
-		// If result wasn't null, or couldn't be found in the manifest, return here
-		return result;
+		return nullptr;
+	}
+
+	/// <summary>
+	/// Starts loading a resource from the manifest in the background. Resources that support it (see
+	/// IResource::DecodeFromJson) do their file IO and decoding on worker threads, and are then finalized
+	/// on the main thread by ProcessPendingLoads. Other resources are loaded entirely in the finalize step.
+	/// Must be called from the main thread
+	/// </summary>
+	/// <typeparam name="T">The type of resource to load</typeparam>
+	/// <param name="id">The ID of the resource to load</param>
+	/// <returns>A handle to the resource, which will be ready immediately if the resource was already loaded</returns>
+	template<typename T, typename = std::enable_if<is_valid_resource<T>()>::type>
+	static Future<T> LoadAsync(Guid id) {
+		return Future<T>(_RequestLoad(_TypeIdOf<T>, id));
 	}
 
+	/// <summary>
+	/// Finalizes resources that have finished decoding in the background, stopping once the time budget has been
+	/// used up (at least one resource is always finalized if any are ready). Should be called once per frame from
+	/// the main thread
+	/// </summary>
+	/// <param name="budgetMs">The time in milliseconds that we are allowed to spend finalizing resources</param>
+	static void ProcessPendingLoads(double budgetMs);
+	/// <summary>
+	/// Returns the number of resources that have been requested with LoadAsync but have not been finalized yet
+	/// </summary>
+	static size_t PendingLoadCount() { return _pending.size(); }
+
+	/// <summary>
+	/// Sets the memory budget for loaded resources. When the resources use more memory than the budget,
+	/// resources that are not referenced by anything else are unloaded, starting with the least recently
+	/// used. Evicted resources are re-loaded from the manifest the next time they are requested, their manifest
+	/// entries are updated before they are evicted so that changes are not lost. Resources that store their data
+	/// inline (ex: generated textures) are never evicted
+	/// </summary>
+	/// <param name="bytes">The budget in bytes (CPU and GPU combined), or 0 for no budget</param>
+	static void SetMemoryBudget(size_t bytes);
+	/// <summary>
+	/// Gets the memory usage of loaded resources, as of the last call to UpdateResidency
+	/// </summary>
+	static const MemoryStats& GetMemoryStats() { return _memoryStats; }
+	/// <summary>
+	/// Measures the memory used by all loaded resources and evicts resources if we are over budget.
+	/// Should be called once per frame from the main thread
+	/// </summary>
+	static void UpdateResidency();
+
 	/// <summary>
 	/// Registers a resource type with the resource manager, only types that have been registered
 	/// can be loaded from JSON manifest files!
@@ -83,21 +235,36 @@ public:
 	/// <typeparam name=""></typeparam>
 	template <typename T, typename = std::enable_if<is_valid_resource<T>()>::type>
 	static void RegisterType() {
-		// Extract the type name from a sanitized version of they typeid name
-		std::string typeName = StringTools::SanitizeClassName(typeid(T).name());
+		// The type name is only worked out once here, lookups use the dense type ID
+		uint32_t typeId = _GetTypeId<T>();
+		TypeInfo& type = _types[typeId];
 
 		// Create the type loader for the type
-		_typeLoaders[typeName] = [](const nlohmann::json& data) {
+		type.Loader = [](const nlohmann::json& data) {
 			IResource::Sptr res = T::FromJson(data);
 			res->OverrideGUID(Guid(data["guid"]));
-			_resources[std::type_index(typeid(T))][res->GetGUID()] = res;
+			_resources.FindOrInsert(_TypeIdOf<T>, res->GetGUID()).Resource = res;
 			return res->GetGUID();
 		};
 
+		// Resources that can decode on worker threads split their load, everything else is loaded in the finalize step
+		if constexpr (test_decode<T, const nlohmann::json&>::value) {
+			type.Decoder = [](const nlohmann::json& data) {
+				return T::DecodeFromJson(data);
+			};
+		} else {
+			type.Decoder = [](const nlohmann::json& data) {
+				return IResource::FinalizeFunc([data]() -> IResource::Sptr { return T::FromJson(data); });
+			};
+		}
+
 		// Make sure we haven't registered the type yet, then add an empty object
 		// to the manifest to ensure it can be saved
-		if (!_manifest.contains(typeName)) {
-			_manifest[typeName] = nlohmann::json();
+		if (!_manifest.contains(type.Name)) {
+			_manifest[type.Name] = nlohmann::json();
+		} else {
+			// The manifest was loaded before the type was registered, so we need to add it's entries to the table
+			_IndexManifest(typeId);
 		}
 	}
 
@@ -112,17 +279,20 @@ public:
 		typename = typename std::enable_if<std::is_base_of<IResource, ResourceType>::value>::type>
 		static void Each(std::function<void(const std::shared_ptr<ResourceType>&)> callback, bool includeDisabled = false) {
 
-		// We can use typeid and type_index to get a unique ID for our types
-		std::type_index type = std::type_index(typeid(ResourceType));
+		// Types that have never been registered or created can't have any resources
+		uint32_t typeId = _TypeIdOf<ResourceType>;
+		if (typeId == ResourceTable::InvalidTypeId) {
+			return;
+		}
 
 		// Iterate over all the resources in the store
-		for (auto& [key, value] : _resources[type]) {
-			// If the pointer is alive and matches our enabled criteria, invoke the callback
-			if (value != nullptr) {
+		_resources.Each([&](ResourceTable::Entry& entry) {
+			// If the pointer is alive and matches our type, invoke the callback
+			if (entry.TypeId == typeId && entry.Resource != nullptr) {
 				// Upcast to resource type and invoke the callback
-				callback(std::dynamic_pointer_cast<ResourceType>(value));
+				callback(std::dynamic_pointer_cast<ResourceType>(entry.Resource));
 			}
-		}
+		});
 	}
 
 	/// <summary>
@@ -137,11 +307,71 @@ public:
 	/// <param name="preloadAssets">True if all assets should be loaded into memory</param>
 	static void LoadManifest(const std::string& path, bool preloadAssets = false);
 	/// <summary>
-	/// Saves the manifest to the given JSON file
+	/// Loads all the assets in the current manifest that have not been loaded yet (see PreloadDependencies)
+	/// </summary>
+	static void PreloadManifest();
+	/// <summary>
+	/// Loads the given resources and everything they depend on, if they have not been loaded yet. Scenes do this
+	/// before constructing their objects on worker threads, since loading resources is not thread safe (and
+	/// most resources need the OpenGL context on the main thread)
+	///
+	/// The resources are sorted so that every resource comes after it's dependencies, and all of them are
+	/// decoded in parallel on the job system in that order. They are then finalized on the calling thread in
+	/// the same order, so finalizing a resource never has to stop and load one of it's dependencies
+	/// </summary>
+	/// <param name="resources">The GUIDs of the resources to load</param>
+	static void PreloadDependencies(const std::vector<Guid>& resources);
+
+	/// <summary>
+	/// Finds the resources that are referenced by a block of JSON (such as a manifest entry or a scene), by
+	/// searching it for strings that are the GUID of a resource in the manifest. The top level "guid" and
+	/// "dependencies" fields are skipped
+	/// </summary>
+	/// <param name="data">The JSON to search</param>
+	/// <returns>The GUIDs of the referenced resources, without duplicates</returns>
+	static std::vector<Guid> FindDependencies(const nlohmann::json& data);
+	/// <summary>
+	/// Finds the resources referenced by a block of JSON, and stores them in it's "dependencies" field
+	/// so that they don't need to be searched for when it is loaded
+	/// </summary>
+	static void RecordDependencies(nlohmann::json& data);
+	/// <summary>
+	/// Gets the resources that a block of JSON depends on, using it's "dependencies" field if it has one,
+	/// and searching the JSON otherwise (for files saved before dependencies were recorded)
+	/// </summary>
+	static std::vector<Guid> GetDependencies(const nlohmann::json& data);
+	/// <summary>
+	/// Saves the manifest to the given JSON file. Any blobs that resources store (see WriteBlob) are written to a
+	/// binary file next to it, with the same name and the .blob extension (the manifest refers to it by a path relative
+	/// to the manifest)
 	/// </summary>
 	/// <param name="path">The path to the file to output</param>
 	static void SaveManifest(const std::string& path);
 
+	/// <summary>
+	/// Stores a block of binary data for a resource's ToJson, such as the texels of a generated texture. While the
+	/// manifest is being saved, the data is written to the manifest's blob file and the result references it by offset
+	/// and size, so the manifest doesn't have to hold (and parse) large Base64 strings. Outside of SaveManifest, the
+	/// data is embedded as a Base64 string instead
+	/// </summary>
+	/// <param name="data">The data to store</param>
+	/// <param name="size">The size of the data in bytes</param>
+	/// <returns>The JSON to store in place of the data, which can be passed to ReadBlob</returns>
+	static nlohmann::json WriteBlob(const void* data, size_t size);
+	/// <summary>
+	/// Gets the data that was stored with WriteBlob. Uncompressed blobs are returned as a view into the memory mapped
+	/// blob file, so they can be uploaded without any copies. Compressed and Base64 data is decoded into storage
+	/// </summary>
+	/// <param name="blob">The JSON that was returned by WriteBlob</param>
+	/// <param name="storage">Holds the data if it needs to be decoded, must outlive the returned view</param>
+	/// <returns>A view of the data, with a null data pointer if it could not be read</returns>
+	static std::string_view ReadBlob(const nlohmann::json& blob, std::string& storage);
+	/// <summary>
+	/// Sets whether blobs are gzip compressed when the manifest is saved. Compressed blobs take less space on disk,
+	/// but need to be decompressed before they can be used. Blobs that do not get smaller are always stored uncompressed
+	/// </summary>
+	static void SetBlobCompression(bool compress) { _compressBlobs = compress; }
+
 	/// <summary>
 	/// Releases all resources held by the resource manager
 	/// </summary>
@@ -149,19 +379,136 @@ public:
 
 protected:
 	/// <summary>
-	/// This is a map of maps
-	/// The top level map uses type_index, so there's a map per resource type
-	/// The inner map handles mapping GUIDs to the corresponding resource
+	/// Stores the information about a resource type, indexed by the type's dense ID
+	/// </summary>
+	struct TypeInfo {
+		// The sanitized class name, used as the type's key in the manifest
+		std::string Name;
+		// Loads a resource from it's manifest entry and stores it, null if the type was never registered
+		std::function<Guid(const nlohmann::json&)> Loader;
+		// Decodes a resource from it's manifest entry in the background (see LoadAsync)
+		std::function<IResource::FinalizeFunc(const nlohmann::json&)> Decoder;
+	};
+
+	/// <summary>
+	/// Stores all resources by their type ID and GUID, along with entries for everything in
+	/// the manifest that has not been loaded yet
 	/// </summary>
-	static std::map<std::type_index, std::map<Guid, IResource::Sptr>> _resources;
+	static ResourceTable _resources;
 	/// <summary>
-	/// This map stores registered types, so we can load them from JSON files
+	/// Stores the types that have been registered (or created with CreateAsset), indexed by type ID
 	/// </summary>
-	static std::map<std::string, std::function<Guid(const nlohmann::json&)>> _typeLoaders;
+	static std::vector<TypeInfo> _types;
+	// Maps type names (as used in the manifest) to their type IDs
+	static std::unordered_map<std::string, uint32_t> _typeNameMap;
+	// Per-type storage for the dense type ID, so that lookups don't need to touch the type's name
+	template <typename T>
+	inline static uint32_t _TypeIdOf = ResourceTable::InvalidTypeId;
 
 	/// <summary>
 	/// We use an ORDERED JSON file to allow serializing types in the order they are registered.
 	/// This allows us to register dependencies before the dependent resource
 	/// </summary>
 	static nlohmann::ordered_json _manifest;
+
+	// Resources that have been requested with LoadAsync but have not been finalized, only accessed from the main thread
+	static std::map<Guid, std::shared_ptr<LoadRequest>> _pending;
+	// Requests that have finished decoding and are waiting to be finalized, in the order they finished
+	static std::mutex _decodedLock;
+	static std::deque<std::shared_ptr<LoadRequest>> _decoded;
+
+	// Incremented by UpdateResidency, and stamped on resources when they are requested
+	static uint64_t _frameIndex;
+	static MemoryStats _memoryStats;
+
+	/// <summary>
+	/// Collects the blobs that are written while the manifest is being saved
+	/// </summary>
+	struct BlobWriter {
+		std::string Data;
+		size_t      Count = 0;
+		// The size of the blobs before compression, used to report how much we saved over Base64
+		size_t      RawBytes = 0;
+	};
+	// The current manifest's blob file, and a view of it's contents
+	static MappedFile _blobFile;
+	static std::string_view _blobs;
+	// Only set while SaveManifest is running, so that WriteBlob knows where the data goes
+	static BlobWriter* _blobWriter;
+	static bool _compressBlobs;
+
+	/// <summary>
+	/// Records that a resource has been used this frame. Resources may be requested from worker threads
+	/// while scenes are loading, so only the main thread updates the timestamp
+	/// </summary>
+	static void _MarkUsed(const IResource::Sptr& resource) {
+		if (resource != nullptr && _IsMainThread()) {
+			resource->_lastUsedFrame = _frameIndex;
+		}
+	}
+
+	/// <summary>
+	/// Returns true if we are on the main thread, or if the job system is not running (in which case there is
+	/// only the main thread)
+	/// </summary>
+	static bool _IsMainThread() {
+		return !JobSystem::IsInitialized() || JobSystem::Get().IsMainThread();
+	}
+
+	/// <summary>
+	/// Gets the dense type ID for a resource type, assigning it the next ID if it does not have one yet
+	/// </summary>
+	template <typename T>
+	static uint32_t _GetTypeId() {
+		if (_TypeIdOf<T> == ResourceTable::InvalidTypeId) {
+			_TypeIdOf<T> = _AddType(StringTools::SanitizeClassName(typeid(T).name()));
+		}
+		return _TypeIdOf<T>;
+	}
+	/// <summary>
+	/// Adds a new type with the given name, and returns it's dense type ID
+	/// </summary>
+	static uint32_t _AddType(const std::string& typeName);
+	/// <summary>
+	/// Adds entries to the resource table for all the manifest's resources of the given type
+	/// </summary>
+	static void _IndexManifest(uint32_t typeId);
+	/// <summary>
+	/// Finds the type of the resource with the given GUID, if it is loaded or in the manifest
+	/// </summary>
+	/// <returns>The resource's type ID, or InvalidTypeId if the resource does not exist</returns>
+	static uint32_t _FindTypeId(const Guid& id);
+	/// <summary>
+	/// Implementation for GetDependencies and FindDependencies, which also works with the manifest's ordered JSON
+	/// </summary>
+	/// <param name="useRecorded">True to use the "dependencies" field if there is one, false to always search the JSON</param>
+	template <typename JsonType>
+	static std::vector<Guid> _GetDependencies(const JsonType& data, bool useRecorded);
+
+	/// <summary>
+	/// Starts loading the resource with the given type and ID, or returns the existing request if it is
+	/// already loading. Requests for resources that are already loaded (or do not exist) are returned as done
+	/// </summary>
+	static std::shared_ptr<LoadRequest> _RequestLoad(uint32_t typeId, const Guid& id);
+	/// <summary>
+	/// Waits for a request to finish decoding, then finalizes it if it has not been already
+	/// </summary>
+	static IResource::Sptr _Wait(const std::shared_ptr<LoadRequest>& request);
+	/// <summary>
+	/// Creates the resource for a decoded request and adds it to the resource pool
+	/// </summary>
+	static void _Finalize(const std::shared_ptr<LoadRequest>& request);
+	/// <summary>
+	/// Updates a loaded resource's manifest entry to match it's current state, so that it can be evicted and
+	/// re-loaded without losing any changes made to it
+	/// </summary>
+	/// <param name="entry">The entry to refresh, must have a loaded resource</param>
+	/// <returns>False if the resource stores blobs, which would have to be kept in memory (so it should not be evicted)</returns>
+	static bool _RefreshManifestEntry(ResourceTable::Entry& entry);
+	/// <summary>
+	/// Maps the blob file for the current manifest from disk, if it has one. The manifest stores the blob file's
+	/// path relative to itself, so it can be moved along with the manifest
+	/// </summary>
+	/// <param name="manifestPath">The path of the manifest that was loaded or saved</param>
+	static void _MapBlobs(const std::string& manifestPath);
 };
\ No newline at end of file
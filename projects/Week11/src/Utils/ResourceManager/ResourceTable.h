@@ -0,0 +1,131 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+
+#include "Utils/GUID.hpp"
+#include "Utils/ResourceManager/IResource.h"
+
+/// <summary>
+/// A flat, open addressed hash table that stores resources by their type ID and GUID, used by the
+/// resource manager. Lookups do not allocate or modify the table, so they are safe to make from
+/// multiple threads as long as nothing is being inserted at the same time.
+///
+/// Entries are never removed individually, instead their resource is set to null. Entries that have
+/// no resource and are not in the manifest are dropped the next time the table grows
+/// </summary>
+class ResourceTable {
+public:
+	static constexpr uint32_t InvalidTypeId = ~0u;
+
+	struct Entry {
+		// The dense type ID of the resource, or InvalidTypeId if the slot is empty
+		uint32_t        TypeId = InvalidTypeId;
+		// True if the resource has an entry in the manifest, and can be loaded (or re-loaded) from it
+		bool            InManifest = false;
+		// True if the resource stores it's data inline in the manifest (ex: generated textures), so evicting it
+		// would mean keeping a copy of that data around anyways
+		bool            KeepResident = false;
+		Guid            Id;
+		// The loaded resource, or null if the resource has not been loaded (or was evicted)
+		IResource::Sptr Resource;
+	};
+
+	ResourceTable() : _entries(), _count(0) { }
+
+	/// <summary>
+	/// Finds the entry with the given type and ID, without inserting anything
+	/// </summary>
+	/// <returns>The entry, or nullptr if there is no entry with the given type and ID</returns>
+	Entry* Find(uint32_t typeId, const Guid& id) {
+		return const_cast<Entry*>(static_cast<const ResourceTable*>(this)->Find(typeId, id));
+	}
+	const Entry* Find(uint32_t typeId, const Guid& id) const {
+		if (_entries.empty()) return nullptr;
+
+		size_t mask = _entries.size() - 1;
+		for (size_t ix = _Hash(typeId, id) & mask; ; ix = (ix + 1) & mask) {
+			const Entry& entry = _entries[ix];
+			if (entry.TypeId == InvalidTypeId) return nullptr;
+			if (entry.TypeId == typeId && entry.Id == id) return &entry;
+		}
+	}
+
+	/// <summary>
+	/// Finds the entry with the given type and ID, adding an empty one if it does not exist. Note
+	/// that inserting may move existing entries, invalidating any pointers to them
+	/// </summary>
+	Entry& FindOrInsert(uint32_t typeId, const Guid& id) {
+		// Keep the table at most 3/4 full so that probe sequences stay short
+		if ((_count + 1) * 4 > _entries.size() * 3) {
+			_Rehash(_entries.size() < 64 ? 64 : _entries.size() * 2);
+		}
+
+		size_t mask = _entries.size() - 1;
+		for (size_t ix = _Hash(typeId, id) & mask; ; ix = (ix + 1) & mask) {
+			Entry& entry = _entries[ix];
+			if (entry.TypeId == InvalidTypeId) {
+				entry.TypeId = typeId;
+				entry.Id = id;
+				_count++;
+				return entry;
+			}
+			if (entry.TypeId == typeId && entry.Id == id) return entry;
+		}
+	}
+
+	/// <summary>
+	/// Invokes a function for every entry in the table, in no particular order. The callback must not
+	/// insert into the table
+	/// </summary>
+	template <typename Func>
+	void Each(Func&& callback) {
+		for (Entry& entry : _entries) {
+			if (entry.TypeId != InvalidTypeId) {
+				callback(entry);
+			}
+		}
+	}
+
+	/// <summary>
+	/// Gets the number of entries in the table, including those that have not been loaded
+	/// </summary>
+	size_t Size() const { return _count; }
+
+	/// <summary>
+	/// Removes all entries from the table
+	/// </summary>
+	void Clear() {
+		_entries.clear();
+		_count = 0;
+	}
+
+private:
+	// Always a power of two in size (or empty), so we can mask instead of using modulo
+	std::vector<Entry> _entries;
+	size_t             _count;
+
+	static size_t _Hash(uint32_t typeId, const Guid& id) {
+		// GUIDs are random, so we can mix the type in with a single multiply
+		return std::hash<Guid>()(id) ^ (static_cast<size_t>(typeId) * 0x9E3779B97F4A7C15ull);
+	}
+
+	void _Rehash(size_t capacity) {
+		std::vector<Entry> old;
+		old.swap(_entries);
+		_entries.resize(capacity);
+		_count = 0;
+
+		for (Entry& entry : old) {
+			// Entries that can't be loaded and have nothing loaded are no longer needed
+			if (entry.TypeId == InvalidTypeId || (entry.Resource == nullptr && !entry.InManifest)) continue;
+
+			size_t mask = _entries.size() - 1;
+			size_t ix = _Hash(entry.TypeId, entry.Id) & mask;
+			while (_entries[ix].TypeId != InvalidTypeId) {
+				ix = (ix + 1) & mask;
+			}
+			_entries[ix] = std::move(entry);
+			_count++;
+		}
+	}
+};
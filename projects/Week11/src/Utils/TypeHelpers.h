@@ -11,4 +11,54 @@ namespace detail {
 } // detail::
 
 template<class T, class Arg>
-struct test_json : decltype(detail::test_json<T, Arg>(0)){};
\ No newline at end of file
+struct test_json : decltype(detail::test_json<T, Arg>(0)){};
+
+namespace detail {
+	template<class T>
+	static auto test_update_traits(int)->sfinae_true<decltype(T::GetUpdateTraits())>;
+	template<class>
+	static auto test_update_traits(long)->std::false_type;
+} // detail::
+
+template<class T>
+struct test_update_traits : decltype(detail::test_update_traits<T>(0)){};
+
+namespace detail {
+	template<class T, class A0>
+	static auto test_binary(int)->sfinae_true<decltype(T::FromBinary(std::declval<A0>()))>;
+	template<class, class A0>
+	static auto test_binary(long)->std::false_type;
+} // detail::
+
+template<class T, class Arg>
+struct test_binary : decltype(detail::test_binary<T, Arg>(0)){};
+
+namespace detail {
+	template<class T, class A0>
+	static auto test_decode(int)->sfinae_true<decltype(T::DecodeFromJson(std::declval<A0>()))>;
+	template<class, class A0>
+	static auto test_decode(long)->std::false_type;
+} // detail::
+
+template<class T, class Arg>
+struct test_decode : decltype(detail::test_decode<T, Arg>(0)){};
+
+namespace detail {
+	template<class T, class A0>
+	static auto test_dependencies(int)->sfinae_true<decltype(std::declval<const T&>().GetDependencies(std::declval<A0>()))>;
+	template<class, class A0>
+	static auto test_dependencies(long)->std::false_type;
+} // detail::
+
+template<class T, class Arg>
+struct test_dependencies : decltype(detail::test_dependencies<T, Arg>(0)){};
+
+namespace detail {
+	template<class T, class A0>
+	static auto test_binary_to_json(int)->sfinae_true<decltype(T::BinaryToJson(std::declval<A0>()))>;
+	template<class, class A0>
+	static auto test_binary_to_json(long)->std::false_type;
+} // detail::
+
+template<class T, class Arg>
+struct test_binary_to_json : decltype(detail::test_binary_to_json<T, Arg>(0)){};
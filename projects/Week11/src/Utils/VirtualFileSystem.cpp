@@ -0,0 +1,319 @@
+#include "Utils/VirtualFileSystem.h"
+
+#include <atomic>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <unordered_map>
+#include <unordered_set>
+
+#include <json.hpp>
+#include "Logging.h"
+#include "Utils/FileHelpers.h"
+#include "Utils/MappedFile.h"
+#include "Utils/StringUtils.h"
+
+// Identifies archive files, stored at the very start of the file
+static const char ArchiveMagic[4] = { 'P', 'A', 'K', 'A' };
+static const uint32_t ArchiveVersion = 1;
+
+// Stored at the start of the archive. The table of contents goes at the end of the file, so that it
+// can be written once we know where all the files ended up
+struct ArchiveHeader {
+	char     Magic[4];
+	uint32_t Version;
+	uint64_t FileCount;
+	uint64_t TocOffset;
+	uint64_t TocSize;
+};
+
+// An entry in the table of contents, followed by PathLength bytes for the file's normalized path
+struct ArchiveEntry {
+	uint64_t Offset;
+	uint64_t Size;
+	uint64_t PathLength;
+};
+
+// A file in the mounted archive
+struct PackedFile {
+	std::string_view  Data;
+	// Set when the loose copy of the file is newer than the packed one, so that it's read from disk instead
+	std::atomic<bool> IsStale = false;
+};
+
+// The archive that is currently mounted, views into Data are handed out to loaders
+struct MountedArchive {
+	std::string Path;
+	MappedFile  File;
+	const char* Data = nullptr;
+	size_t      Size = 0;
+	// The table is only changed by Mount and Unmount, so it can be searched from any thread
+	std::unordered_map<std::string, PackedFile> Files;
+};
+static MountedArchive Archive;
+
+/// <summary>
+/// Reads a file straight from disk, since FileHelpers::ReadFile would give us the copy in the mounted archive
+/// </summary>
+static bool ReadDiskFile(const std::string& path, std::string& result) {
+	std::ifstream in(path, std::ios::binary | std::ios::ate);
+	if (!in) {
+		return false;
+	}
+	result.resize(static_cast<size_t>(in.tellg()));
+	in.seekg(0, std::ios::beg);
+	return result.empty() || static_cast<bool>(in.read(&result[0], result.size()));
+}
+
+bool VirtualFileSystem::Mount(const std::string& archivePath) {
+	Unmount();
+
+	if (!Archive.File.Open(archivePath)) {
+		LOG_WARN("Failed to map asset archive \"{}\"", archivePath);
+		return false;
+	}
+	Archive.Data = Archive.File.View().data();
+	Archive.Size = Archive.File.View().size();
+	Archive.Path = archivePath;
+
+	// Validate the header before we trust any of the offsets in the file
+	ArchiveHeader header;
+	if (Archive.Size < sizeof(ArchiveHeader)) {
+		LOG_WARN("\"{}\" is not an asset archive", archivePath);
+		Unmount();
+		return false;
+	}
+	memcpy(&header, Archive.Data, sizeof(ArchiveHeader));
+	if (memcmp(header.Magic, ArchiveMagic, sizeof(ArchiveMagic)) != 0 || header.Version != ArchiveVersion) {
+		LOG_WARN("\"{}\" is not a version {} asset archive", archivePath, ArchiveVersion);
+		Unmount();
+		return false;
+	}
+
+	// Build the lookup table from the table of contents, the file data itself is never copied
+	const char* cursor = Archive.Data + header.TocOffset;
+	const char* end = cursor + header.TocSize;
+	bool isValid = header.TocOffset + header.TocSize <= Archive.Size;
+	Archive.Files.reserve(header.FileCount);
+	for (uint64_t ix = 0; isValid && ix < header.FileCount; ix++) {
+		ArchiveEntry entry;
+		isValid = cursor + sizeof(ArchiveEntry) <= end;
+		if (!isValid) break;
+		memcpy(&entry, cursor, sizeof(ArchiveEntry));
+		cursor += sizeof(ArchiveEntry);
+
+		isValid = entry.PathLength <= static_cast<uint64_t>(end - cursor) && entry.Offset + entry.Size <= header.TocOffset;
+		if (!isValid) break;
+		Archive.Files[std::string(cursor, entry.PathLength)].Data = std::string_view(Archive.Data + entry.Offset, entry.Size);
+		cursor += entry.PathLength;
+	}
+	if (!isValid) {
+		LOG_WARN("Asset archive \"{}\" is corrupt", archivePath);
+		Unmount();
+		return false;
+	}
+
+	// Files that have been edited since the archive was written take priority over their packed copies. We check
+	// this once here, so that looking up a file never has to touch the disk, and MarkModified handles the files
+	// that get written while the archive is mounted
+	std::error_code timeError;
+	std::filesystem::file_time_type archiveTime = std::filesystem::last_write_time(archivePath, timeError);
+	size_t staleCount = 0;
+	for (auto& [path, file] : Archive.Files) {
+		std::error_code error;
+		std::filesystem::file_time_type looseTime = std::filesystem::last_write_time(path, error);
+		if (!error && looseTime > archiveTime) {
+			file.IsStale = true;
+			staleCount++;
+		}
+	}
+	if (staleCount > 0) {
+		LOG_INFO("{} files are newer on disk than in \"{}\", and will be loaded from disk", staleCount, archivePath);
+	}
+
+	LOG_INFO("Mounted asset archive \"{}\" ({} files, {} bytes)", archivePath, Archive.Files.size(), Archive.Size);
+	return true;
+}
+
+void VirtualFileSystem::Unmount() {
+	Archive.File.Close();
+	Archive.Data = nullptr;
+	Archive.Size = 0;
+	Archive.Path.clear();
+	Archive.Files.clear();
+}
+
+bool VirtualFileSystem::IsMounted() {
+	return Archive.Data != nullptr;
+}
+
+std::string_view VirtualFileSystem::GetView(const std::string& path) {
+	if (Archive.Data == nullptr) {
+		return std::string_view();
+	}
+	auto it = Archive.Files.find(_NormalizePath(path));
+	if (it == Archive.Files.end() || it->second.IsStale) {
+		return std::string_view();
+	}
+	return it->second.Data;
+}
+
+void VirtualFileSystem::MarkModified(const std::string& path) {
+	if (Archive.Data == nullptr) {
+		return;
+	}
+	auto it = Archive.Files.find(_NormalizePath(path));
+	if (it != Archive.Files.end()) {
+		it->second.IsStale = true;
+	}
+}
+
+bool VirtualFileSystem::Exists(const std::string& path) {
+	return GetView(path).data() != nullptr || std::filesystem::exists(path);
+}
+
+bool VirtualFileSystem::Pack(const std::string& archivePath, const std::vector<std::string>& files) {
+	// We write to a temporary file and swap it in at the end, since the archive may be mounted right now
+	std::string tempPath = archivePath + ".tmp";
+	std::ofstream out(tempPath, std::ios::binary);
+	if (!out) {
+		LOG_WARN("Failed to open \"{}\" for writing", tempPath);
+		return false;
+	}
+
+	ArchiveHeader header = ArchiveHeader();
+	memcpy(header.Magic, ArchiveMagic, sizeof(ArchiveMagic));
+	header.Version = ArchiveVersion;
+	out.write(reinterpret_cast<const char*>(&header), sizeof(ArchiveHeader));
+
+	std::vector<std::pair<std::string, ArchiveEntry>> toc;
+	std::unordered_set<std::string> packed;
+	std::string contents;
+	const char padding[DataAlignment] = { 0 };
+	for (const std::string& file : files) {
+		std::string path = _NormalizePath(file);
+		if (!packed.insert(path).second) continue;
+
+		if (!ReadDiskFile(file, contents)) {
+			LOG_WARN("Failed to read \"{}\", it will not be packed", file);
+			continue;
+		}
+
+		// Align the start of every file, so that loaders can use the data in place
+		uint64_t offset = static_cast<uint64_t>(out.tellp());
+		uint64_t alignment = (DataAlignment - (offset % DataAlignment)) % DataAlignment;
+		out.write(padding, alignment);
+
+		ArchiveEntry entry;
+		entry.Offset = offset + alignment;
+		entry.Size = contents.size();
+		entry.PathLength = path.size();
+		out.write(contents.data(), contents.size());
+		toc.emplace_back(path, entry);
+	}
+
+	header.FileCount = toc.size();
+	header.TocOffset = static_cast<uint64_t>(out.tellp());
+	for (const auto& [path, entry] : toc) {
+		out.write(reinterpret_cast<const char*>(&entry), sizeof(ArchiveEntry));
+		out.write(path.data(), path.size());
+	}
+	header.TocSize = static_cast<uint64_t>(out.tellp()) - header.TocOffset;
+
+	// Now that we know where the table of contents is, we can fill in the header
+	out.seekp(0);
+	out.write(reinterpret_cast<const char*>(&header), sizeof(ArchiveHeader));
+	out.close();
+	if (!out) {
+		LOG_WARN("Failed to write asset archive \"{}\"", tempPath);
+		return false;
+	}
+
+	// We can't replace a file that is mapped on windows, so if we're replacing the mounted archive we
+	// unmount it first, then mount whichever archive ends up at the path
+	std::error_code error;
+	bool wasMounted = IsMounted() && std::filesystem::equivalent(Archive.Path, archivePath, error);
+	if (wasMounted) {
+		Unmount();
+	}
+
+	std::filesystem::rename(tempPath, archivePath, error);
+	bool isReplaced = !error;
+	if (!isReplaced) {
+		LOG_WARN("Failed to replace \"{}\" ({}), the new archive is at \"{}\"", archivePath, error.message(), tempPath);
+	}
+	if (wasMounted) {
+		Mount(archivePath);
+	}
+	if (!isReplaced) {
+		return false;
+	}
+
+	LOG_INFO("Packed {} files into \"{}\" ({} bytes)", toc.size(), archivePath, std::filesystem::file_size(archivePath));
+	return true;
+}
+
+bool VirtualFileSystem::PackManifest(const std::string& archivePath, const std::string& manifestPath) {
+	std::string contents;
+	if (!ReadDiskFile(manifestPath, contents)) {
+		LOG_WARN("Failed to read manifest \"{}\"", manifestPath);
+		return false;
+	}
+	nlohmann::json manifest = nlohmann::json::parse(contents);
+
+	std::vector<std::string> files = { manifestPath };
+	std::unordered_set<std::string> visited;
+	std::function<void(const std::string&)> addFile = [&](const std::string& file) {
+		if (!visited.insert(_NormalizePath(file)).second) return;
+		files.push_back(file);
+
+		std::filesystem::path path(file);
+		std::string extension = path.extension().string();
+		StringTools::ToLower(extension);
+
+		// The optimized OBJ loader prefers the converted binary mesh, so we want that as well
+		if (extension == ".obj") {
+			std::filesystem::path binary = path;
+			binary.replace_extension(".bin");
+			if (std::filesystem::is_regular_file(binary)) {
+				addFile(binary.string());
+			}
+		}
+		// Shaders need the files that they include
+		else if (extension == ".glsl") {
+			for (const std::string& include : FileHelpers::FindIncludes(file)) {
+				addFile(include);
+			}
+		}
+	};
+
+	// Resources store the paths to their files in different fields, so we look for any string that is a file
+	std::function<void(const nlohmann::json&)> search = [&](const nlohmann::json& blob) {
+		if (blob.is_string()) {
+			const std::string& value = blob.get_ref<const std::string&>();
+			if (value.find('.') != std::string::npos && std::filesystem::is_regular_file(value)) {
+				addFile(value);
+			}
+		} else if (blob.is_structured()) {
+			for (const auto& item : blob) {
+				search(item);
+			}
+		}
+	};
+	// The resource manager maps the blob file from disk itself, so there's no point packing it
+	manifest.erase("blob_file");
+	search(manifest);
+
+	return Pack(archivePath, files);
+}
+
+std::string VirtualFileSystem::_NormalizePath(const std::string& path) {
+	std::filesystem::path result = std::filesystem::path(path).lexically_normal();
+	if (result.is_absolute()) {
+		result = result.lexically_proximate(std::filesystem::current_path());
+	}
+	std::string normalized = result.generic_string();
+	StringTools::ToLower(normalized);
+	return normalized;
+}
@@ -0,0 +1,87 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/// <summary>
+/// Serves asset files out of a single packed archive that is memory mapped, rather than opening and
+/// reading each loose file separately. Files that are not in the archive (or when no archive is mounted)
+/// are read from disk as usual, so loaders should use GetView first and fall back to the file system.
+///
+/// Archives are made with Pack or PackManifest, and store every file aligned to DataAlignment bytes,
+/// followed by a table of contents that maps normalized paths to the file data. Views into the archive
+/// stay valid until the archive is unmounted, and are safe to read from any thread
+///
+/// Loose files that have been modified since the archive was written (ex: manifests and scenes saved by
+/// the editor, or edited shaders) take priority over their packed copies. This is checked once when the
+/// archive is mounted, files written after that must be reported with MarkModified
+/// </summary>
+class VirtualFileSystem {
+public:
+	VirtualFileSystem() = delete;
+
+	// The alignment of every file's data within an archive
+	static constexpr size_t DataAlignment = 64;
+
+	/// <summary>
+	/// Memory maps an archive, and serves the files within it until Unmount is called. Only one archive
+	/// can be mounted at a time, and this should only be called from the main thread while no assets are loading
+	/// </summary>
+	/// <param name="archivePath">The path to the archive to mount</param>
+	/// <returns>True if the archive was mounted, false if it could not be opened or is not a valid archive</returns>
+	static bool Mount(const std::string& archivePath);
+	/// <summary>
+	/// Unmounts the current archive, invalidating any views into it
+	/// </summary>
+	static void Unmount();
+	/// <summary>
+	/// Returns true if an archive is currently mounted
+	/// </summary>
+	static bool IsMounted();
+
+	/// <summary>
+	/// Gets a view of a file's contents in the mounted archive, without copying it. If the file on disk is
+	/// newer than the archive (or has been marked as modified), the packed copy is out of date and is not returned
+	/// </summary>
+	/// <param name="path">The path of the file, as it would be passed to the file system</param>
+	/// <returns>A view of the file's data, or a view with a null data pointer if the file is not in the archive (or is stale)</returns>
+	static std::string_view GetView(const std::string& path);
+	/// <summary>
+	/// Marks a file as having been written on disk, so that GetView stops returning it's packed copy. This
+	/// can be called from any thread, and does nothing if the file is not in the mounted archive
+	/// </summary>
+	/// <param name="path">The path of the file that was written</param>
+	static void MarkModified(const std::string& path);
+	/// <summary>
+	/// Returns true if the file exists in the mounted archive or on disk
+	/// </summary>
+	static bool Exists(const std::string& path);
+
+	/// <summary>
+	/// Packs a list of files into a new archive. If the archive being replaced is mounted, it is unmounted
+	/// while the new one is swapped in and then mounted again, which invalidates any views into it (so like
+	/// Mount, this should only be called from the main thread while no assets are loading)
+	/// </summary>
+	/// <param name="archivePath">The path of the archive to create</param>
+	/// <param name="files">The paths of the files to pack, these should be relative to the working directory</param>
+	/// <returns>True if the archive was written</returns>
+	static bool Pack(const std::string& archivePath, const std::vector<std::string>& files);
+	/// <summary>
+	/// Packs a resource manifest and all of the files that it's resources are loaded from into a new archive.
+	/// Files are found by searching the manifest for strings that are paths to existing files, and shader
+	/// sources are searched for the files they include. OBJ files also pack their converted binary mesh, if
+	/// there is one. The manifest's blob file is not packed, and must be shipped next to the manifest
+	/// </summary>
+	/// <param name="archivePath">The path of the archive to create</param>
+	/// <param name="manifestPath">The path of the manifest file to pack</param>
+	/// <returns>True if the archive was written</returns>
+	static bool PackManifest(const std::string& archivePath, const std::string& manifestPath);
+
+protected:
+	/// <summary>
+	/// Converts a path into the form it is stored in the archive under, so that different spellings
+	/// of the same relative path (slashes, ./ and ../ segments and case) all find the same file
+	/// </summary>
+	static std::string _NormalizePath(const std::string& path);
+};